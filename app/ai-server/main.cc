@@ -1 +1,724 @@
-auto main() -> int {}
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/math/constants/constants.hpp>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#ifdef AI_SERVER_HAS_NNABLA_EXT_CUDA
+#include <nbla/cuda/cudnn/init.hpp>
+#include <nbla/cuda/init.hpp>
+#endif
+
+#include "ai_server/controller/state_feedback.h"
+#include "ai_server/driver.h"
+#include "ai_server/filter/state_observer/ball.h"
+#include "ai_server/filter/va_calculator.h"
+#include "ai_server/game/captain/first.h"
+#include "ai_server/game/context.h"
+#include "ai_server/game/nnabla.h"
+#include "ai_server/game/planning_stage.h"
+#include "ai_server/logger/logger.h"
+#include "ai_server/logger/sink/ostream.h"
+#include "ai_server/model/team_color.h"
+#include "ai_server/model/updater/refbox.h"
+#include "ai_server/model/updater/world.h"
+#include "ai_server/radio/connection/serial.h"
+#include "ai_server/radio/connection/udp.h"
+#include "ai_server/radio/grsim.h"
+#include "ai_server/radio/humanoid.h"
+#include "ai_server/receiver/refbox.h"
+#include "ai_server/receiver/vision.h"
+#include "ai_server/trace/latency.h"
+#include "ai_server/util/math/affine.h"
+#include "ai_server/util/thread.h"
+
+using namespace std::chrono_literals;
+
+namespace controller = ai_server::controller;
+namespace filter     = ai_server::filter;
+namespace game       = ai_server::game;
+namespace logger     = ai_server::logger;
+namespace model      = ai_server::model;
+namespace radio      = ai_server::radio;
+namespace receiver   = ai_server::receiver;
+namespace util       = ai_server::util;
+
+// 60fpsの時にn framesにかかる時間を表現する型
+using fps60_type =
+    std::chrono::duration<std::chrono::steady_clock::time_point::rep, std::ratio<1, 60>>;
+
+// 基本設定
+// --------------------------------
+
+// WorldModelの設定
+static constexpr auto use_va_filter     = true; // ロボットの速度/加速度を計算する
+static constexpr auto use_ball_observer = true; // ボールの状態オブザーバを有効にする
+
+// Visionの設定
+static constexpr char vision_address[] = "224.5.23.2";
+static constexpr short vision_port     = 10020;
+
+// Refboxの設定
+static constexpr char refbox_address[] = "224.5.23.1";
+static constexpr short refbox_port     = 10003;
+
+// Radioの設定
+static constexpr char robot_address[]     = "224.5.23.2";
+static constexpr short robot_port         = 10004;
+static constexpr char xbee_path[]         = "/dev/ttyUSB0";
+static constexpr char grsim_address[]     = "127.0.0.1";
+static constexpr short grsim_command_port = 20011;
+
+// 制御周期の設定
+static constexpr auto cycle =
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(fps60_type{1});
+// Vision のフレームが届かないときに戦略部を動かす周期
+static constexpr auto frame_timeout = 2 * cycle;
+// フレームが揃ってから戦略部が命令を出し終えるまでの時間の上限 (超えたら警告する)
+static constexpr auto game_stage_deadline = 8ms;
+// 1周期の経路探索に使える時間 (action の実行と送信の時間を残し, 時間内で探索する planner は
+// それまで経路を改善し続ける)
+static constexpr auto planning_budget = game_stage_deadline / 2;
+// Vision を受信してから, 状態オブザーバなどの値が収束するまで戦略部の開始を待つ時間
+static constexpr auto startup_delay = 5s;
+// 終了時にロボットを停止させる命令を送ってから, Driver を止めるまで待つ時間
+// (この間も Driver は一定周期で停止命令を送り続ける)
+static constexpr auto stop_command_delay = 5 * cycle;
+
+// stopgame時の速度制限
+static constexpr double velocity_limit_at_stopgame = 1400.0;
+
+// 撮影から送信までの時間の統計を書き出すファイルと, その間隔
+static constexpr char latency_file[]       = "latency.csv";
+static constexpr auto latency_write_period = 10s;
+
+// Driver が送信した命令を書き出すファイルと, その間隔
+static constexpr char telemetry_file[]       = "telemetry.csv";
+static constexpr auto telemetry_write_period = 1s;
+
+// 設定ファイルの名前 (設定ディレクトリからの相対パス)
+static constexpr char options_file[] = "ai-server.conf";
+
+// nnabla の設定
+std::vector<std::string> nnabla_backend() {
+#ifdef AI_SERVER_HAS_NNABLA_EXT_CUDA
+  return {"cudnn", "cuda", "cpu"};
+#else
+  return {"cpu"};
+#endif
+}
+
+std::string nnabla_device_id() {
+  return "0";
+}
+
+// .nnp ファイルの設定
+auto nnp_files(const std::filesystem::path& config_dir)
+    -> std::unordered_map<std::string, game::nnabla::nnp_file_type> {
+  const auto nnp_dir = config_dir / "nnp";
+  return {
+      // { key, { path, 常に CPU で計算するか } }
+      {"probability", {nnp_dir / "game/detail/mcts/probability.nnp", true}},
+  };
+}
+
+// 設定ファイル
+// --------------------------------
+
+// 1つのスレッドの設定
+struct thread_options {
+  // 実行を許す CPU の番号 (空のときは制限しない)
+  std::vector<int> cpus;
+  // SCHED_FIFO の優先度 (0 のときは通常のスケジューリング)
+  int priority = 0;
+};
+
+// 起動時に読み込む設定
+//
+// 設定ファイルは1行に1つ "key = value" の形式で書く ('#' 以降はコメント).
+//
+//   team_color       = yellow        # yellow または blue
+//   attack_direction = right         # right または left
+//   active_robots    = 0, 1, 2, 3    # 使うロボットの ID
+//   radio            = grsim         # grsim, udp または serial
+//   planner_threads  = 2             # 経路探索の worker スレッドの数
+//   receiver.cpus    = 1             # Vision/Refbox の受信スレッドを動かす CPU
+//   receiver.priority = 80           # 受信スレッドの SCHED_FIFO の優先度
+//   game.cpus        = 2, 3          # 戦略部のスレッド (経路探索の worker も含む)
+//   game.priority    = 70
+//   driver.cpus      = 1             # Controller と Radio のスレッド
+//   driver.priority  = 90
+struct options {
+  model::team_color team_color = model::team_color::yellow;
+  bool attack_left             = false;
+  std::vector<unsigned int> active_robots{0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u};
+  std::string radio           = "grsim";
+  std::size_t planner_threads = 0;
+
+  thread_options receiver;
+  thread_options game;
+  thread_options driver;
+};
+
+// 前後の空白を取り除く
+std::string trim(const std::string& s) {
+  const auto first = s.find_first_not_of(" \t\r");
+  if (first == std::string::npos) return {};
+  const auto last = s.find_last_not_of(" \t\r");
+  return s.substr(first, last - first + 1);
+}
+
+// "1, 2, 3" のような整数のリストを読む
+template <class T>
+std::vector<T> parse_list(const std::string& value) {
+  std::vector<T> result{};
+  std::istringstream is{value};
+  for (std::string item; std::getline(is, item, ',');) {
+    std::size_t pos{};
+    const auto v = std::stol(trim(item), &pos);
+    if (pos != trim(item).size()) throw std::invalid_argument{item};
+    result.push_back(static_cast<T>(v));
+  }
+  return result;
+}
+
+// path から設定を読み込む (ファイルがないときは全て既定値)
+options load_options(const std::filesystem::path& path) {
+  options opts{};
+
+  std::ifstream ifs{path};
+  if (!ifs) return opts;
+
+  const auto thread_of = [&opts](const std::string& name) -> thread_options& {
+    if (name == "receiver") return opts.receiver;
+    if (name == "game") return opts.game;
+    if (name == "driver") return opts.driver;
+    throw std::invalid_argument{"unknown thread " + name};
+  };
+
+  std::size_t line_number = 0;
+  for (std::string line; std::getline(ifs, line);) {
+    ++line_number;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) continue;
+
+    try {
+      const auto eq = line.find('=');
+      if (eq == std::string::npos) throw std::invalid_argument{"'=' is missing"};
+      const auto key   = trim(line.substr(0, eq));
+      const auto value = trim(line.substr(eq + 1));
+
+      if (key == "team_color") {
+        if (value != "yellow" && value != "blue") throw std::invalid_argument{value};
+        opts.team_color =
+            value == "yellow" ? model::team_color::yellow : model::team_color::blue;
+      } else if (key == "attack_direction") {
+        if (value != "right" && value != "left") throw std::invalid_argument{value};
+        opts.attack_left = value == "left";
+      } else if (key == "active_robots") {
+        opts.active_robots = parse_list<unsigned int>(value);
+      } else if (key == "radio") {
+        if (value != "grsim" && value != "udp" && value != "serial") {
+          throw std::invalid_argument{value};
+        }
+        opts.radio = value;
+      } else if (key == "planner_threads") {
+        opts.planner_threads = std::stoul(value);
+      } else if (const auto dot = key.find('.'); dot != std::string::npos) {
+        auto& t          = thread_of(key.substr(0, dot));
+        const auto field = key.substr(dot + 1);
+        if (field == "cpus") {
+          t.cpus = parse_list<int>(value);
+        } else if (field == "priority") {
+          t.priority = std::stoi(value);
+        } else {
+          throw std::invalid_argument{"unknown key " + key};
+        }
+      } else {
+        throw std::invalid_argument{"unknown key " + key};
+      }
+    } catch (const std::exception& e) {
+      throw std::runtime_error{
+          fmt::format("{}:{}: invalid option ({})", path.c_str(), line_number, e.what())};
+    }
+  }
+
+  return opts;
+}
+
+// スレッドに名前, 実行する CPU, 優先度を設定する
+// (設定できなかったときは警告を出して続ける)
+void configure_thread(std::thread& thread, const char* name, const thread_options& opts,
+                      const logger::logger& l) {
+  util::set_thread_name(thread, name);
+  if (!util::set_thread_affinity(thread, opts.cpus)) {
+    l.warn(fmt::format("{}: failed to set cpu affinity {}", name, opts.cpus));
+  }
+  if (opts.priority > 0 && !util::set_thread_priority(thread, opts.priority)) {
+    l.warn(fmt::format("{}: failed to set SCHED_FIFO priority {} (CAP_SYS_NICE is required)",
+                       name, opts.priority));
+  }
+  l.info(fmt::format("{}: cpus = {}, priority = {}", name, opts.cpus, opts.priority));
+}
+
+// スコープを抜けるときに io_context と thread を stop(), join() する helper
+class stop_and_join_at_exit {
+  boost::asio::io_context& ctx_;
+  std::thread thread_;
+
+public:
+  stop_and_join_at_exit(const stop_and_join_at_exit&) = delete;
+  stop_and_join_at_exit(stop_and_join_at_exit&&)      = delete;
+
+  stop_and_join_at_exit(boost::asio::io_context& ctx, std::thread thread)
+      : ctx_{ctx}, thread_{std::move(thread)} {}
+
+  ~stop_and_join_at_exit() {
+    ctx_.stop();
+    thread_.join();
+  }
+};
+
+// Gameを行うクラス
+// --------------------------------
+class game_runner {
+public:
+  game_runner(const std::filesystem::path& config_dir, const options& opts,
+              model::updater::world& world, model::updater::refbox& refbox,
+              ai_server::driver& driver, std::shared_ptr<radio::base::command> radio)
+      : running_{false},
+        config_dir_{config_dir},
+        opts_{opts},
+        updater_world_{world},
+        updater_refbox_{refbox},
+        driver_{driver},
+        l_{"game_runner"} {
+    auto lock = driver_.lock();
+    driver_.set_team_color(opts_.team_color);
+
+    for (auto id : opts_.active_robots) {
+      constexpr auto cycle_count = std::chrono::duration<double>(cycle).count();
+      auto controller            = std::make_unique<controller::state_feedback>(cycle_count);
+      driver_.register_robot(id, std::move(controller), radio);
+    }
+
+    on_frame_completed_connection_ = updater_world_.on_frame_completed([this](auto&&) {
+      // frame_count() は発火前に更新済みなので, ロックを取ってから通知すれば取りこぼさない
+      {
+        std::lock_guard lock{frame_mutex_};
+      }
+      frame_cv_.notify_all();
+    });
+  }
+
+  ~game_runner() {
+    on_frame_completed_connection_.disconnect();
+    stop();
+  }
+
+  void start() {
+    // スレッドの設定が終わるまで main_loop() は mutex_ を待つ
+    // (経路探索の worker スレッドは game_thread から CPU と優先度を引き継ぐ)
+    std::unique_lock lock{mutex_};
+    if (!game_thread_.joinable()) {
+      running_     = true;
+      game_thread_ = std::thread([this] { main_loop(); });
+      configure_thread(game_thread_, "game_thread", opts_.game, l_);
+    }
+  }
+
+  void stop() {
+    running_ = false;
+    {
+      std::lock_guard lock{frame_mutex_};
+    }
+    frame_cv_.notify_all();
+    if (game_thread_.joinable()) game_thread_.join();
+  }
+
+private:
+  void main_loop() {
+    {
+      std::unique_lock lock{mutex_};
+    }
+    l_.info("game started!");
+
+    game::context ctx{};
+    ctx.set_team_color(opts_.team_color);
+    ctx.nnabla = std::make_unique<game::nnabla>(nnabla_backend(), nnabla_device_id(),
+                                                nnp_files(config_dir_));
+
+    game::planning_stage stage{opts_.planner_threads};
+    stage.set_time_budget(planning_budget);
+    const std::set<unsigned int> ids(opts_.active_robots.cbegin(), opts_.active_robots.cend());
+
+    model::refbox refbox{};
+    std::unique_ptr<game::captain::base> captain{};
+
+    std::chrono::steady_clock::time_point prev_time{};
+    std::chrono::steady_clock::time_point latency_written_time{};
+    std::uint64_t handled_frames = 0;
+    std::uint64_t traced_frame   = 0;
+
+    while (running_) {
+      try {
+        {
+          // Vision のフレームが揃うまで待つ (揃わなくても frame_timeout 毎には処理する)
+          // 処理中に揃ったフレームは次の1回にまとめ, 常に最新の world を使う
+          std::unique_lock frame_lock{frame_mutex_};
+          frame_cv_.wait_until(frame_lock, prev_time + frame_timeout, [&] {
+            return !running_ || updater_world_.frame_count() != handled_frames;
+          });
+          if (!running_) break;
+          handled_frames = updater_world_.frame_count();
+        }
+
+        // 同じフレームを2回記録しないように, 新しいフレームのときだけ時刻を受け渡す
+        auto timestamps = updater_world_.last_frame();
+        if (timestamps.frame == traced_frame) timestamps.frame = 0;
+
+        const auto current_time = std::chrono::steady_clock::now();
+        timestamps.game_started = std::chrono::system_clock::now();
+
+        const auto prev_cmd = refbox.command();
+
+        // world と共にロボットとボールの位置に対する問い合わせを作り直す
+        ctx.set_world(*updater_world_.snapshot());
+        refbox = updater_refbox_.value();
+
+        const auto current_cmd = refbox.command();
+        if (current_cmd != prev_cmd || !captain) {
+          if (current_cmd == model::refbox::game_command::stop) {
+            driver_.set_velocity_limit(velocity_limit_at_stopgame);
+          } else {
+            driver_.set_velocity_limit(std::numeric_limits<double>::max());
+          }
+        }
+
+        if (!captain) {
+          captain = std::make_unique<game::captain::first>(ctx, refbox, ids);
+          l_.info("captain resetted");
+        }
+
+        // 経路探索は planning_stage でまとめて並列に行う
+        auto formation = captain->execute();
+        for (const auto& [id, command] : stage.execute(formation->execute())) {
+          driver_.update_command(id, command);
+        }
+
+        // Driver の周期を待たずに, 直ちに Controller を通して送信する
+        timestamps.game_finished = std::chrono::system_clock::now();
+        if (timestamps.frame != 0) traced_frame = timestamps.frame;
+        driver_.trigger(timestamps);
+
+        const auto elapsed = std::chrono::steady_clock::now() - current_time;
+        if (elapsed > game_stage_deadline) {
+          l_.warn(fmt::format("game stage took {} (deadline {})",
+                              std::chrono::duration_cast<std::chrono::microseconds>(elapsed),
+                              game_stage_deadline));
+        }
+
+        if (current_time - latency_written_time > latency_write_period) {
+          write_latency();
+          latency_written_time = current_time;
+        }
+
+        prev_time = current_time;
+      } catch (const std::exception& e) {
+        l_.error(fmt::format("exception at game_thread\n\t{}", e.what()));
+      } catch (...) {
+        l_.error("unknown exception at game_thread");
+      }
+    }
+
+    // ロボットを全て停止させる
+    // 停止命令は直ちに送信し, Driver が止まる前に送り終えるよう少し待つ
+    // (stop() がこのスレッドを join() してから driver_io が止められる)
+    for (const auto& id : opts_.active_robots) {
+      driver_.update_command(id, {});
+    }
+    driver_.trigger();
+    std::this_thread::sleep_for(stop_command_delay);
+
+    write_latency();
+    l_.info("game stopped!");
+  }
+
+  // 撮影から送信までの時間の統計を latency_file に書き出す
+  void write_latency() {
+    std::ofstream ofs{latency_file};
+    if (!ofs) {
+      l_.warn(fmt::format("failed to open {}", latency_file));
+      return;
+    }
+    const auto& latency = ai_server::trace::latency::global();
+    latency.write_csv(ofs);
+
+    const auto total = latency.summarize(ai_server::trace::latency::stage::total);
+    l_.info(fmt::format("latency (capture -> send): p50 {} / p99 {} / max {} ({} frames)",
+                        total.p50, total.p99, total.max, total.count));
+  }
+
+  std::mutex mutex_;
+  std::atomic<bool> running_;
+
+  // Vision のフレームが揃ったことを game_thread に伝える
+  std::mutex frame_mutex_;
+  std::condition_variable frame_cv_;
+
+  const std::filesystem::path& config_dir_;
+  const options& opts_;
+
+  model::updater::world& updater_world_;
+  model::updater::refbox& updater_refbox_;
+  ai_server::driver& driver_;
+
+  std::thread game_thread_;
+
+  boost::signals2::connection on_frame_completed_connection_;
+
+  logger::logger l_;
+};
+
+// Driver が送信した命令を定期的にファイルへ書き出すクラス
+// 制御部のスレッドではなく, io_context を回すスレッドで radio::telemetry から読み出す
+// --------------------------------
+class telemetry_writer {
+public:
+  telemetry_writer(boost::asio::io_context& ctx, const ai_server::driver& driver)
+      : timer_{ctx}, driver_{driver}, ofs_{telemetry_file}, l_{"telemetry_writer"} {
+    if (!ofs_) {
+      l_.warn(fmt::format("failed to open {}", telemetry_file));
+      return;
+    }
+    ofs_ << "time_ns,color,id,motion_id,vx,vy,omega,kick_type,kick_power,dribble\n";
+    wait();
+  }
+
+  ~telemetry_writer() {
+    write();
+  }
+
+private:
+  void wait() {
+    timer_.expires_after(telemetry_write_period);
+    timer_.async_wait([this](const auto& error) {
+      if (error) return;
+      write();
+      wait();
+    });
+  }
+
+  void write() {
+    if (!ofs_) return;
+    const auto& telemetry = driver_.telemetry();
+    for (unsigned int id = 0; id < cursors_.size(); ++id) {
+      const auto skipped = telemetry.drain(id, cursors_[id], [this](const auto& e) {
+        const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            e.time.time_since_epoch());
+        ofs_ << fmt::format("{},{},{},{},{},{},{},{},{},{}\n", time.count(),
+                            static_cast<int>(e.color), e.id, e.motion_id, e.vx, e.vy, e.omega,
+                            static_cast<int>(e.kick_type), e.kick_power, e.dribble);
+      });
+      if (skipped > 0) l_.debug(fmt::format("robot {}: {} commands skipped", id, skipped));
+    }
+    ofs_.flush();
+  }
+
+  boost::asio::steady_timer timer_;
+  const ai_server::driver& driver_;
+  std::ofstream ofs_;
+  std::array<std::uint64_t, radio::telemetry::max_robots> cursors_{};
+
+  logger::logger l_;
+};
+
+auto main(int argc, char** argv) -> int {
+  logger::sink::ostream sink(std::cout, "{elapsed} {level:<5} {zone}: {message}");
+
+  logger::logger l{"main()"};
+
+#ifdef AI_SERVER_HAS_NNABLA_EXT_CUDA
+  nbla::init_cudnn();
+#endif
+  l.info(fmt::format("nnabla: backend = {}, device_id = {}", nnabla_backend(),
+                     nnabla_device_id()));
+
+  try {
+    // 設定ファイルのパスを決める
+    // デフォルトは実行ファイルと同じディレクトリの config (<ai-server>/config への symlink)
+    // argv[1] が指定されていたらそれを使う
+    const auto config_dir =
+        (argc == 2)
+            ? std::filesystem::path{argv[1]}
+            : weakly_canonical(std::filesystem::canonical(argv[0]).parent_path() / "config");
+    l.info(fmt::format("configuration directory: {}", config_dir.c_str()));
+    if (!is_directory(config_dir)) {
+      l.error(fmt::format("'{}' does not exist or is not a directory", config_dir.c_str()));
+      return -1;
+    }
+
+    const auto opts = load_options(config_dir / options_file);
+    l.info(fmt::format("team color: {}, attack direction: {}",
+                       opts.team_color == model::team_color::yellow ? "yellow" : "blue",
+                       opts.attack_left ? "left" : "right"));
+    l.info(fmt::format("active robots: {}", opts.active_robots));
+    l.info(fmt::format("planner threads: {}", opts.planner_threads));
+
+    // WorldModelの設定
+    model::updater::world updater_world{};
+    model::updater::refbox updater_refbox{};
+    {
+      // ロボットの速度と加速度を計算するか
+      if (use_va_filter) {
+        updater_world.robots_blue_updater()
+            .set_default_filter<filter::va_calculator<model::robot>>();
+        updater_world.robots_yellow_updater()
+            .set_default_filter<filter::va_calculator<model::robot>>();
+      }
+      // ボールの状態オブザーバを使うか
+      if (use_ball_observer) {
+        updater_world.ball_updater().set_filter<filter::state_observer::ball>(
+            model::ball{}, std::chrono::system_clock::now());
+      }
+
+      // 攻撃方向が左なら座標系を反転する
+      const auto mat = util::math::make_transformation_matrix(
+          0.0, 0.0, opts.attack_left ? boost::math::double_constants::pi : 0.0);
+      updater_world.set_transformation_matrix(mat);
+      updater_refbox.set_transformation_matrix(mat);
+    }
+
+    boost::asio::io_context receiver_io{1};
+
+    // Vision receiverの設定
+    std::atomic<bool> vision_received{false};
+    receiver::vision vision{receiver_io, "0.0.0.0", vision_address, vision_port};
+    vision.on_receive([&updater_world, &vision_received, &l](auto&& p) {
+      if (!vision_received) {
+        // 最初に受信したときにメッセージを表示する
+        l.info("vision packet received!");
+        vision_received = true;
+      }
+      updater_world.update(std::forward<decltype(p)>(p));
+    });
+    l.info(fmt::format("vision: {}:{}", vision_address, vision_port));
+
+    // Refbox receiverの設定
+    receiver::refbox refbox{receiver_io, "0.0.0.0", refbox_address, refbox_port};
+    refbox.on_receive([&updater_refbox](auto&& p) {
+      updater_refbox.update(std::forward<decltype(p)>(p));
+    });
+    l.info(fmt::format("refbox: {}:{}", refbox_address, refbox_port));
+
+    // receiver_ioに登録されたタスクを別スレッドで開始
+    std::thread receiver_thread{[&receiver_io, &l] {
+      try {
+        receiver_io.run();
+      } catch (std::exception& e) {
+        l.error(fmt::format("exception at receiver_thread: {}", e.what()));
+      }
+    }};
+    configure_thread(receiver_thread, "receiver_thread", opts.receiver, l);
+    stop_and_join_at_exit receiver_io_and_thread{receiver_io, std::move(receiver_thread)};
+
+    boost::asio::io_context driver_io{1};
+
+    // Radioの設定
+    auto radio = [&]() -> std::shared_ptr<radio::base::command> {
+      if (opts.radio == "grsim") {
+        auto con = std::make_unique<radio::connection::udp>(
+            driver_io, boost::asio::ip::udp::endpoint{
+                           boost::asio::ip::make_address(grsim_address), grsim_command_port});
+        l.info(fmt::format("radio: grSim ({}:{})", grsim_address, grsim_command_port));
+        return std::make_shared<radio::grsim<radio::connection::udp>>(std::move(con));
+      } else if (opts.radio == "udp") {
+        auto con = std::make_unique<radio::connection::udp>(
+            driver_io, boost::asio::ip::udp::endpoint{
+                           boost::asio::ip::make_address(robot_address), robot_port});
+        l.info(fmt::format("radio: kiks ({}:{})", robot_address, robot_port));
+        return std::make_shared<radio::humanoid<radio::connection::udp>>(std::move(con));
+      } else {
+        auto con = std::make_unique<radio::connection::serial>(
+            driver_io, xbee_path, radio::connection::serial::baud_rate(57600));
+        l.info(fmt::format("radio: kiks ({})", xbee_path));
+        return std::make_shared<radio::humanoid<radio::connection::serial>>(std::move(con));
+      }
+    }();
+
+    // driver による命令の送信を別スレッドで開始
+    ai_server::driver driver{driver_io, cycle, updater_world, opts.team_color};
+    std::thread driver_thread{[&driver_io, &l] {
+      try {
+        driver_io.run();
+      } catch (std::exception& e) {
+        l.error(fmt::format("exception at driver_thread: {}", e.what()));
+      }
+    }};
+    configure_thread(driver_thread, "driver_thread", opts.driver, l);
+    stop_and_join_at_exit driver_io_and_thread{driver_io, std::move(driver_thread)};
+
+    game_runner runner{config_dir, opts, updater_world, updater_refbox, driver, radio};
+
+    // SIGINT, SIGTERM を受け取るまでメインスレッドで待つ
+    boost::asio::io_context main_io{1};
+    boost::asio::signal_set signals{main_io, SIGINT, SIGTERM};
+    telemetry_writer telemetry{main_io, driver};
+    signals.async_wait([&main_io, &l](const auto& error, int signal) {
+      if (!error) l.info(fmt::format("signal {} received", signal));
+      main_io.stop();
+    });
+
+    // Visionから値が取れたら, 状態オブザーバなどの値が収束するまで待ってから開始する
+    boost::asio::steady_timer timer{main_io};
+    std::function<void(const boost::system::error_code&)> wait_for_vision =
+        [&](const auto& error) {
+          if (error) return;
+          if (!vision_received) {
+            timer.expires_after(500ms);
+            timer.async_wait(wait_for_vision);
+            return;
+          }
+          timer.expires_after(startup_delay);
+          timer.async_wait([&runner, &l](const auto& ec) {
+            if (ec) return;
+            l.info("ready!");
+            runner.start();
+          });
+        };
+    wait_for_vision({});
+
+    main_io.run();
+    runner.stop();
+  } catch (std::exception& e) {
+    l.error(e.what());
+    return -1;
+  } catch (...) {
+    l.error("unknown error occurred");
+    return -1;
+  }
+}
@@ -3,7 +3,9 @@
 #include <bitset>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -13,6 +15,7 @@
 #include <sstream>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/math/constants/constants.hpp>
@@ -38,6 +41,7 @@
 #include "ai_server/game/context.h"
 #include "ai_server/game/captain/first.h"
 #include "ai_server/game/nnabla.h"
+#include "ai_server/game/planning_stage.h"
 #include "ai_server/logger/formatter.h"
 #include "ai_server/logger/logger.h"
 #include "ai_server/logger/sink/function.h"
@@ -54,6 +58,7 @@
 #include "ai_server/receiver/refbox.h"
 #include "ai_server/receiver/robot.h"
 #include "ai_server/receiver/vision.h"
+#include "ai_server/trace/latency.h"
 #include "ai_server/util/math/affine.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/thread.h"
@@ -116,6 +121,23 @@ static constexpr short grsim_command_port = 20011;
 static constexpr auto cycle =
     std::chrono::duration_cast<std::chrono::steady_clock::duration>(fps60_type{1});
 
+// Vision のフレームが揃う度に, 戦略部から Radio での送信までを続けて行う
+// (false のときは戦略部と Driver がそれぞれ cycle 毎に動く)
+static constexpr bool vision_synchronous = true;
+// Vision のフレームが届かないときに戦略部を動かす周期
+static constexpr auto frame_timeout = 2 * cycle;
+// フレームが揃ってから戦略部が命令を出し終えるまでの時間の上限 (超えたら警告する)
+static constexpr auto game_stage_deadline = 8ms;
+// 1周期の経路探索に使える時間 (action の実行と送信の時間を残し, 時間内で探索する planner は
+// それまで経路を改善し続ける)
+static constexpr auto planning_budget = game_stage_deadline / 2;
+// 経路探索を行う worker スレッドの数 (game_thread も経路探索に加わる)
+static const std::size_t planner_threads =
+    std::max(std::thread::hardware_concurrency(), 2u) - 1;
+// 撮影から送信までの時間の統計を書き出すファイルと, その間隔
+static constexpr char latency_file[]       = "latency.csv";
+static constexpr auto latency_write_period = 10s;
+
 // stopgame時の速度制限
 static constexpr double velocity_limit_at_stopgame = 1400.0;
 
@@ -193,11 +215,22 @@ public:
         handle_command_updated(std::forward<decltype(args)>(args)...);
       });
     }
+
+    if constexpr (vision_synchronous) {
+      on_frame_completed_connection_ = updater_world_.on_frame_completed([this](auto&&) {
+        // frame_count() は発火前に更新済みなので, ロックを取ってから通知すれば取りこぼさない
+        {
+          std::lock_guard lock{frame_mutex_};
+        }
+        frame_cv_.notify_all();
+      });
+    }
   }
 
   ~game_runner() {
+    on_frame_completed_connection_.disconnect();
     running_ = false;
-    cv_.notify_all();
+    notify_all();
     if (game_thread_.joinable()) game_thread_.join();
   }
 
@@ -212,7 +245,7 @@ public:
 
   void stop() {
     running_ = false;
-    cv_.notify_all();
+    notify_all();
     game_thread_.join();
   }
 
@@ -281,27 +314,54 @@ private:
     ctx.nnabla = std::make_unique<game::nnabla>(nnabla_backend(), nnabla_device_id(),
                                                 nnp_files(config_dir_));
 
+    // 経路探索は planning_stage でまとめて並列に行う
+    game::planning_stage stage{planner_threads};
+    stage.set_time_budget(planning_budget);
+
     model::refbox refbox{};
     std::unique_ptr<game::captain::base> captain{};
-    std::unique_ptr<game::action::base> action{};    //m ***********************
+    std::vector<std::shared_ptr<game::action::base>> actions{};    //m ***********************
 
     std::chrono::steady_clock::time_point prev_time{};
 
+    // 処理したフレームの数
+    std::uint64_t handled_frames = 0;
+    // 送信までの時間を記録したフレームの番号
+    std::uint64_t traced_frame = 0;
+    std::chrono::steady_clock::time_point latency_written_time{};
+
     for (;;) {
       try {
+        if constexpr (vision_synchronous) {
+          // Vision のフレームが揃うまで待つ (揃わなくても frame_timeout 毎には処理する)
+          // 処理中に揃ったフレームは次の1回にまとめ, 常に最新の world を使う
+          std::unique_lock frame_lock{frame_mutex_};
+          frame_cv_.wait_until(frame_lock, prev_time + frame_timeout, [&] {
+            return !running_ || updater_world_.frame_count() != handled_frames;
+          });
+          handled_frames = updater_world_.frame_count();
+        }
+
+        // 同じフレームを2回記録しないように, 新しいフレームのときだけ時刻を受け渡す
+        auto timestamps = updater_world_.last_frame();
+        if (timestamps.frame == traced_frame) timestamps.frame = 0;
+
         std::unique_lock lock{mutex_};
-        // 前回の処理開始から cycle 待つ
-        if (cv_.wait_until(lock, prev_time + cycle, [this] { return !running_; })) {
+        // 前回の処理開始から cycle 待つ (フレームに合わせるときは既に待っている)
+        if (cv_.wait_until(lock, vision_synchronous ? prev_time : prev_time + cycle,
+                           [this] { return !running_; })) {
           break; // その間に stop() されたらループを抜ける
         }
 
         const auto current_time = std::chrono::steady_clock::now();
+        timestamps.game_started = std::chrono::system_clock::now();
 
         const auto prev_cmd = refbox.command();
 
-        ctx.team_color = team_color_;
-        ctx.world      = updater_world_.value();
-        refbox         = updater_refbox_.value();
+        // world と共にロボットとボールの位置に対する問い合わせを作り直す
+        ctx.set_team_color(team_color_);
+        ctx.set_world(*updater_world_.snapshot());
+        refbox = updater_refbox_.value();
 
         const auto current_cmd = refbox.command();
 
@@ -322,29 +382,47 @@ private:
         }
 
         auto formation = captain->execute();
-        auto actions   = formation->execute();
-        for (auto action : actions) {
-          auto command = action->execute();
-          driver_.update_command(action->id(), command);
+        for (const auto& [id, command] : stage.execute(formation->execute())) {
+          driver_.update_command(id, command);
         }
 */
 
 // action only  wm 20220621
-        if (!action || need_reset_) {    // || OR
+        if (actions.empty() || need_reset_) {    // || OR
        
-         //action      = std::make_unique<game::action::goal_keep>(ctx, 0);
-         //action      = std::make_unique<game::action::get_ball>(ctx, 1);
-         action      = std::make_unique<game::action::clear>(ctx, 0);
+         //actions = {std::make_shared<game::action::goal_keep>(ctx, 0)};
+         //actions = {std::make_shared<game::action::get_ball>(ctx, 1)};
+         actions = {std::make_shared<game::action::clear>(ctx, 0)};
 
           need_reset_ = false;
           l_.info("action resetted");
         }
 
-        auto command = action->execute();
-        driver_.update_command(action->id(), command);
+        for (const auto& [id, command] : stage.execute(actions)) {
+          driver_.update_command(id, command);
+        }
 
         // action only
 
+        if constexpr (vision_synchronous) {
+          // Driver の周期を待たずに, 直ちに Controller を通して送信する
+          timestamps.game_finished = std::chrono::system_clock::now();
+          if (timestamps.frame != 0) traced_frame = timestamps.frame;
+          driver_.trigger(timestamps);
+
+          const auto elapsed = std::chrono::steady_clock::now() - current_time;
+          if (elapsed > game_stage_deadline) {
+            l_.warn(fmt::format("game stage took {} (deadline {})",
+                                std::chrono::duration_cast<std::chrono::microseconds>(elapsed),
+                                game_stage_deadline));
+          }
+        }
+
+        if (current_time - latency_written_time > latency_write_period) {
+          write_latency();
+          latency_written_time = current_time;
+        }
+
         prev_time = current_time;
       } catch (const std::exception& e) {
         l_.error(fmt::format("exception at game_thread\n\t{}", e.what()));
@@ -361,9 +439,34 @@ private:
       }
     }
 
+    write_latency();
     l_.info("game stopped!");
   }
 
+  // 撮影から送信までの時間の統計を latency_file に書き出す
+  void write_latency() {
+    std::ofstream ofs{latency_file};
+    if (!ofs) {
+      l_.warn(fmt::format("failed to open {}", latency_file));
+      return;
+    }
+    const auto& latency = ai_server::trace::latency::global();
+    latency.write_csv(ofs);
+
+    const auto total = latency.summarize(ai_server::trace::latency::stage::total);
+    l_.info(fmt::format("latency (capture -> send): p50 {} / p99 {} / max {} ({} frames)",
+                        total.p50, total.p99, total.max, total.count));
+  }
+
+  // game_thread を待たせている全ての条件変数に通知する
+  void notify_all() {
+    cv_.notify_all();
+    {
+      std::lock_guard lock{frame_mutex_};
+    }
+    frame_cv_.notify_all();
+  }
+
   // id の state_observer を初期化する
   void set_state_observer(unsigned int id) {
     auto f = [this, id](auto& updater) {
@@ -414,6 +517,11 @@ private:
   std::condition_variable cv_;
   std::atomic<bool> running_;
 
+  // Vision のフレームが揃ったことを game_thread に伝える
+  // (Vision の受信スレッドが mutex_ を待たないよう, mutex_ とは分けておく)
+  std::mutex frame_mutex_;
+  std::condition_variable frame_cv_;
+
   // captain のリセットが必要か
   bool need_reset_;
 
@@ -431,6 +539,7 @@ private:
   std::thread game_thread_;
 
   boost::signals2::connection on_command_updated_connection_;
+  boost::signals2::connection on_frame_completed_connection_;
   std::array<std::weak_ptr<filter::state_observer::robot>, max_robots> state_observers_;
 
   logger::logger l_;
@@ -551,7 +660,8 @@ private:
     const auto allocation = get_allocation();
     const auto width      = allocation.get_width();
     const auto height     = allocation.get_height();
-    const auto world      = updater_world_.value();
+    const auto snapshot   = updater_world_.snapshot();
+    const auto& world     = *snapshot;
     const auto wf         = world.field();
 
     constexpr auto line_width   = 10.0;
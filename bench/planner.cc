@@ -0,0 +1,121 @@
+// 経路探索のベンチマーク
+//
+// 試合中によく現れる障害物の配置 (scenarios.h) 毎に各 planner を繰り返し実行し，
+// 1回あたりの処理時間の分布, メモリ確保の回数, 経路の質を表示する
+//
+// 使い方: bench_planner [繰り返し回数 (既定値 5)] [1つの状況あたりの問い合わせ数 (既定値 200)]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/geometry/geometries/segment.hpp>
+#include <fmt/format.h>
+
+#include "ai_server/planner/base.h"
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/human_like.h"
+#include "ai_server/planner/rrt_star.h"
+#include "ai_server/planner/velocity_obstacle.h"
+#include "scenarios.h"
+#include "test_helpers/allocation_counter.h"
+
+namespace {
+
+using namespace ai_server;
+
+// 比較する planner
+struct planner_entry {
+  std::string name;
+  std::function<std::unique_ptr<planner::base>()> make;
+};
+
+std::vector<planner_entry> make_planners() {
+  return {
+      {"human_like", [] { return std::make_unique<planner::human_like>(); }},
+      {"rrt_star",
+       [] {
+         auto p = std::make_unique<planner::rrt_star>();
+         p->set_node_count(100);
+         p->set_seed(1);
+         return p;
+       }},
+      {"velocity_obstacle", [] { return std::make_unique<planner::velocity_obstacle>(); }},
+  };
+}
+
+// 昇順に並べた値の p 分位点
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  const auto i = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(i, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  using clock = std::chrono::steady_clock;
+  using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
+
+  const int repeat      = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 5;
+  const int query_count = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 200;
+
+  const auto field     = bench::make_field();
+  const auto scenarios = bench::make_scenarios(field, query_count);
+  const auto planners  = make_planners();
+
+  fmt::print("{:<18} {:<18} {:>9} {:>9} {:>9} {:>9} {:>10} {:>9} {:>9}\n", "scenario",
+             "planner", "p50[us]", "p90[us]", "p99[us]", "max[us]", "alloc/call",
+             "length", "clear[%]");
+
+  for (const auto& s : scenarios) {
+    // 経路の質は全ての障害物を含むRTreeで調べる
+    const auto tree = s.obstacles.to_tree();
+
+    for (const auto& entry : planners) {
+      auto p = entry.make();
+      p->set_area(field, 200.0);
+      const auto plan = p->planner();
+
+      std::vector<double> latencies;
+      latencies.reserve(static_cast<std::size_t>(repeat) * s.queries.size());
+      std::uint64_t allocations = 0;
+      double length_ratio       = 0.0;
+      int clear                 = 0;
+
+      // 最初の1回は確保した領域の再利用などの影響を受けるため，計測しない
+      plan(s.queries.front().first, s.queries.front().second, s.obstacles);
+
+      for (int r = 0; r < repeat; ++r) {
+        for (const auto& [start, goal] : s.queries) {
+          const auto a0 = allocation_count.load(std::memory_order_relaxed);
+          const auto t0 = clock::now();
+          const auto [target, length] = plan(start, goal, s.obstacles);
+          const auto t1 = clock::now();
+          allocations += allocation_count.load(std::memory_order_relaxed) - a0;
+
+          latencies.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+          if (r == 0) {
+            // 直線距離に対する経路の長さの比 (1 に近いほど短い経路)
+            const double direct = (goal - start).norm();
+            length_ratio += direct > 0.0 ? length / direct : 1.0;
+            // 次の目標位置まで障害物に当たらずに進めるか
+            if (!planner::detail::is_collided(segment_type{start, target}, tree)) ++clear;
+          }
+        }
+      }
+
+      std::sort(latencies.begin(), latencies.end());
+      const auto calls = static_cast<double>(latencies.size());
+      const auto n     = static_cast<double>(s.queries.size());
+      fmt::print("{:<18} {:<18} {:>9.1f} {:>9.1f} {:>9.1f} {:>9.1f} {:>10.1f} {:>9.3f} {:>9.1f}\n",
+                 s.name, entry.name, percentile(latencies, 0.5), percentile(latencies, 0.9),
+                 percentile(latencies, 0.99), latencies.back(), allocations / calls,
+                 length_ratio / n, 100.0 * clear / n);
+    }
+  }
+}
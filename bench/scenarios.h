@@ -0,0 +1,133 @@
+#ifndef AI_SERVER_BENCH_SCENARIOS_H
+#define AI_SERVER_BENCH_SCENARIOS_H
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+
+#include "ai_server/model/field.h"
+#include "ai_server/model/obstacle/field.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/model/obstacle/segment.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace ai_server::bench {
+
+/// 経路探索を行う状況
+struct scenario {
+  std::string name;
+  // 障害物
+  planner::obstacle_list obstacles;
+  // 開始位置と目標位置の組
+  std::vector<std::pair<Eigen::Vector2d, Eigen::Vector2d>> queries;
+};
+
+/// ベンチマークで使うフィールド (Division A)
+inline model::field make_field() {
+  model::field f{};
+  f.set_length(12000);
+  f.set_width(9000);
+  f.set_center_radius(500);
+  f.set_goal_width(1200);
+  f.set_penalty_length(1800);
+  f.set_penalty_width(3600);
+  return f;
+}
+
+// ロボットを障害物としたときの半径
+constexpr double robot_margin = 250.0;
+// ペナルティエリアの margin
+constexpr double penalty_margin = 150.0;
+
+/// 試合中によく現れる障害物の配置を作る
+/// 乱数のシードを固定しているため，何度作っても同じものになる
+/// @param field       フィールド
+/// @param query_count 1つの状況あたりの開始位置と目標位置の組の数
+inline std::vector<scenario> make_scenarios(const model::field& field, int query_count) {
+  std::vector<scenario> result;
+  std::mt19937 mt{20190801};
+
+  auto uniform = [&mt](double min, double max) {
+    return std::uniform_real_distribution<double>{min, max}(mt);
+  };
+
+  // 全ての状況で共通する障害物
+  planner::obstacle_list common{};
+  common.set_static(model::obstacle::penalty_areas(field, penalty_margin));
+
+  // 障害物の無いフィールドを横切る
+  {
+    scenario s{"open_field", common, {}};
+    for (int i = 0; i < query_count; ++i) {
+      s.queries.emplace_back(Eigen::Vector2d{uniform(-4000.0, 0.0), uniform(-4000.0, 4000.0)},
+                             Eigen::Vector2d{uniform(0.0, 4000.0), uniform(-4000.0, 4000.0)});
+    }
+    result.push_back(std::move(s));
+  }
+
+  // 相手のペナルティエリアの前に並んだ壁の向こうへ回り込む
+  {
+    scenario s{"defence_wall", common, {}};
+    for (int i = 0; i < 6; ++i) {
+      s.obstacles.add(model::obstacle::point{
+          {field.front_penalty_x() - 400.0, -1000.0 + 400.0 * i}, robot_margin});
+    }
+    for (int i = 0; i < 2; ++i) {
+      s.obstacles.add(model::obstacle::point{
+          {field.front_penalty_x() - 1500.0, -600.0 + 1200.0 * i}, robot_margin});
+    }
+    s.obstacles.freeze();
+    for (int i = 0; i < query_count; ++i) {
+      s.queries.emplace_back(
+          Eigen::Vector2d{uniform(-1000.0, 2000.0), uniform(-2500.0, 2500.0)},
+          Eigen::Vector2d{field.front_penalty_x() - 250.0, uniform(-1500.0, 1500.0)});
+    }
+    result.push_back(std::move(s));
+  }
+
+  // 自分のペナルティエリアの中から出る
+  {
+    scenario s{"penalty_escape", common, {}};
+    for (int i = 0; i < 4; ++i) {
+      s.obstacles.add(model::obstacle::point{
+          {field.back_penalty_x() + 400.0, -1200.0 + 800.0 * i}, robot_margin});
+    }
+    s.obstacles.freeze();
+    for (int i = 0; i < query_count; ++i) {
+      s.queries.emplace_back(
+          Eigen::Vector2d{uniform(field.x_min() + 200.0, field.back_penalty_x()),
+                          uniform(field.penalty_y_min(), field.penalty_y_max())},
+          Eigen::Vector2d{uniform(-2000.0, 2000.0), uniform(-3000.0, 3000.0)});
+    }
+    result.push_back(std::move(s));
+  }
+
+  // 敵味方が入り混じった中盤を抜ける (動いているロボットは軌跡を障害物にする)
+  {
+    scenario s{"crowded_midfield", common, {}};
+    for (int i = 0; i < 16; ++i) {
+      const Eigen::Vector2d p{uniform(-2500.0, 2500.0), uniform(-2500.0, 2500.0)};
+      if (i % 4 == 0) {
+        const Eigen::Vector2d v{uniform(-1500.0, 1500.0), uniform(-1500.0, 1500.0)};
+        s.obstacles.add(model::obstacle::segment{{p, p + 0.5 * v}, robot_margin});
+      } else {
+        s.obstacles.add(model::obstacle::point{p, robot_margin});
+      }
+    }
+    s.obstacles.freeze();
+    for (int i = 0; i < query_count; ++i) {
+      const double side = i % 2 == 0 ? 1.0 : -1.0;
+      s.queries.emplace_back(
+          Eigen::Vector2d{-side * uniform(3000.0, 4000.0), uniform(-3000.0, 3000.0)},
+          Eigen::Vector2d{side * uniform(3000.0, 4000.0), uniform(-3000.0, 3000.0)});
+    }
+    result.push_back(std::move(s));
+  }
+
+  return result;
+}
+} // namespace ai_server::bench
+
+#endif // AI_SERVER_BENCH_SCENARIOS_H
@@ -0,0 +1,121 @@
+// radio::connection::udp の送信性能のベンチマーク
+//
+// ループバックへ burst 個ずつメッセージを送り, 全て送信し終えるまでを繰り返したときの
+// 送信レートを, メッセージ毎にコルーチンを生成していた以前の実装と比較して表示する
+//
+// 使い方: bench_udp [繰り返し回数 (既定値 2000)]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#define BOOST_COROUTINES_NO_DEPRECATION_WARNING
+#include <boost/asio.hpp>
+#include <boost/asio/spawn.hpp>
+#include <fmt/format.h>
+
+#include "ai_server/radio/connection/detail/post_and_return_future.h"
+#include "ai_server/radio/connection/udp.h"
+#include "test_helpers/asio.h"
+
+namespace {
+
+namespace radio = ai_server::radio;
+
+// 比較用: メッセージ毎にコルーチンを生成して送信する, 以前の connection::udp と同じ実装
+class spawn_per_message {
+public:
+  spawn_per_message(boost::asio::io_context& io_context,
+                    const boost::asio::ip::udp::endpoint& endpoint)
+      : total_messages_{},
+        total_errors_{},
+        io_context_{io_context},
+        endpoint_{endpoint},
+        socket_{io_context_, endpoint_.protocol()} {}
+
+  template <class Buffer>
+  void send(Buffer buffer) {
+    boost::asio::spawn(io_context_, [this, buffer = std::move(buffer)](auto yield) {
+      boost::system::error_code ec{};
+      socket_.async_send_to(boost::asio::buffer(buffer), endpoint_, yield[ec]);
+      if (ec) {
+        total_errors_++;
+      } else {
+        total_messages_++;
+      }
+    });
+  }
+
+  std::uint64_t total_messages() const {
+    return radio::connection::detail::post_and_return_future(
+               io_context_, [this] { return total_messages_; })
+        .get();
+  }
+
+  std::uint64_t total_errors() const {
+    return radio::connection::detail::post_and_return_future(
+               io_context_, [this] { return total_errors_; })
+        .get();
+  }
+
+private:
+  std::uint64_t total_messages_;
+  std::uint64_t total_errors_;
+  boost::asio::io_context& io_context_;
+  boost::asio::ip::udp::endpoint endpoint_;
+  boost::asio::ip::udp::socket socket_;
+};
+
+// burst 個ずつメッセージを送り, 全て送信し終えるまでを繰り返したときの送信レート [msg/s]
+template <class Connection>
+double sends_per_second(Connection& con, const std::string& message, std::uint64_t bursts,
+                        std::uint64_t burst) {
+  const auto start = std::chrono::steady_clock::now();
+
+  for (std::uint64_t i = 1; i <= bursts; ++i) {
+    for (std::uint64_t j = 0; j < burst; ++j) con.send(message);
+    while (con.total_messages() + con.total_errors() < i * burst) {
+    }
+  }
+
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+  return (bursts * burst) / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::uint64_t bursts = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 2000;
+  constexpr std::uint64_t burst = radio::connection::udp::queue_size;
+
+  // 受信側は読まずに捨てる (送信側の性能だけを測る)
+  // ポートは OS に空いているものを選ばせる
+  boost::asio::io_context rx_ctx{};
+  boost::asio::ip::udp::socket rx{
+      rx_ctx, boost::asio::ip::udp::endpoint{boost::asio::ip::address_v4::loopback(), 0}};
+  const auto endpoint = rx.local_endpoint();
+
+  // grSim に16台分の命令を送るときと同程度の大きさ
+  const std::string message(600, 'x');
+
+  fmt::print("{:<18} {:>12} {:>9}\n", "connection", "msg/s", "errors");
+
+  {
+    boost::asio::io_context ctx{};
+    spawn_per_message tx{ctx, endpoint};
+    auto work = boost::asio::make_work_guard(ctx);
+    run_io_context_in_new_thread th{ctx};
+    const auto rate = sends_per_second(tx, message, bursts, burst);
+    fmt::print("{:<18} {:>12.0f} {:>9}\n", "spawn per message", rate, tx.total_errors());
+  }
+
+  {
+    boost::asio::io_context ctx{};
+    radio::connection::udp tx{ctx, endpoint};
+    run_io_context_in_new_thread th{ctx};
+    const auto rate = sends_per_second(tx, message, bursts, burst);
+    fmt::print("{:<18} {:>12.0f} {:>9}\n", "send queue", rate, tx.total_errors());
+  }
+}
@@ -5,6 +5,7 @@
 #include <variant>
 #include <boost/format.hpp>
 
+#include "ai_server/model/motion/shared.h"
 #include "ai_server/model/motion/stop.h"
 #include "ai_server/model/motion/turn_left.h"
 #include "ai_server/model/motion/turn_right.h"
@@ -53,11 +54,17 @@ void driver::set_stable(const bool stable) {
   for (auto&& meta : robots_metadata_) std::get<1>(meta.second)->set_stable(stable);
 }
 
+const radio::telemetry& driver::telemetry() const {
+  return telemetry_;
+}
+
 void driver::register_robot(unsigned int id, controller_type controller, radio_type radio) {
   std::unique_lock lock(mutex_);
-  robots_metadata_.emplace(
-      std::piecewise_construct, std::forward_as_tuple(id),
-      std::forward_as_tuple(model::command{}, std::move(controller), std::move(radio)));
+  // 送信の度に問い合わせないように, Radio の種類を記録しておく
+  const bool batched = radio && radio->batched();
+  robots_metadata_.emplace(std::piecewise_construct, std::forward_as_tuple(id),
+                           std::forward_as_tuple(model::command{}, std::move(controller),
+                                                 std::move(radio), batched));
 }
 
 void driver::unregister_robot(unsigned int id) {
@@ -83,101 +90,168 @@ void driver::update_command(unsigned int id, const model::command& command) {
   }
 }
 
+void driver::trigger() {
+  trigger(trace::frame_timestamps{});
+}
+
+void driver::trigger(const trace::frame_timestamps& timestamps) {
+  boost::asio::post(timer_.get_executor(), [this, timestamps] {
+    // 待っているタイマを取り消す (main_loop() は operation_aborted で呼ばれ，何もしない)
+    timer_.cancel();
+    run_cycle(timestamps);
+  });
+}
+
 void driver::main_loop(const boost::system::error_code& error) {
   // TODO: エラーが発生したことを上の階層に伝える仕組みを実装する
   if (error) return;
+  run_cycle({});
+}
 
+void driver::run_cycle(const trace::frame_timestamps& timestamps) {
   // 処理の開始時刻を記録
   const auto start_time = std::chrono::steady_clock::now();
 
   std::unique_lock lock(mutex_);
 
-  // このループでのWorldModelを生成
-  const auto world = world_.value();
+  // このループでのWorldModelを取得
+  // 自チームのロボットとフィールドの情報は, 複製せずに snapshot が持つものを参照する
+  const auto world = world_.snapshot();
+  const auto& robots =
+      static_cast<bool>(team_color_) ? world->robots_yellow() : world->robots_blue();
+  const auto& field = world->field();
+
+  // 登録されたロボットのうち, 検出されているものを records_ に並べる
+  // (ロボットが検出されていないときは何もしない)
+  records_.clear();
+  for (auto&& [id, meta] : robots_metadata_) {
+    if (const auto it = robots.find(id); it != robots.cend()) {
+      records_.push_back({id, &meta, &it->second, 0.0, 0.0, 0.0});
+    }
+  }
 
-  // 登録されたロボットの命令をControllerを通してから送信する
-  for (auto&& [id, meta] : robots_metadata_) process(id, meta, world);
+  // 登録されたロボットの命令をControllerに通してから送信する
+  for (auto&& record : records_) control(record, field);
+  send();
+
+  // フレームの撮影から送信までにかかった時間を記録する
+  trace::latency::global().record(timestamps, std::chrono::system_clock::now());
 
   // 処理の開始時刻からcycle_経過した後に再度main_loop()が呼び出されるように設定
   timer_.expires_at(start_time + cycle_);
   timer_.async_wait([this](auto&& error) { main_loop(std::forward<decltype(error)>(error)); });
 }
 
-void driver::process(unsigned int id, metadata_type& metadata, const model::world& world) {
-  auto& [command, controller, radio] = metadata;
+void driver::control(record_type& record, const model::field& field) {
+  auto& [command, controller, radio, batched] = *record.metadata;
+  const auto& robot                           = *record.robot;
 
-  const auto robots =
-      static_cast<bool>(team_color_) ? world.robots_yellow() : world.robots_blue();
+  // 指令値を Controller に通して速度を得る
+  auto c = [&robot, &field, &c = *controller](auto&&... args) {
+    return c.update(robot, field, std::forward<decltype(args)>(args)...);
+  };
+  auto [sp, sp_rot] = command.setpoint_pair();
+  if (command.motion()) {
+    const auto [mvx, mvy, momega] = command.motion()->execute();
+    const auto st                 = std::sin(robot.theta());
+    const auto ct                 = std::cos(robot.theta());
+    const auto vxf                = ct * mvx - st * mvy;
+    const auto vyf                = st * mvx + ct * mvy;
+    command.set_velocity(vxf, vyf, momega);
+  }
+  auto [vx, vy, omega] = std::visit(c, sp, sp_rot);
+  if (!command.motion()) {
+    // 回転
+    constexpr double rot_th = 0.5;
+    // 動作は状態を持たないので, 共有インスタンスを使い回す (毎周期確保しない)
+    if (rot_th < omega) {
+      command.set_motion(model::motion::shared<model::motion::turn_left>());
+    } else if (omega < -rot_th) {
+      command.set_motion(model::motion::shared<model::motion::turn_right>());
+    } else {
+      command.set_motion(model::motion::shared<model::motion::stop>());
+    }
 
-  const auto field = world.field();
+    // 移動
+    constexpr double move_th = 100.0;
+    if (std::abs(vy) < std::abs(vx)) {
+      if (move_th < vx) {
+        command.set_motion(model::motion::shared<model::motion::walk_forward>());
+      } else if (vx < -move_th) {
+        command.set_motion(model::motion::shared<model::motion::walk_backward>());
+      }
+    } else {
+      if (move_th < vy) {
+        command.set_motion(model::motion::shared<model::motion::walk_right>());
+      } else if (vy < -move_th) {
+        command.set_motion(model::motion::shared<model::motion::walk_left>());
+      }
+    }
 
-  // ロボットが検出されていないときは何もしない
-  if (const auto it = robots.find(id); it != robots.cend()) {
-    const auto& robot = it->second;
+    const auto [mvx, mvy, momega] = command.motion()->execute();
+    vx                            = mvx;
+    vy                            = mvy;
+    omega                         = momega;
+  }
 
-    // 指令値を Controller に通して速度を得る
-    auto c = [&robot, &field, &c = *controller](auto&&... args) {
-      return c.update(robot, field, std::forward<decltype(args)>(args)...);
-    };
-    auto [sp, sp_rot] = command.setpoint_pair();
-    if (command.motion()) {
-      const auto [mvx, mvy, momega] = command.motion()->execute();
-      const auto st                 = std::sin(robot.theta());
-      const auto ct                 = std::cos(robot.theta());
-      const auto vxf                = ct * mvx - st * mvy;
-      const auto vyf                = st * mvx + ct * mvy;
-      command.set_velocity(vxf, vyf, momega);
-    }
-    auto [vx, vy, omega] = std::visit(c, sp, sp_rot);
-    if (!command.motion()) {
-      // 回転
-      constexpr double rot_th = 0.5;
-      if (rot_th < omega) {
-        command.set_motion(std::make_shared<model::motion::turn_left>());
-      } else if (omega < -rot_th) {
-        command.set_motion(std::make_shared<model::motion::turn_right>());
-      } else {
-        command.set_motion(std::make_shared<model::motion::stop>());
-      }
+  record.vx    = vx;
+  record.vy    = vy;
+  record.omega = omega;
+}
 
-      // 移動
-      constexpr double move_th = 100.0;
-      if (std::abs(vy) < std::abs(vx)) {
-        if (move_th < vx) {
-          command.set_motion(std::make_shared<model::motion::walk_forward>());
-        } else if (vx < -move_th) {
-          command.set_motion(std::make_shared<model::motion::walk_backward>());
-        }
-      } else {
-        if (move_th < vy) {
-          command.set_motion(std::make_shared<model::motion::walk_right>());
-        } else if (vy < -move_th) {
-          command.set_motion(std::make_shared<model::motion::walk_left>());
-        }
-      }
+void driver::send() {
+  const auto radio_of = [](const record_type& r) -> const radio_type& {
+    return std::get<2>(*r.metadata);
+  };
 
-      const auto [mvx, mvy, momega] = command.motion()->execute();
-      vx                            = mvx;
-      vy                            = mvy;
-      omega                         = momega;
-    }
+  // 同じ Radio を使うロボットが隣り合うように並べ替える
+  std::sort(records_.begin(), records_.end(),
+            [&radio_of](const auto& a, const auto& b) { return radio_of(a) < radio_of(b); });
+
+  for (auto first = records_.begin(); first != records_.end();) {
+    const auto& radio = radio_of(*first);
+    const auto last   = std::find_if(first, records_.end(),
+                                   [&](const auto& r) { return radio_of(r) != radio; });
 
     // 命令の送信
-    auto r = std::dynamic_pointer_cast<radio::base::simulator>(radio);
-    if (r) {
-      radio->send(team_color_, id, command.kick_flag(), command.dribble(), vx, vy, omega);
+    // まとめて受け付ける Radio (grSim, KIKS) へは同じ Radio を使うロボットの命令を1回で送る
+    if (std::get<3>(*first->metadata)) {
+      batch_.clear();
+      for (auto it = first; it != last; ++it) {
+        const auto& command = std::get<0>(*it->metadata);
+        batch_.push_back(
+            {it->id, command.kick_flag(), command.dribble(), it->vx, it->vy, it->omega});
+      }
+      radio->send_batch(team_color_, batch_);
     } else {
-      radio->send(team_color_, id, command.motion());
+      for (auto it = first; it != last; ++it) {
+        radio->send(team_color_, it->id, std::get<0>(*it->metadata).motion());
+      }
     }
 
-    // 登録された関数があればそれを呼び出す
-    // controller はロボット基準の速度を返すのでフィールド基準にもどす
-    const auto st  = std::sin(robot.theta());
-    const auto ct  = std::cos(robot.theta());
-    const auto vxf = ct * vx - st * vy;
-    const auto vyf = st * vx + ct * vy;
-    command_updated_(team_color_, id, command.kick_flag(), command.dribble(), vxf, vyf, omega);
+    const auto now = std::chrono::steady_clock::now();
+    std::for_each(first, last, [this, now](const auto& r) { notify(r, now); });
+    first = last;
   }
 }
 
+void driver::notify(const record_type& record, std::chrono::steady_clock::time_point time) {
+  const auto& command                              = std::get<0>(*record.metadata);
+  const auto& [id, metadata, robot, vx, vy, omega] = record;
+  const auto [kick_type, kick_power]               = command.kick_flag();
+
+  // 送信した命令を記録する (標準出力などへはここでは書き出さない)
+  const auto& motion = command.motion();
+  telemetry_.push({time, team_color_, id, motion ? motion->motion_id() : -1, vx, vy, omega,
+                   kick_type, kick_power, command.dribble()});
+
+  // 登録された関数があればそれを呼び出す
+  // controller はロボット基準の速度を返すのでフィールド基準にもどす
+  const auto st  = std::sin(robot->theta());
+  const auto ct  = std::cos(robot->theta());
+  const auto vxf = ct * vx - st * vy;
+  const auto vyf = st * vx + ct * vy;
+  command_updated_(team_color_, id, command.kick_flag(), command.dribble(), vxf, vyf, omega);
+}
+
 } // namespace ai_server
@@ -6,6 +6,7 @@
 #include <memory>
 #include <mutex>
 #include <tuple>
+#include <vector>
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/signals2.hpp>
@@ -15,6 +16,8 @@
 #include "ai_server/model/team_color.h"
 #include "ai_server/model/updater/world.h"
 #include "ai_server/radio/base/base.h"
+#include "ai_server/radio/telemetry.h"
+#include "ai_server/trace/latency.h"
 
 namespace ai_server {
 
@@ -24,7 +27,18 @@ class driver {
   /// Radioのポインタの型
   using radio_type = std::shared_ptr<radio::base::command>;
   /// Driverで行う処理で必要となる各ロボットの情報の型
-  using metadata_type = std::tuple<model::command, controller_type, radio_type>;
+  /// (命令, Controller, Radio, Radio が速度による命令をまとめて受け付けるか)
+  using metadata_type = std::tuple<model::command, controller_type, radio_type, bool>;
+  /// 1周期の処理で扱う, 検出されている各ロボットの情報の型
+  struct record_type {
+    unsigned int id;
+    metadata_type* metadata;
+    const model::robot* robot;
+    /// Controllerを通した後のロボット基準の速度
+    double vx;
+    double vy;
+    double omega;
+  };
   /// Commandが更新された(Controllerを通された)ときに発火するシグナルの型
   using updated_signal_type = boost::signals2::signal<void(
       model::team_color color, unsigned int id, const model::command::kick_flag_t& kick_flag,
@@ -45,6 +59,9 @@ public:
   void set_team_color(model::team_color color);
 
   /// @brief                  Driverにロボットを登録する
+  ///
+  /// Radio が速度による命令をまとめて受け付けるか (radio::base::command::batched()) は
+  /// ここで一度だけ調べておく
   /// @param id               ロボットのID
   /// @param controller       Controller
   /// @param radio            命令の送信に使う Radio のオブジェクト
@@ -80,6 +97,22 @@ public:
   /// @param stable           true->安定,false->通常
   void set_stable(const bool stable);
 
+  /// @brief                  送信した命令の記録を取得する
+  ///
+  /// 制御部のスレッドを止めずに, GUI やファイルへの書き出しなどから読み出せる
+  const radio::telemetry& telemetry() const;
+
+  /// @brief                  制御周期を待たずに，直ちに命令を Controller に通して送信する
+  ///
+  /// Vision のフレームに合わせて命令を更新したときに呼び, 送信までの待ち時間をなくす.
+  /// 処理は io_context のスレッドで行い, 次の周期はその時点から数え直す
+  /// (呼ばれなくなったときはタイマによる一定周期の処理に戻る)
+  void trigger();
+
+  /// @brief                  trigger() に加え, 送信までの時間を trace::latency に記録する
+  /// @param timestamps       命令の元になったフレームが各段階を通過した時刻
+  void trigger(const trace::frame_timestamps& timestamps);
+
   /// @brief                  mutex_ をロックする
   /// @param args             unique_lock へ渡す追加の引数
   template <class... Args>
@@ -91,8 +124,22 @@ private:
   /// @brief                  cycle_毎に呼ばれる制御部のメインループ
   void main_loop(const boost::system::error_code& error);
 
-  /// @brief                  ロボットへの命令をControllerを通してから送信する
-  void process(unsigned int id, metadata_type& metadata, const model::world& world);
+  /// @brief                  1周期分の処理を行い，cycle_ 後に main_loop() が呼ばれるようにする
+  /// @param timestamps       命令の元になったフレームの時刻 (frame が 0 のときは記録しない)
+  void run_cycle(const trace::frame_timestamps& timestamps);
+
+  /// @brief                  ロボットへの命令をControllerに通して速度を求める
+  /// @param record           処理するロボットの情報
+  /// @param field            このループでのフィールドの情報
+  void control(record_type& record, const model::field& field);
+
+  /// @brief                  Controllerを通した records_ の命令を Radio 毎にまとめて送信する
+  void send();
+
+  /// @brief                  送信した命令を telemetry_ に記録し, 更新されたことを通知する
+  /// @param record           処理するロボットの情報
+  /// @param time             送信した時刻
+  void notify(const record_type& record, std::chrono::steady_clock::time_point time);
 
   mutable std::recursive_mutex mutex_;
 
@@ -110,6 +157,14 @@ private:
   /// 登録されたロボットの情報
   std::unordered_map<unsigned int, metadata_type> robots_metadata_;
 
+  /// 現在のループで処理するロボットの情報 (毎周期の確保を避けるため使い回す)
+  std::vector<record_type> records_;
+  /// Radio へまとめて渡す速度指令 (使い回す)
+  std::vector<radio::base::robot_command> batch_;
+
+  /// 送信した命令の記録
+  radio::telemetry telemetry_;
+
   updated_signal_type command_updated_;
 };
 
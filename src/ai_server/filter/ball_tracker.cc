@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ball_tracker.h"
+
+namespace ai_server {
+namespace filter {
+
+ball_tracker::ball_tracker(double gate, duration_type lifetime, duration_type half_life)
+    : gate_(gate), lifetime_(lifetime), half_life_(half_life), next_id_(0), last_time_() {}
+
+void ball_tracker::update(const std::vector<observation>& observations, time_point_type time) {
+  using seconds = std::chrono::duration<double>;
+
+  last_time_ = std::max(last_time_, time);
+
+  // 寿命を過ぎたトラックを破棄する
+  for (auto& s : slots_) {
+    if (s && time - s->t.last_seen > lifetime_) s.reset();
+  }
+
+  // 扱う観測値を confidence の高い順に max_observations 個まで選ぶ
+  std::array<const observation*, max_observations> obs{};
+  std::size_t num_obs = 0;
+  for (const auto& o : observations) {
+    if (num_obs < max_observations) {
+      obs[num_obs++] = &o;
+    } else if (obs[num_obs - 1]->confidence < o.confidence) {
+      obs[num_obs - 1] = &o;
+    } else {
+      continue;
+    }
+    // 挿入ソートで降順を保つ
+    for (auto i = num_obs - 1; i > 0 && obs[i - 1]->confidence < obs[i]->confidence; --i) {
+      std::swap(obs[i - 1], obs[i]);
+    }
+  }
+
+  // 予測位置からゲート内にある (トラック, 観測値) の組を列挙する
+  struct candidate {
+    double d2;
+    std::size_t track;
+    std::size_t obs;
+  };
+  std::array<candidate, max_tracks * max_observations> candidates{};
+  std::size_t num_candidates = 0;
+  std::array<bool, max_observations> gated{};
+
+  for (std::size_t i = 0; i < max_tracks; ++i) {
+    if (!slots_[i]) continue;
+    const auto& b = slots_[i]->t.ball;
+    const auto dt = std::max(seconds(time - slots_[i]->t.last_seen).count(), 0.0);
+    const auto px = b.x() + b.vx() * dt;
+    const auto py = b.y() + b.vy() * dt;
+    for (std::size_t j = 0; j < num_obs; ++j) {
+      const auto dx = obs[j]->ball.x() - px;
+      const auto dy = obs[j]->ball.y() - py;
+      const auto d2 = dx * dx + dy * dy;
+      if (d2 <= gate_ * gate_) {
+        candidates[num_candidates++] = {d2, i, j};
+        gated[j]                     = true;
+      }
+    }
+  }
+
+  // 距離の近い組から順に割り当てる
+  std::sort(candidates.begin(), candidates.begin() + num_candidates,
+            [](const auto& a, const auto& b) { return a.d2 < b.d2; });
+  std::array<bool, max_tracks> track_assigned{};
+  std::array<bool, max_observations> obs_assigned{};
+  for (std::size_t k = 0; k < num_candidates; ++k) {
+    const auto& c = candidates[k];
+    if (track_assigned[c.track] || obs_assigned[c.obs]) continue;
+    track_assigned[c.track] = true;
+    obs_assigned[c.obs]     = true;
+
+    auto& s = *slots_[c.track];
+    if (auto v = s.observer.update(obs[c.obs]->ball, time); v.has_value()) {
+      s.t.ball = std::move(*v);
+      s.t.ball.set_z(obs[c.obs]->ball.z());
+    }
+    s.t.score     = score_at(s.t) + obs[c.obs]->confidence;
+    s.t.last_seen = std::max(s.t.last_seen, time);
+  }
+
+  // どのトラックのゲートにも入らなかった観測値から新しいトラックを作る
+  // 空きが無ければ, 最もスコアの低いトラックを新しいトラックの初期スコアより低い場合に置き換える
+  for (std::size_t j = 0; j < num_obs; ++j) {
+    if (gated[j]) continue;
+
+    const auto initial_score = obs[j]->confidence / 2;
+
+    auto it = std::find_if(slots_.begin(), slots_.end(), [](const auto& s) { return !s; });
+    if (it == slots_.end()) {
+      it = std::min_element(slots_.begin(), slots_.end(), [this](const auto& a, const auto& b) {
+        return score_at(a->t) < score_at(b->t);
+      });
+      if (score_at((*it)->t) >= initial_score) continue;
+    }
+
+    it->emplace(slot{{next_id_++, obs[j]->ball, initial_score, time},
+                     state_observer::ball{obs[j]->ball, time}});
+  }
+}
+
+std::optional<model::ball> ball_tracker::best() const {
+  if (const auto t = best_track()) return t->ball;
+  return std::nullopt;
+}
+
+std::optional<ball_tracker::track> ball_tracker::best_track() const {
+  const slot* best = nullptr;
+  for (const auto& s : slots_) {
+    if (s && (!best || score_at(best->t) < score_at(s->t))) best = &*s;
+  }
+  if (!best) return std::nullopt;
+  return best->t;
+}
+
+std::vector<ball_tracker::track> ball_tracker::tracks() const {
+  std::vector<track> result{};
+  for (const auto& s : slots_) {
+    if (s) result.push_back(s->t);
+  }
+  std::sort(result.begin(), result.end(),
+            [this](const auto& a, const auto& b) { return score_at(a) > score_at(b); });
+  return result;
+}
+
+void ball_tracker::clear() {
+  for (auto& s : slots_) s.reset();
+}
+
+double ball_tracker::score_at(const track& t) const {
+  using seconds = std::chrono::duration<double>;
+  const auto dt = std::max(seconds(last_time_ - t.last_seen).count(), 0.0);
+  return t.score * std::exp2(-dt / seconds(half_life_).count());
+}
+
+} // namespace filter
+} // namespace ai_server
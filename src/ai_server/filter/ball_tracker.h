@@ -0,0 +1,108 @@
+#ifndef AI_SERVER_FILTER_BALL_TRACKER_H
+#define AI_SERVER_FILTER_BALL_TRACKER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "ai_server/model/ball.h"
+#include "state_observer/ball.h"
+
+namespace ai_server {
+namespace filter {
+
+/// @class   ball_tracker
+/// @brief   ボールの候補を複数追跡し, 最も確からしいものを選ぶ
+///
+/// 候補 (トラック) 毎に state_observer::ball で状態を推定する.
+/// 観測値は各トラックの予測位置からの距離でゲーティングして近いものから割り当て,
+/// confidence を時間で減衰させながら積算したスコアが最も高いトラックを出力する.
+/// 誤検出 (靴や反射など) は単発のトラックになるため, 追跡中のボールが飛ぶことはない.
+///
+/// トラック数と1フレームで扱う観測値の数に上限を設け, ヒープ確保も行わないため,
+/// 1フレームあたりの処理時間は一定以下に抑えられる
+class ball_tracker {
+public:
+  using time_point_type = std::chrono::system_clock::time_point;
+  using duration_type   = std::chrono::system_clock::duration;
+
+  /// 同時に追跡するトラックの最大数
+  static constexpr std::size_t max_tracks = 8;
+  /// 1フレームで扱う観測値の最大数 (超えた分は confidence の低いものから捨てる)
+  static constexpr std::size_t max_observations = 16;
+
+  /// 観測値
+  struct observation {
+    model::ball ball;
+    double confidence;
+  };
+
+  /// 追跡中の候補
+  struct track {
+    /// トラックの通し番号
+    std::uint64_t id;
+    /// 推定値
+    model::ball ball;
+    /// スコア (last_seen の時点での値)
+    double score;
+    /// 最後に観測値が割り当てられた時刻
+    time_point_type last_seen;
+  };
+
+  /// @param gate      観測値を割り当てる, 予測位置からの最大距離 [mm]
+  /// @param lifetime  観測値が割り当てられないトラックを保持する時間
+  /// @param half_life スコアが半減する時間
+  explicit ball_tracker(double gate = 500.0,
+                        duration_type lifetime  = std::chrono::milliseconds{500},
+                        duration_type half_life = std::chrono::milliseconds{200});
+
+  /// @brief              1フレーム分の観測値でトラックを更新する
+  /// @param observations 観測値
+  /// @param time         フレームがキャプチャされた時刻
+  void update(const std::vector<observation>& observations, time_point_type time);
+
+  /// @brief              最もスコアの高いトラックの推定値を取得する
+  ///
+  /// トラックが無ければ nullopt を返す
+  std::optional<model::ball> best() const;
+
+  /// @brief              最もスコアの高いトラックを取得する
+  ///
+  /// last_seen からそのフレームで観測値が割り当てられたかを調べられる.
+  /// トラックが無ければ nullopt を返す
+  std::optional<track> best_track() const;
+
+  /// @brief              追跡中のトラックをスコアの高い順に取得する
+  std::vector<track> tracks() const;
+
+  /// @brief              全てのトラックを破棄する
+  void clear();
+
+private:
+  /// トラックと, その状態を推定する状態オブザーバ
+  struct slot {
+    track t;
+    state_observer::ball observer;
+  };
+
+  /// @brief 最後に更新した時刻でのスコアを求める
+  double score_at(const track& t) const;
+
+  double gate_;
+  duration_type lifetime_;
+  duration_type half_life_;
+
+  std::array<std::optional<slot>, max_tracks> slots_;
+  /// 次に作るトラックの通し番号
+  std::uint64_t next_id_;
+  /// 最後に更新した時刻
+  time_point_type last_time_;
+};
+
+} // namespace filter
+} // namespace ai_server
+
+#endif // AI_SERVER_FILTER_BALL_TRACKER_H
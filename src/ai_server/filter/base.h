@@ -65,7 +65,7 @@ protected:
     }
   }
 
-  std::recursive_mutex& mutex() {
+  std::recursive_mutex& mutex() const {
     return mutex_;
   }
 
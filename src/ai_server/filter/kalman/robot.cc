@@ -0,0 +1,225 @@
+#include <cmath>
+
+#include "ai_server/util/math/angle.h"
+#include "robot.h"
+
+namespace ai_server {
+namespace filter {
+namespace kalman {
+
+namespace {
+
+/// 加速度を一定として offset 後の状態を求める
+std::optional<model::robot> constant_acceleration(const model::robot& r,
+                                                  std::chrono::system_clock::duration offset) {
+  const auto t = std::chrono::duration<double>(offset).count();
+  auto result  = r;
+  result.set_x(r.x() + r.vx() * t + r.ax() * t * t / 2);
+  result.set_y(r.y() + r.vy() * t + r.ay() * t * t / 2);
+  result.set_theta(util::math::wrap_to_pi(r.theta() + r.omega() * t + r.alpha() * t * t / 2));
+  result.set_vx(r.vx() + r.ax() * t);
+  result.set_vy(r.vy() + r.ay() * t);
+  result.set_omega(r.omega() + r.alpha() * t);
+  return result;
+}
+
+} // namespace
+
+robot_model::robot_model(const robot_parameters& params)
+    : params_(params), initialized_(false), time_(), rejections_(0) {}
+
+bool robot_model::update(const model::robot& value, time_point_type time) {
+  if (!initialized_) {
+    initialize(value, time);
+    return true;
+  }
+
+  // 前回の更新からの経過時間 [s] (順序が入れ替わった観測値では時間更新しない)
+  const auto dt = std::max(std::chrono::duration<double>(time - time_).count(), 0.0);
+  auto axes     = predicted(dt);
+
+  // イノベーションとその分散を求め, マハラノビス距離で外れ値を判定する
+  const std::array<double, 3> z{value.x(), value.y(), value.theta()};
+  const std::array<double, 3> r{std::pow(params_.measurement_noise_xy, 2),
+                                std::pow(params_.measurement_noise_xy, 2),
+                                std::pow(params_.measurement_noise_theta, 2)};
+  std::array<double, 3> nu{}, s{};
+  double d2 = 0.0;
+  for (std::size_t i = 0; i < 3; ++i) {
+    nu[i] = z[i] - axes[i].x(0);
+    if (i == 2) nu[i] = util::math::wrap_to_pi(nu[i]);
+    s[i] = axes[i].p(0, 0) + r[i];
+    d2 += nu[i] * nu[i] / s[i];
+  }
+
+  if (d2 > params_.outlier_threshold) {
+    // 外れ値が続く場合はロボットが移動させられたとみなして初期化し直す
+    if (++rejections_ > params_.max_rejections) {
+      initialize(value, time);
+      return true;
+    }
+    axes_ = axes;
+    time_ = std::max(time_, time);
+    return false;
+  }
+
+  // 観測更新 (観測行列は H = [1, 0, 0])
+  for (std::size_t i = 0; i < 3; ++i) {
+    const Eigen::Vector3d k = axes[i].p.col(0) / s[i];
+    axes[i].x += k * nu[i];
+    axes[i].p -= k * axes[i].p.row(0);
+  }
+  axes[2].x(0) = util::math::wrap_to_pi(axes[2].x(0));
+
+  axes_       = axes;
+  time_       = std::max(time_, time);
+  rejections_ = 0;
+  return true;
+}
+
+model::robot robot_model::predict(time_point_type time) const {
+  const auto dt = std::chrono::duration<double>(time - time_).count();
+  const auto& [x, y, theta] = predicted(std::max(dt, 0.0));
+
+  model::robot r{x.x(0), y.x(0), util::math::wrap_to_pi(theta.x(0))};
+  r.set_vx(x.x(1));
+  r.set_vy(y.x(1));
+  r.set_omega(theta.x(1));
+  r.set_ax(x.x(2));
+  r.set_ay(y.x(2));
+  r.set_alpha(theta.x(2));
+  r.set_estimator(constant_acceleration);
+  return r;
+}
+
+model::robot robot_model::state() const {
+  return predict(time_);
+}
+
+robot_model::covariance_type robot_model::covariance() const {
+  covariance_type c = covariance_type::Zero();
+  for (std::size_t i = 0; i < 3; ++i) c.block<3, 3>(3 * i, 3 * i) = axes_[i].p;
+  return c;
+}
+
+bool robot_model::initialized() const {
+  return initialized_;
+}
+
+robot_model::time_point_type robot_model::last_time() const {
+  return time_;
+}
+
+void robot_model::reset() {
+  initialized_ = false;
+  rejections_  = 0;
+}
+
+void robot_model::initialize(const model::robot& value, time_point_type time) {
+  // 速度と加速度は未知なので大きな分散を与える
+  const auto init = [](double v, double sp, double sv, double sa) {
+    axis a{};
+    a.x = {v, 0.0, 0.0};
+    a.p = Eigen::Vector3d{sp * sp, sv * sv, sa * sa}.asDiagonal();
+    return a;
+  };
+  axes_[0] = init(value.x(), params_.measurement_noise_xy, 5.0e3, 1.0e4);
+  axes_[1] = init(value.y(), params_.measurement_noise_xy, 5.0e3, 1.0e4);
+  axes_[2] = init(util::math::wrap_to_pi(value.theta()), params_.measurement_noise_theta, 2.0e1,
+                  1.0e2);
+
+  initialized_ = true;
+  time_        = time;
+  rejections_  = 0;
+}
+
+std::array<robot_model::axis, 3> robot_model::predicted(double dt) const {
+  auto axes = axes_;
+  if (dt <= 0.0) return axes;
+
+  const auto dt2 = dt * dt;
+  const auto dt3 = dt2 * dt;
+
+  // 状態遷移行列
+  const auto f = (Eigen::Matrix3d{} << 1, dt, dt2 / 2, // f11, f12, f13
+                  0, 1, dt,                            // f21, f22, f23
+                  0, 0, 1                              // f31, f32, f33
+                  )
+                     .finished();
+  // 加加速度を白色雑音としたときのプロセスノイズの共分散 (分散で正規化したもの)
+  const auto q = (Eigen::Matrix3d{} << dt3 * dt2 / 20, dt2 * dt2 / 8, dt3 / 6, // q11, q12, q13
+                  dt2 * dt2 / 8, dt3 / 3, dt2 / 2,                             // q21, q22, q23
+                  dt3 / 6, dt2 / 2, dt                                         // q31, q32, q33
+                  )
+                     .finished();
+
+  const std::array<double, 3> qs{std::pow(params_.process_noise_xy, 2),
+                                 std::pow(params_.process_noise_xy, 2),
+                                 std::pow(params_.process_noise_theta, 2)};
+  for (std::size_t i = 0; i < 3; ++i) {
+    axes[i].x = f * axes[i].x;
+    axes[i].p = f * axes[i].p * f.transpose() + qs[i] * q;
+  }
+  return axes;
+}
+
+robot<timing::same>::robot(const robot_parameters& params) : params_(params), model_(params) {}
+
+std::optional<model::robot> robot<timing::same>::update(
+    std::optional<model::robot> value, std::chrono::system_clock::time_point time) {
+  std::unique_lock lock{mutex_};
+
+  if (value.has_value()) {
+    model_.update(*value, time);
+    return model_.state();
+  }
+
+  // 観測されなかったときは lost_duration_ が経過するまで予測値を返す
+  if (!model_.initialized() || time - model_.last_time() > params_.lost_duration) {
+    model_.reset();
+    return std::nullopt;
+  }
+  return model_.predict(time);
+}
+
+robot_model::covariance_type robot<timing::same>::covariance() const {
+  std::unique_lock lock{mutex_};
+  return model_.covariance();
+}
+
+robot<timing::manual>::robot(std::recursive_mutex& mutex, writer_func_type wf,
+                             const robot_parameters& params)
+    : base(mutex, wf), params_(params), model_(params) {}
+
+void robot<timing::manual>::set_raw_value(std::optional<model::robot> value,
+                                          std::chrono::system_clock::time_point time) {
+  std::unique_lock lock{mutex()};
+
+  if (value.has_value()) {
+    model_.update(*value, time);
+    write(model_.state());
+    return;
+  }
+
+  // 観測されなかったときは lost_duration_ が経過するまで予測値を書き込む
+  if (!model_.initialized() || time - model_.last_time() > params_.lost_duration) {
+    model_.reset();
+    write(std::nullopt);
+    return;
+  }
+  write(model_.predict(time));
+}
+
+void robot<timing::manual>::predict(std::chrono::system_clock::time_point time) {
+  std::unique_lock lock{mutex()};
+  if (model_.initialized()) write(model_.predict(time));
+}
+
+robot_model::covariance_type robot<timing::manual>::covariance() const {
+  std::unique_lock lock{mutex()};
+  return model_.covariance();
+}
+
+} // namespace kalman
+} // namespace filter
+} // namespace ai_server
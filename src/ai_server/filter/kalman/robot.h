@@ -0,0 +1,145 @@
+#ifndef AI_SERVER_FILTER_KALMAN_ROBOT_H
+#define AI_SERVER_FILTER_KALMAN_ROBOT_H
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+#include <Eigen/Core>
+
+#include "ai_server/filter/base.h"
+#include "ai_server/model/robot.h"
+
+namespace ai_server {
+namespace filter {
+namespace kalman {
+
+/// ロボットのカルマンフィルタのパラメータ
+struct robot_parameters {
+  /// 位置のプロセスノイズ (加加速度の標準偏差) [mm/s^3]
+  double process_noise_xy = 2.0e4;
+  /// 角度のプロセスノイズ (角加加速度の標準偏差) [rad/s^3]
+  double process_noise_theta = 2.0e2;
+  /// 位置の観測ノイズ (標準偏差) [mm]
+  double measurement_noise_xy = 3.0;
+  /// 角度の観測ノイズ (標準偏差) [rad]
+  double measurement_noise_theta = 0.02;
+  /// 外れ値とみなすマハラノビス距離の2乗の閾値
+  double outlier_threshold = 16.0;
+  /// 連続でこの回数だけ外れ値とみなされたら, 観測値で初期化し直す
+  unsigned int max_rejections = 5;
+  /// 観測されなくなってからロストさせるまでの時間
+  std::chrono::system_clock::duration lost_duration =
+      std::chrono::system_clock::duration::zero();
+};
+
+/// @class   robot_model
+/// @brief   等加速度モデルによるロボットの状態推定
+///
+/// 状態は x, y, theta の各軸について [位置, 速度, 加速度] を持ち,
+/// 加加速度を白色雑音とするプロセスノイズで時間更新を行う.
+/// 角度の観測値はイノベーションを [-pi, pi] に正規化して扱う.
+/// 状態遷移も観測も線形なので, 拡張カルマンフィルタではなく通常のカルマンフィルタになる
+class robot_model {
+public:
+  using time_point_type = std::chrono::system_clock::time_point;
+  /// 共分散行列の型 (並びは [x, vx, ax, y, vy, ay, theta, omega, alpha])
+  using covariance_type = Eigen::Matrix<double, 9, 9>;
+
+  explicit robot_model(const robot_parameters& params);
+
+  /// @brief       観測値で状態を更新する
+  /// @param value 観測値
+  /// @param time  観測された時刻
+  /// @return      観測値が使われたか (外れ値として捨てられたら false)
+  bool update(const model::robot& value, time_point_type time);
+
+  /// @brief       time における状態を予測する (内部状態は変化しない)
+  model::robot predict(time_point_type time) const;
+
+  /// @brief       最後に更新した時刻における状態を取得する
+  model::robot state() const;
+
+  /// @brief       最後に更新した時刻における共分散行列を取得する
+  covariance_type covariance() const;
+
+  /// @brief       初期化されているか
+  bool initialized() const;
+
+  /// @brief       最後に更新した時刻を取得する
+  time_point_type last_time() const;
+
+  /// @brief       状態を破棄する
+  void reset();
+
+private:
+  /// 1軸分の状態と共分散
+  struct axis {
+    Eigen::Vector3d x;
+    Eigen::Matrix3d p;
+  };
+
+  void initialize(const model::robot& value, time_point_type time);
+
+  /// @brief       dt [s] 後の状態を予測する
+  std::array<axis, 3> predicted(double dt) const;
+
+  robot_parameters params_;
+  bool initialized_;
+  time_point_type time_;
+  unsigned int rejections_;
+  /// x, y, theta の状態
+  std::array<axis, 3> axes_;
+};
+
+template <timing Timing>
+class robot;
+
+/// @brief 新しい観測値を受け取ったときに更新されるカルマンフィルタ
+template <>
+class robot<timing::same> : public base<model::robot, timing::same> {
+public:
+  explicit robot(const robot_parameters& params = {});
+
+  std::optional<model::robot> update(std::optional<model::robot> value,
+                                     std::chrono::system_clock::time_point time) override;
+
+  /// @brief       最後に更新した時刻における共分散行列を取得する
+  ///
+  /// update() とは別のスレッドから呼び出せる
+  robot_model::covariance_type covariance() const;
+
+private:
+  /// update() と covariance() の排他制御用
+  mutable std::mutex mutex_;
+  robot_parameters params_;
+  robot_model model_;
+};
+
+/// @brief 観測値を受け取ったときに加えて, 任意の時刻まで予測した値を書き込めるカルマンフィルタ
+template <>
+class robot<timing::manual> : public base<model::robot, timing::manual> {
+public:
+  robot(std::recursive_mutex& mutex, writer_func_type wf, const robot_parameters& params = {});
+
+  void set_raw_value(std::optional<model::robot> value,
+                     std::chrono::system_clock::time_point time) override;
+
+  /// @brief       time まで予測した値を書き込む
+  /// @param time  予測する時刻 (制御指令が実行される時刻など)
+  void predict(std::chrono::system_clock::time_point time);
+
+  /// @brief       最後に更新した時刻における共分散行列を取得する
+  robot_model::covariance_type covariance() const;
+
+private:
+  robot_parameters params_;
+  robot_model model_;
+};
+
+} // namespace kalman
+} // namespace filter
+} // namespace ai_server
+
+#endif // AI_SERVER_FILTER_KALMAN_ROBOT_H
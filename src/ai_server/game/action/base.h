@@ -35,11 +35,15 @@ public:
 
 protected:
   const model::world& world() const {
-    return ctx_.world;
+    return ctx_.world();
   }
 
   model::team_color team_color() const {
-    return ctx_.team_color;
+    return ctx_.team_color();
+  }
+
+  const game::spatial_index& spatial() const {
+    return ctx_.spatial();
   }
 
   const game::nnabla& nnabla() const {
@@ -17,7 +17,7 @@ chase_ball::chase_ball(context& ctx, unsigned int id, const Eigen::Vector2d& tar
       ball_pos_(util::math::position(world().ball())) {}
 
 chase_ball::chase_ball(context& ctx, unsigned int id)
-    : chase_ball(ctx, id, Eigen::Vector2d(ctx.world.field().x_max(), 0.0)) {}
+    : chase_ball(ctx, id, Eigen::Vector2d(ctx.world().field().x_max(), 0.0)) {}
 
 void chase_ball::set_target(double x, double y) {
   kick_target_ = {x, y};
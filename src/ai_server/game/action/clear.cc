@@ -42,6 +42,7 @@ if(rot_th <
 #include "clear.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
+#include "ai_server/model/motion/shared.h"
 #include "ai_server/model/motion/walk_forward.h"
 #include "ai_server/model/motion/turn_left.h"
 #include "ai_server/model/motion/turn_right.h"
@@ -68,15 +69,15 @@ namespace ai_server::game::action {
         const auto ball_pos = util::math::position(world().ball());
 
         //前進
-        command.set_motion(std::make_shared<model::motion::walk_forward>());
+        command.set_motion(model::motion::shared<model::motion::walk_forward>());
         //向きがあっていなければ回転（前進のモーションはキャンセルされる）
         constexpr double rot_th = 0.5;
         if (rot_th <
             util::math::inferior_angle(robot.theta(),
                 util::math::direction(ball_pos, robot_pos))){
-                    command.set_motion(std::make_shared<model::motion::turn_left>());
+                    command.set_motion(model::motion::shared<model::motion::turn_left>());
         } else if (omega < -rot_th) {
-            command.set_motion(std::make_shared<model::motion::turn_right>());
+            command.set_motion(model::motion::shared<model::motion::turn_right>());
         }
         return command;
     }
@@ -27,7 +27,7 @@ get_ball::get_ball(context& ctx, unsigned int id, const Eigen::Vector2d& target)
       allow_(10) {}
 
 get_ball::get_ball(context& ctx, unsigned int id)
-    : get_ball(ctx, id, Eigen::Vector2d(ctx.world.field().x_max(), 0.0)) {}
+    : get_ball(ctx, id, Eigen::Vector2d(ctx.world().field().x_max(), 0.0)) {}
 
 get_ball::running_state get_ball::state() const {
   return state_;
@@ -171,8 +171,7 @@ model::command get_ball::execute() {
 }
 
 void get_ball::kick(const Eigen::Vector2d& robot_pos,
-                    const std::unordered_map<unsigned int, model::robot>& enemy_robots,
-                    model::command& command) {
+                    const model::world::robots_list& enemy_robots, model::command& command) {
   if (kick_manually_) {
     command.set_kick_flag(manual_kick_flag_);
     return;
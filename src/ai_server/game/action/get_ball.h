@@ -90,8 +90,7 @@ public:
 
 private:
   // キックフラグを設定する
-  void kick(const Eigen::Vector2d& robot_pos,
-            const std::unordered_map<unsigned int, model::robot>& enemy_robots,
+  void kick(const Eigen::Vector2d& robot_pos, const model::world::robots_list& enemy_robots,
             model::command& command);
   // 状態
   running_state state_;
@@ -61,20 +61,17 @@ model::command goal_keep::execute() {
   const Eigen::Vector2d ball_pos = util::math::position(world().ball());
 
   // ボールの直線
-  auto f = [&enemy_robots, &goal_pos, &ball_vel, &ball_pos](double x) {
+  auto f = [this, &enemy_robots, &goal_pos, &ball_vel, &ball_pos](double x) {
     // ボールの速度が出ていればボール軌道
     if ((goal_pos - ball_pos).normalized().dot(ball_vel) > 1000.0)
       return (ball_vel.y() / ball_vel.x()) * (x - ball_pos.x()) + ball_pos.y();
 
     // 敵が蹴りそうなら敵の向き
-    const auto kicker_itr = std::min_element(     //距離が最小 == min_element
-        enemy_robots.cbegin(), enemy_robots.cend(), [&ball_pos](auto& a, auto& b) {
-          return (util::math::position(a.second) - ball_pos).norm() <
-                 (util::math::position(b.second) - ball_pos).norm();
-        });
-    if (kicker_itr != enemy_robots.cend()) {
-      const auto kicker_pos   = util::math::position(kicker_itr->second);
-      const auto kicker_theta = kicker_itr->second.theta();
+    // ボールに最も近い敵
+    const auto kicker = spatial().nearest(spatial_index::team::enemies, ball_pos);
+    if (kicker) {
+      const auto kicker_pos   = util::math::position(enemy_robots.at(kicker->id));
+      const auto kicker_theta = enemy_robots.at(kicker->id).theta();
       if ((kicker_pos - ball_pos).norm() < 1000.0 &&
           std::abs(std::atan2(ball_pos.y() - kicker_pos.y(), ball_pos.x() - kicker_pos.x()) -
                    kicker_theta) < pi<double>() / 3.0)
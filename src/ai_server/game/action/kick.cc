@@ -8,6 +8,7 @@
 #include "ai_server/model/motion/left_kick.h"
 #include "ai_server/model/motion/left_outside_kick.h"
 #include "ai_server/model/motion/turn_left.h"
+#include "ai_server/model/motion/shared.h"
 #include "ai_server/model/motion/turn_right.h"
 
 #include "kick.h"
@@ -144,24 +145,24 @@ model::command kick::execute() {
       //キーパーが右                                                                                  //ロボットとボールの位置を見ているので、相手のきーぱーの位置を取得、それとぼーるの角度を確認してif（switch）で制御
       if(robot_ene.y() < 0){                                                                      //参考：キーパーロボットの開脚で守れる範囲は、ロボットを中心に30cm、シュートの入る角度（rad）は左右に0.3ずつ
         //左キック
-        command.set_motion(std::make_shared<model::motion::left_kick>());
+        command.set_motion(model::motion::shared<model::motion::left_kick>());
 
         //キーパーが極端に右
         if(pi<double>() / 7.2 < std::abs(std::atan2(robot_pos.y() - robot_ene.y(), robot_pos.x() - robot_ene.x()) - keeper_theta) < pi<double>() / 4.0){
           command.set_position(robot_ene);
-          command.set_motion(std::make_shared<model::motion::left_outside_kick>());
+          command.set_motion(model::motion::shared<model::motion::left_outside_kick>());
         }
 
 
       //キーパーが左
       }else if(robot_ene.y() >0){
         //右キック
-        command.set_motion(std::make_shared<model::motion::right_kick>());
+        command.set_motion(model::motion::shared<model::motion::right_kick>());
 
         //キーパーが極端に左
         if(pi<double>() / -7.2 < std::abs(std::atan2(robot_pos.y() - robot_ene.y(), robot_pos.x() - robot_ene.x()) - keeper_theta) < pi<double>() / -4.0){
           command.set_position(robot_ene);
-          command.set_motion(std::make_shared<model::motion::right_outside_kick>());
+          command.set_motion(model::motion::shared<model::motion::right_outside_kick>());
         }
       }
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <Eigen/Core>
 
 #include "ai_server/planner/base.h"
@@ -6,39 +8,82 @@
 
 namespace ai_server::game::action {
 
+// setpoint が速度のときに想定する加速度
+static constexpr double acc = 3000.0;
+// 軌道に沿った速度を指令値にするときに先読みする時間 [s] (Driver の制御周期)
+static constexpr double lookahead = 1.0 / 60.0;
+
 bool with_planner::finished() const {
   return action_->finished();
 }
 
 model::command with_planner::execute() {
-  auto cmd = action_->execute();
+  if (prepare()) plan();
+  return finish();
+}
+
+bool with_planner::prepare() {
+  command_ = action_->execute();
+  target_velocity_.reset();
+  planned_.reset();
 
-  if (auto sp  = cmd.setpoint_pair();
+  if (auto sp  = command_.setpoint_pair();
       auto pos = std::get_if<model::setpoint::position>(&std::get<0>(sp))) {
     const auto robot = our_robots(world(), team_color()).at(id());
-    const auto start = util::math::position(robot);
-    const auto goal  = Eigen::Vector2d(std::get<0>(*pos), std::get<1>(*pos));
-
-    const auto planner = planner_->planner();
-    const auto new_pos = planner(start, goal, obstacles_);
-    cmd.set_position(std::get<0>(new_pos));
-  } else if (auto sp  = cmd.setpoint_pair();
+    start_           = util::math::position(robot);
+    goal_            = Eigen::Vector2d(std::get<0>(*pos), std::get<1>(*pos));
+    planner_->set_current_velocity(util::math::velocity(robot));
+    return true;
+  } else if (auto sp  = command_.setpoint_pair();
              auto vel = std::get_if<model::setpoint::velocity>(&std::get<0>(sp))) {
-    constexpr double acc  = 3000.0;
     const auto robot      = our_robots(world(), team_color()).at(id());
-    const auto start      = util::math::position(robot);
     const auto target_vel = Eigen::Vector2d(std::get<0>(*vel), std::get<1>(*vel));
-    const Eigen::Vector2d goal =
-        (target_vel.squaredNorm() / (2.0 * acc)) * target_vel.normalized() + start;
-
-    const auto planner = planner_->planner();
-    const auto new_pos = planner(start, goal, obstacles_);
-    cmd.set_velocity(std::min(std::sqrt(2.0 * acc * (std::get<0>(new_pos) - start).norm()),
-                              target_vel.norm()) *
-                     (std::get<0>(new_pos) - start).normalized());
+    start_                = util::math::position(robot);
+    target_velocity_      = target_vel;
+
+    // 目標速度まで加速するのに必要な距離だけ先を目標位置とする
+    goal_ = (target_vel.squaredNorm() / (2.0 * acc)) * target_vel.normalized() + start_;
+    planner_->set_current_velocity(util::math::velocity(robot));
+    return true;
+  }
+
+  return false;
+}
+
+void with_planner::plan() {
+  const auto planner = planner_->planner();
+  planned_           = std::get<0>(planner(start_, goal_, obstacles_));
+}
+
+model::command with_planner::finish() {
+  if (!planned_) return command_;
+
+  // 時刻付きの軌道を出力する planner が障害物を避けているときは，
+  // 軌道に沿った速度を指令し，Controller (controller::state_feedback) に追従させる
+  if (const auto v = planner_->velocity_at(lookahead)) {
+    command_.set_velocity(*v);
+    return command_;
+  }
+
+  const Eigen::Vector2d new_pos = *planned_;
+  if (target_velocity_) {
+    const auto& target_vel = *target_velocity_;
+    command_.set_velocity(std::min(std::sqrt(2.0 * acc * (new_pos - start_).norm()),
+                                   target_vel.norm()) *
+                          (new_pos - start_).normalized());
+  } else {
+    command_.set_position(new_pos);
   }
 
-  return cmd;
+  return command_;
+}
+
+void with_planner::set_seed(std::uint32_t seed) {
+  planner_->set_seed(seed);
+}
+
+void with_planner::set_deadline(std::chrono::steady_clock::time_point deadline) {
+  planner_->set_deadline(deadline);
 }
 
 } // namespace ai_server::game::action
@@ -1,8 +1,12 @@
 #ifndef AI_SERVER_GAME_ACTION_WITH_PLANNER_H
 #define AI_SERVER_GAME_ACTION_WITH_PLANNER_H
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <type_traits>
+#include <Eigen/Core>
 
 #include "ai_server/planner/obstacle_list.h"
 #include "base.h"
@@ -14,11 +18,25 @@ class base;
 namespace ai_server::game::action {
 
 /// action を wrap し、目標値を planner に掛けたものを出力する
+///
+/// execute() は prepare(), plan(), finish() を順に呼ぶのと同じ.
+/// 複数の with_planner の plan() は並列に呼び出せるため, game::planning_stage は
+/// 全ての action の prepare() を済ませた後に経路探索だけをまとめて並列に行う
 class with_planner : public action::base {
   std::shared_ptr<action::base> action_;
   std::unique_ptr<planner::base> planner_;
   planner::obstacle_list obstacles_;
 
+  // wrap した action が出力した指令値
+  model::command command_;
+  // 経路探索の開始位置, 目標位置
+  Eigen::Vector2d start_;
+  Eigen::Vector2d goal_;
+  // setpoint が速度のときの目標速度
+  std::optional<Eigen::Vector2d> target_velocity_;
+  // 経路探索の結果
+  std::optional<Eigen::Vector2d> planned_;
+
 public:
   template <class Action,
             std::enable_if_t<std::is_base_of_v<action::base, Action> &&
@@ -33,6 +51,24 @@ public:
   bool finished() const override;
 
   model::command execute() override;
+
+  /// @brief                  wrap した action を実行し, 経路探索の開始位置と目標位置を決める
+  /// @return                 経路探索が必要か
+  bool prepare();
+
+  /// @brief                  prepare() で決めた目標位置に対して経路探索を行う
+  ///
+  /// 他の with_planner の plan() と並列に呼び出してよい
+  void plan();
+
+  /// @brief                  経路探索の結果を反映した指令値を取得する
+  model::command finish();
+
+  /// @brief                  planner の乱数シードを設定する
+  void set_seed(std::uint32_t seed);
+
+  /// @brief                  planner の探索を打ち切る時刻を設定する
+  void set_deadline(std::chrono::steady_clock::time_point deadline);
 };
 
 } // namespace ai_server::game::action
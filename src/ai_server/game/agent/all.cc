@@ -70,8 +70,9 @@ std::vector<std::shared_ptr<action::base>> all::execute() {
           model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
     }
     common_obstacles = ene_robots_obstacles;
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_static(
+        model::obstacle::penalty_areas(world().field(), penalty_margin));
+    common_obstacles.freeze();
   }
 
   ///////////////////////////////////////////
@@ -157,11 +157,11 @@ std::vector<std::shared_ptr<action::base>> ball_placement::execute() {
 
     // receiver & waiter ///////////////////////////
     planner::obstacle_list common_obstacles;
-    common_obstacles.add(model::obstacle::enemy_penalty_area(wf, 150.0));
-    common_obstacles.add(model::obstacle::our_penalty_area(wf, 150.0));
+    common_obstacles.set_static(model::obstacle::penalty_areas(wf, 150.0));
     for (const auto& robot : ene_robots) {
       common_obstacles.add(model::obstacle::point{util::math::position(robot.second), 200.0});
     }
+    common_obstacles.freeze();
 
     if (is_active_ && pass_flag) waiters_.push_back(current_receiver_);
     int count = 0;
@@ -71,6 +71,7 @@ std::vector<std::shared_ptr<action::base>> defense::execute() {
           model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
     }
     common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
+    common_obstacles.freeze();
   }
 
   //ここから壁の処理
@@ -80,13 +81,12 @@ std::vector<std::shared_ptr<action::base>> defense::execute() {
                  [&](const unsigned int x) { return ally_robots.count(x); });
 
     //実際にアクションを詰めて返す
+    // 敵ロボットをゴールに近い順に並べる
     std::vector<Eigen::Vector2d> enemy_pos;
-    std::transform(enemy_robots.begin(), enemy_robots.end(), std::back_inserter(enemy_pos),
-                   [](const auto& eit) { return util::math::position(eit.second); });
-
-    std::sort(enemy_pos.begin(), enemy_pos.end(), [&goal](const auto& a, const auto& b) {
-      return (a - goal).norm() < (b - goal).norm();
-    });
+    for (const auto& e : spatial().nearest_k(spatial_index::team::enemies, goal,
+                                             model::world::max_robots)) {
+      enemy_pos.push_back(*spatial().position(spatial_index::team::enemies, e.id));
+    }
 
     std::vector<Eigen::Vector2d> target_pos;
     target_pos.push_back(ball);
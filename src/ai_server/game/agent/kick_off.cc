@@ -65,8 +65,9 @@ std::vector<std::shared_ptr<action::base>> kick_off::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), enemy_robot_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_static(
+        model::obstacle::penalty_areas(world().field(), penalty_margin));
+    common_obstacles.freeze();
   }
 
   const auto ball = world().ball();
@@ -106,17 +107,11 @@ std::vector<std::shared_ptr<action::base>> kick_off::execute() {
 
       if (!visible_waiter.empty()) {
         // 待機ロボットの中で一番近いロボットをレシーバーにする
-        const auto nearest =
-            std::min_element(visible_waiter.cbegin(), visible_waiter.cend(),
-                             [&ball, &our_robots](auto& a, auto& b) {
-                               const auto first  = util::math::position(our_robots.at(a));
-                               const auto second = util::math::position(our_robots.at(b));
-                               return (first - util::math::position(ball)).norm() <
-                                      (second - util::math::position(ball)).norm();
-                             });
+        const auto nearest = spatial().nearest(spatial_index::team::ours,
+                                               spatial().ball_position(), visible_waiter);
         // 蹴った後は変えない
-        if (!kick_finished_) {
-          receiver_id_ = *nearest;
+        if (!kick_finished_ && nearest) {
+          receiver_id_ = nearest->id;
         }
         kick_to_x = our_robots.at(receiver_id_).x();
         kick_to_y = our_robots.at(receiver_id_).y();
@@ -180,6 +175,7 @@ std::vector<std::shared_ptr<action::base>> kick_off::execute() {
     common_obstacles.add(model::obstacle::center_circle(world().field(), 150.0));
     if (!start_flag_)
       common_obstacles.add(model::obstacle::point{util::math::position(ball), 650.0});
+    common_obstacles.freeze();
     if (!kick_finished_) {
       //蹴られるまではkickoff waiterと同じ処理
       int count_a           = 2; //何番目のロボットか判別
@@ -36,13 +36,13 @@ std::vector<std::shared_ptr<action::base>> kick_off_waiter::execute() {
   // 障害物設定
   planner::obstacle_list common_obstacles;
   common_obstacles.add(model::obstacle::center_circle(wf, 150.0));
-  common_obstacles.add(model::obstacle::enemy_penalty_area(wf, 150.0));
-  common_obstacles.add(model::obstacle::our_penalty_area(wf, 150.0));
+  common_obstacles.set_static(model::obstacle::penalty_areas(wf, 150.0));
   common_obstacles.add(model::obstacle::point{ball_pos, 650.0});
   for (const auto& robot : ene_robots) {
     common_obstacles.add(
         model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
   }
+  common_obstacles.freeze();
 
   if (mode_ == kickoff_mode::attack) {
     // 攻撃側
@@ -84,22 +84,17 @@ std::vector<std::shared_ptr<action::base>> kick_off_waiter::execute() {
     std::vector<unsigned int> ene_robots_id;
     for (auto& enemy : ene_robots) ene_robots_id.push_back(enemy.first);
 
-    // 敵キッカーをマーク候補から除外
-    const auto ball_near_it = std::min_element(
-        ene_robots_id.cbegin(), ene_robots_id.cend(), [&ene_robots, &ball_pos](auto a, auto b) {
-          return (util::math::position(ene_robots.at(a)) - ball_pos).norm() <
-                 (util::math::position(ene_robots.at(b)) - ball_pos).norm();
-        });
-    // 敵キッカーの座標を取得し,マーキング候補から除外
+    // 敵キッカー (ボールに最も近い敵ロボット) の座標を取得し,マーキング候補から除外
     double enemy_theta = 0;
     double enemy_x     = 0;
     double enemy_y     = 0;
-    if (ball_near_it != ene_robots_id.end()) {
-      const auto& enemy = ene_robots.at(*ball_near_it);
+    if (const auto kicker = spatial().nearest(spatial_index::team::enemies, ball_pos)) {
+      const auto& enemy = ene_robots.at(kicker->id);
       enemy_theta       = enemy.theta();
       enemy_x           = enemy.x();
       enemy_y           = enemy.y();
-      ene_robots_id.erase(ball_near_it);
+      ene_robots_id.erase(std::remove(ene_robots_id.begin(), ene_robots_id.end(), kicker->id),
+                          ene_robots_id.end());
     }
 
     // 常に敵キッカーの目の前にいるような位置取りにする
@@ -108,25 +103,21 @@ std::vector<std::shared_ptr<action::base>> kick_off_waiter::execute() {
     const double x     = std::min(-std::abs(r * std::cos(enemy_theta)), -100.0);
     const double y     = r * std::sin(enemy_theta);
     const double theta = std::atan2(enemy_y - y, enemy_x - x);
-    const auto it =
-        std::min_element(tmp_ids.cbegin(), tmp_ids.cend(), [&our_robots, x, y](auto a, auto b) {
-          return std::hypot(our_robots.at(a).x() - x, our_robots.at(a).y() - y) <
-                 std::hypot(our_robots.at(b).x() - x, our_robots.at(b).y() - y);
-        });
-    if (it != tmp_ids.end()) {
-      auto move = make_action<action::move>(*it);
+    if (const auto nearest = spatial().nearest(spatial_index::team::ours, {x, y}, tmp_ids)) {
+      const auto id = nearest->id;
+      auto move     = make_action<action::move>(id);
       move->move_to(x, y, theta);
 
       auto hl = std::make_unique<planner::human_like>();
       hl->set_area(wf, area_margin);
       auto obstacles = common_obstacles;
       for (const auto& robot : our_robots) {
-        if (robot.first != *it)
+        if (robot.first != id)
           obstacles.add(
               model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
       }
       exe.push_back(std::make_shared<action::with_planner>(move, std::move(hl), obstacles));
-      tmp_ids.erase(it);
+      tmp_ids.erase(std::remove(tmp_ids.begin(), tmp_ids.end(), id), tmp_ids.end());
     }
 
     // 敵をセンターラインに近い順にソート
@@ -143,24 +134,22 @@ std::vector<std::shared_ptr<action::base>> kick_off_waiter::execute() {
       constexpr double theta = 0;
 
       // マークするロボットの決定
-      const auto it = std::min_element(
-          tmp_ids.cbegin(), tmp_ids.cend(), [&our_robots, x, y](auto a, auto b) {
-            return std::hypot(our_robots.at(a).x() - x, our_robots.at(a).y() - y) <
-                   std::hypot(our_robots.at(b).x() - x, our_robots.at(b).y() - y);
-          });
-      auto move = make_action<action::move>(*it);
+      const auto nearest = spatial().nearest(spatial_index::team::ours, {x, y}, tmp_ids);
+      if (!nearest) return exe;
+      const auto id = nearest->id;
+      auto move     = make_action<action::move>(id);
       move->move_to(x, y, theta);
 
       auto hl = std::make_unique<planner::human_like>();
       hl->set_area(wf, area_margin);
       auto obstacles = common_obstacles;
       for (const auto& robot : our_robots) {
-        if (robot.first != *it)
+        if (robot.first != id)
           obstacles.add(
               model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
       }
       exe.push_back(std::make_shared<action::with_planner>(move, std::move(hl), obstacles));
-      tmp_ids.erase(it);
+      tmp_ids.erase(std::remove(tmp_ids.begin(), tmp_ids.end(), id), tmp_ids.end());
     }
   }
 
@@ -1,5 +1,6 @@
 #include <cmath>
 #include <algorithm>
+#include <optional>
 
 #include "ai_server/game/action/get_ball.h"
 #include "ai_server/game/action/marking.h"
@@ -7,7 +8,9 @@
 #include "ai_server/game/action/vec.h"
 #include "ai_server/game/action/with_planner.h"
 #include "ai_server/model/obstacle/field.h"
+#include "ai_server/model/obstacle/robot.h"
 #include "ai_server/planner/human_like.h"
+#include "ai_server/planner/velocity_obstacle.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -59,16 +62,18 @@ marking::marking(context& ctx, const std::vector<unsigned int>& ids, bool setpla
       while (marker_ids.size() != 0) {
         for (const auto eid : enemy_ids_) {
           if (marker_ids.size() != 0) {
-            const auto id = std::min_element(
-                marker_ids.cbegin(), marker_ids.cend(),
-                [&enemy_robots, &our_robots, &eid](const auto& a, const auto& b) {
-                  return std::hypot(our_robots.at(a).x() - enemy_robots.at(eid).x(),
-                                    our_robots.at(a).y() - enemy_robots.at(eid).y()) <
-                         std::hypot(our_robots.at(b).x() - enemy_robots.at(eid).x(),
-                                    our_robots.at(b).y() - enemy_robots.at(eid).y());
-                });
-            mark_pairs_.insert(std::make_pair(*id, eid));
-            marker_ids.erase(id);
+            // マーク対象に最も近いマーカー
+            const auto marker =
+                spatial().nearest(spatial_index::team::ours,
+                                  util::math::position(enemy_robots.at(eid)), marker_ids);
+            if (!marker) {
+              // 見えているマーカーが残っていなければ割り当てを終える
+              marker_ids.clear();
+              break;
+            }
+            mark_pairs_.insert(std::make_pair(marker->id, eid));
+            marker_ids.erase(std::remove(marker_ids.begin(), marker_ids.end(), marker->id),
+                             marker_ids.end());
           }
         }
       }
@@ -100,8 +105,16 @@ std::vector<std::shared_ptr<action::base>> marking::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), obs_enemy_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_static(
+        model::obstacle::penalty_areas(world().field(), penalty_margin));
+    common_obstacles.freeze();
+  }
+  // マークする相手は動き続けるため, マーク中は敵ロボットを移動する障害物として避ける
+  planner::obstacle_list common_moving_obstacles;
+  {
+    model::obstacle::add_moving_robots(common_moving_obstacles, enemy_robots, obs_enemy_rad);
+    common_moving_obstacles.set_static(
+        model::obstacle::penalty_areas(world().field(), penalty_margin));
   }
 
   using boost::math::constants::pi;
@@ -201,16 +214,18 @@ std::vector<std::shared_ptr<action::base>> marking::execute() {
     while (marker_ids.size() != 0) {
       for (const auto eid : enemy_ids_) {
         if (marker_ids.size() != 0) {
-          const auto id = std::min_element(
-              marker_ids.cbegin(), marker_ids.cend(),
-              [&enemy_robots, &our_robots, &eid](const auto& a, const auto& b) {
-                return std::hypot(our_robots.at(a).x() - enemy_robots.at(eid).x(),
-                                  our_robots.at(a).y() - enemy_robots.at(eid).y()) <
-                       std::hypot(our_robots.at(b).x() - enemy_robots.at(eid).x(),
-                                  our_robots.at(b).y() - enemy_robots.at(eid).y());
-              });
-          mark_pairs_.insert(std::make_pair(*id, eid));
-          marker_ids.erase(id);
+          // マーク対象に最も近いマーカー
+          const auto marker =
+              spatial().nearest(spatial_index::team::ours,
+                                util::math::position(enemy_robots.at(eid)), marker_ids);
+          if (!marker) {
+            // 見えているマーカーが残っていなければ割り当てを終える
+            marker_ids.clear();
+            break;
+          }
+          mark_pairs_.insert(std::make_pair(marker->id, eid));
+          marker_ids.erase(std::remove(marker_ids.begin(), marker_ids.end(), marker->id),
+                           marker_ids.end());
         }
       }
     }
@@ -222,14 +237,13 @@ std::vector<std::shared_ptr<action::base>> marking::execute() {
   for (const auto& our : our_robots) {
     our_ids.push_back(our.first);
   }
-  const auto nearest_id = std::min_element(
-      our_ids.cbegin(), our_ids.cend(),
-      [&our_robots, &ball](const unsigned int a, const unsigned int b) {
-        return std::hypot(our_robots.at(a).x() - ball.x(), our_robots.at(a).y() - ball.y()) <
-               std::hypot(our_robots.at(b).x() - ball.x(), our_robots.at(b).y() - ball.y());
-      });
-  const auto nid = *nearest_id;
-  our_ids.erase(nearest_id);
+  // ボールに最も近い自チームロボット
+  std::optional<unsigned int> nid{};
+  if (const auto nearest =
+          spatial().nearest(spatial_index::team::ours, spatial().ball_position())) {
+    nid = nearest->id;
+    our_ids.erase(std::remove(our_ids.begin(), our_ids.end(), *nid), our_ids.end());
+  }
 
   // それぞれのロボットに動作設定
   for (auto itr = mark_pairs_.cbegin(); itr != mark_pairs_.cend(); itr++) {
@@ -246,6 +260,14 @@ std::vector<std::shared_ptr<action::base>> marking::execute() {
     auto hl = std::make_unique<planner::human_like>();
     hl->set_area(world().field(), field_margin);
 
+    // マークには, 移動する障害物の予測位置を考慮する planner::velocity_obstacle を使用
+    planner::obstacle_list mark_obstacles = common_moving_obstacles;
+    model::obstacle::add_moving_robots_if(
+        mark_obstacles, our_robots, obs_robot_rad,
+        [id](unsigned int our_id, const model::robot&) { return our_id != id; });
+    auto vo = std::make_unique<planner::velocity_obstacle>();
+    vo->set_area(world().field(), field_margin);
+
     // 基本的にはkick_block、同一対象に複数台のマーカーがいる場合、最も近いロボット以外はshoot_block
     auto mark_mode =
         std::any_of(marker_ids_.cbegin(), marker_ids_.cend(),
@@ -326,7 +348,7 @@ std::vector<std::shared_ptr<action::base>> marking::execute() {
           mark->set_mode(mark_mode);
           mark->set_radius(300.0);
           baseaction.push_back(
-              std::make_shared<action::with_planner>(mark, std::move(hl), obstacles));
+              std::make_shared<action::with_planner>(mark, std::move(vo), mark_obstacles));
         } else {
           // 停止
           auto vec = make_action<action::vec>(id);
@@ -374,7 +396,7 @@ std::vector<std::shared_ptr<action::base>> marking::execute() {
           mark->set_mode(mark_mode);
           mark->set_radius(300.0);
           baseaction.push_back(
-              std::make_shared<action::with_planner>(mark, std::move(hl), obstacles));
+              std::make_shared<action::with_planner>(mark, std::move(vo), mark_obstacles));
         } else {
           // 停止
           auto vec = make_action<action::vec>(id);
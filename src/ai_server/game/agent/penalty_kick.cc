@@ -65,6 +65,7 @@ std::vector<std::shared_ptr<action::base>> penalty_kick::execute() {
     common_obstacles.add(
         model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
   }
+  common_obstacles.freeze();
 
   //////////////////////////////
   //      キッカーの処理
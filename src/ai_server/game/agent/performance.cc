@@ -71,8 +71,9 @@ std::vector<std::shared_ptr<action::base>> performance::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_static(
+        model::obstacle::penalty_areas(world().field(), penalty_margin));
+    common_obstacles.freeze();
   }
 
   ///////////////////////////////////////////
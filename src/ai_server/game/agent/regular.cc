@@ -77,8 +77,9 @@ std::vector<std::shared_ptr<action::base>> regular::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_static(
+        model::obstacle::penalty_areas(world().field(), penalty_margin));
+    common_obstacles.freeze();
   }
 
   // chaserを使う時
@@ -819,13 +820,9 @@ regular::point regular::select_target() const {
 // ターゲットに最も近いロボットID
 std::vector<unsigned int>::const_iterator regular::nearest_id(
     const std::vector<unsigned int>& can_ids, double target_x, double target_y) const {
-  const auto our_team = model::our_robots(world(), team_color());
-  return std::min_element(
-      can_ids.begin(), can_ids.end(),
-      [&target_x, &target_y, our_team](unsigned int a, unsigned int b) {
-        return std::hypot(our_team.at(a).x() - target_x, our_team.at(a).y() - target_y) <
-               std::hypot(our_team.at(b).x() - target_x, our_team.at(b).y() - target_y);
-      });
+  const auto nearest =
+      spatial().nearest(spatial_index::team::ours, {target_x, target_y}, can_ids);
+  return nearest ? std::find(can_ids.begin(), can_ids.end(), nearest->id) : can_ids.end();
 }
 
 // 空いているエリアを返す
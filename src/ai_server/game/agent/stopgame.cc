@@ -36,11 +36,11 @@ std::vector<std::shared_ptr<action::base>> stopgame::execute() {
   const double ballysign  = ((ball_pos.y() > 0) || (std::abs(ball_pos.y()) < 250)) ? 1.0 : -1.0;
   constexpr double margin = 700.0;
 
-  nearest_robot_ = *std::min_element(
-      visible_ids.cbegin(), visible_ids.cend(), [&ball_pos, &our_robots](auto& a, auto& b) {
-        return (util::math::position(our_robots.at(a)) - ball_pos).norm() <
-               (util::math::position(our_robots.at(b)) - ball_pos).norm();
-      });
+  // ボールに最も近いロボット (visible_ids は空でないので必ず見つかる)
+  if (const auto nearest =
+          spatial().nearest(spatial_index::team::ours, ball_pos, visible_ids)) {
+    nearest_robot_ = nearest->id;
+  }
 
   const double dist = (2 * world().field().y_max() -
                        std::abs(world().field().y_max() - std::abs(ball_pos.y()))) /
@@ -92,8 +92,9 @@ std::vector<std::shared_ptr<action::base>> stopgame::execute() {
           model::obstacle::point{util::math::position(ene.second), obs_robot_rad});
     }
     common_obstacles.add(model::obstacle::point{ball_pos, margin});
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_static(
+        model::obstacle::penalty_areas(world().field(), penalty_margin));
+    common_obstacles.freeze();
   }
   for (auto id : visible_ids) {
     const Eigen::Vector2d robot_pos = util::math::position(our_robots.at(id));
@@ -0,0 +1,33 @@
+#include <utility>
+
+#include "ai_server/game/nnabla.h"
+#include "context.h"
+
+namespace ai_server::game {
+
+context::context() : team_color_{model::team_color::blue} {}
+
+const model::world& context::world() const {
+  return world_;
+}
+
+model::team_color context::team_color() const {
+  return team_color_;
+}
+
+const spatial_index& context::spatial() const {
+  return spatial_;
+}
+
+void context::set_world(model::world world) {
+  world_ = std::move(world);
+  spatial_.update(world_, team_color_);
+}
+
+void context::set_team_color(model::team_color color) {
+  if (team_color_ == color) return;
+  team_color_ = color;
+  spatial_.update(world_, team_color_);
+}
+
+} // namespace ai_server::game
@@ -5,20 +5,46 @@
 
 #include "ai_server/model/team_color.h"
 #include "ai_server/model/world.h"
+#include "spatial_index.h"
 
 namespace ai_server::game {
 
 class nnabla;
 
 /// 戦略部全体で必要となる値
-struct context {
-  model::world world;
-  model::team_color team_color;
+///
+/// world と team_color は set_world(), set_team_color() でのみ変更し,
+/// その度にロボットとボールの位置に対する問い合わせ (spatial_index) を作り直す
+class context {
+public:
+  context();
+
+  /// @brief                  このループでの world model を取得する
+  const model::world& world() const;
+
+  /// @brief                  自チームのチームカラーを取得する
+  model::team_color team_color() const;
+
+  /// @brief                  world と team_color から作った問い合わせを取得する
+  const spatial_index& spatial() const;
+
+  /// @brief                  world model を更新する
+  /// @param world            このループでの world model
+  void set_world(model::world world);
+
+  /// @brief                  自チームのチームカラーを変更する
+  /// @param color            チームカラー
+  void set_team_color(model::team_color color);
 
   // game::context を利用する全ての箇所で NNabla のヘッダを include するのを防ぐため
   // また移行段階で nullptr を許容するため std::unique_ptr で扱う
   // この値に対する操作をする場合は "ai_server/game/nnabla.h" も include する
   std::unique_ptr<game::nnabla> nnabla;
+
+private:
+  model::world world_;
+  model::team_color team_color_;
+  spatial_index spatial_;
 };
 
 } // namespace ai_server::game
@@ -34,11 +34,11 @@ protected:
   }
 
   const model::world& world() const {
-    return ctx_.world;
+    return ctx_.world();
   }
 
   model::team_color team_color() const {
-    return ctx_.team_color;
+    return ctx_.team_color();
   }
 
   const game::nnabla& nnabla() const {
@@ -82,11 +82,11 @@ protected:
   }
 
   const model::world& world() const {
-    return ctx_.world;
+    return ctx_.world();
   }
 
   model::team_color team_color() const {
-    return ctx_.team_color;
+    return ctx_.team_color();
   }
 
   const game::nnabla& nnabla() const {
@@ -0,0 +1,63 @@
+#include <random>
+
+#include "ai_server/game/action/with_planner.h"
+#include "planning_stage.h"
+
+namespace ai_server::game {
+
+planning_stage::planning_stage(std::size_t threads)
+    : pool_{threads, "planning_stage"}, tick_{0} {}
+
+planning_stage::result_type planning_stage::execute(
+    const std::vector<std::shared_ptr<action::base>>& actions) {
+  result_type result{};
+  result.reserve(actions.size());
+  prepared_.clear();
+  planning_.clear();
+
+  // action の実行は world などを読むため, 呼び出し元のスレッドで順に行う
+  for (const auto& a : actions) {
+    if (auto wp = dynamic_cast<action::with_planner*>(a.get())) {
+      if (wp->prepare()) {
+        // 周期の番号とロボットIDから乱数シードを決める
+        std::seed_seq seq{static_cast<std::uint32_t>(tick_),
+                          static_cast<std::uint32_t>(tick_ >> 32), a->id()};
+        std::uint32_t seed{};
+        seq.generate(&seed, &seed + 1);
+        wp->set_seed(seed);
+        planning_.push_back(wp);
+      }
+      prepared_.emplace_back(wp, result.size());
+      result.emplace_back(a->id(), model::command{});
+    } else {
+      result.emplace_back(a->id(), a->execute());
+    }
+  }
+
+  if (budget_) {
+    const auto deadline = std::chrono::steady_clock::now() + *budget_;
+    for (auto wp : planning_) wp->set_deadline(deadline);
+  }
+
+  // 経路探索を並列に行う
+  pool_.parallel_for(planning_.size(), [this](std::size_t i) { planning_[i]->plan(); });
+
+  // 経路探索の結果を反映する
+  for (const auto& [wp, i] : prepared_) {
+    result[i].second = wp->finish();
+  }
+
+  ++tick_;
+  return result;
+}
+
+void planning_stage::set_time_budget(
+    std::optional<std::chrono::steady_clock::duration> budget) {
+  budget_ = budget;
+}
+
+std::uint64_t planning_stage::tick() const {
+  return tick_;
+}
+
+} // namespace ai_server::game
@@ -0,0 +1,65 @@
+#ifndef AI_SERVER_GAME_PLANNING_STAGE_H
+#define AI_SERVER_GAME_PLANNING_STAGE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "ai_server/game/action/base.h"
+#include "ai_server/model/command.h"
+#include "ai_server/util/thread_pool.h"
+
+namespace ai_server::game {
+
+namespace action {
+class with_planner;
+}
+
+/// @class   planning_stage
+/// @brief   1周期分の action を実行し, 経路探索をまとめて並列に行う
+///
+/// 全ての action を順に実行 (with_planner は prepare() まで) した後,
+/// 経路探索だけを thread_pool で並列に解き, 結果を反映した指令値を返す.
+/// rrt_star などの乱数シードは (周期の番号, ロボットID) から決めるため,
+/// スレッド数や実行順序によらず結果は同じになる
+class planning_stage {
+public:
+  /// ロボットIDと指令値の組
+  using result_type = std::vector<std::pair<unsigned int, model::command>>;
+
+  /// @param threads          経路探索を行う worker スレッドの数 (呼び出し元のスレッドは含まない)
+  explicit planning_stage(std::size_t threads);
+
+  /// @brief                  actions を実行し, 各ロボットの指令値を返す
+  /// @param actions          実行する action
+  /// @return                 actions と同じ順序の (ロボットID, 指令値) のリスト
+  result_type execute(const std::vector<std::shared_ptr<action::base>>& actions);
+
+  /// @brief                  1周期の経路探索に使える時間を設定する
+  ///
+  /// 設定すると, execute() で経路探索を始める時刻に budget を足した時刻を各 planner の
+  /// 打ち切り時刻とする. 時間内で探索を続ける planner はそれまで経路を改善し続ける
+  /// (worker より planner が多く, 打ち切り時刻の後に始まった planner も最低限の探索は行う)
+  void set_time_budget(std::optional<std::chrono::steady_clock::duration> budget);
+
+  /// @brief                  周期の番号を取得する (execute() を呼ぶ度に増える)
+  std::uint64_t tick() const;
+
+private:
+  util::thread_pool pool_;
+  std::uint64_t tick_;
+  std::optional<std::chrono::steady_clock::duration> budget_;
+
+  // with_planner と, その結果を書き込む位置 (毎周期再利用する)
+  std::vector<std::pair<action::with_planner*, std::size_t>> prepared_;
+  // 経路探索が必要な with_planner (毎周期再利用する)
+  std::vector<action::with_planner*> planning_;
+};
+
+} // namespace ai_server::game
+
+#endif // AI_SERVER_GAME_PLANNING_STAGE_H
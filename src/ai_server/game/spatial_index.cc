@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "spatial_index.h"
+
+namespace ai_server::game {
+
+namespace {
+
+// 等速で動く目標に，最高速度 s で向かうロボットが追いつくまでの時間
+// |d + v t| <= s t を満たす最小の t >= 0 (d: ロボットから見た目標の位置)
+std::optional<double> intercept_time(const Eigen::Vector2d& d, const Eigen::Vector2d& v,
+                                     double s) {
+  const double dd = d.squaredNorm();
+  if (dd == 0.0) return 0.0;
+  if (s <= 0.0) return std::nullopt;
+
+  // (|v|^2 - s^2) t^2 + 2 (d.v) t + |d|^2 = 0
+  const double a = v.squaredNorm() - s * s;
+  const double b = d.dot(v);
+  if (a == 0.0) {
+    // 目標とロボットの速さが等しいときは，近づいてくるときだけ追いつける
+    if (b >= 0.0) return std::nullopt;
+    return -dd / (2.0 * b);
+  }
+
+  const double disc = b * b - a * dd;
+  if (disc < 0.0) return std::nullopt;
+  const double sq = std::sqrt(disc);
+  // 2つの解のうち，0 以上で小さい方
+  const double t1 = (-b - sq) / a;
+  const double t2 = (-b + sq) / a;
+  const double t  = std::min(t1, t2) >= 0.0 ? std::min(t1, t2) : std::max(t1, t2);
+  if (t < 0.0) return std::nullopt;
+  return t;
+}
+
+// 点 p と線分 a-b の距離
+double distance_to_segment(const Eigen::Vector2d& p, const Eigen::Vector2d& a,
+                           const Eigen::Vector2d& b) {
+  const Eigen::Vector2d ab = b - a;
+  const double l2          = ab.squaredNorm();
+  const double t           = l2 > 0.0 ? std::clamp((p - a).dot(ab) / l2, 0.0, 1.0) : 0.0;
+  return (a + t * ab - p).norm();
+}
+
+} // namespace
+
+spatial_index::spatial_index(const model::world& world, model::team_color color) {
+  update(world, color);
+}
+
+void spatial_index::robots::assign(const model::world::robots_list& list) {
+  size = 0;
+  slots.fill(capacity);
+  for (const auto& [id, robot] : list) {
+    ids[size]       = id;
+    positions[size] = {robot.x(), robot.y()};
+    slots[id]       = size;
+    ++size;
+  }
+}
+
+void spatial_index::update(const model::world& world, model::team_color color) {
+  ours_.assign(model::our_robots(world, color));
+  enemies_.assign(model::enemy_robots(world, color));
+  const auto ball = world.ball();
+  ball_position_  = {ball.x(), ball.y()};
+  ball_velocity_  = {ball.vx(), ball.vy()};
+}
+
+const spatial_index::robots& spatial_index::get(team t) const {
+  return t == team::ours ? ours_ : enemies_;
+}
+
+std::size_t spatial_index::size(team t) const {
+  return get(t).size;
+}
+
+std::optional<Eigen::Vector2d> spatial_index::position(team t, unsigned int id) const {
+  const auto& r = get(t);
+  if (id >= capacity || r.slots[id] == capacity) return std::nullopt;
+  return r.positions[r.slots[id]];
+}
+
+const Eigen::Vector2d& spatial_index::ball_position() const {
+  return ball_position_;
+}
+
+const Eigen::Vector2d& spatial_index::ball_velocity() const {
+  return ball_velocity_;
+}
+
+std::optional<spatial_index::hit> spatial_index::nearest(team t,
+                                                         const Eigen::Vector2d& p) const {
+  const auto& r = get(t);
+  std::optional<hit> result;
+  for (std::size_t i = 0; i < r.size; ++i) {
+    const double d = (r.positions[i] - p).squaredNorm();
+    if (!result || d < result->value) result = hit{r.ids[i], d};
+  }
+  if (result) result->value = std::sqrt(result->value);
+  return result;
+}
+
+std::optional<spatial_index::hit> spatial_index::nearest(
+    team t, const Eigen::Vector2d& p, const std::vector<unsigned int>& candidates) const {
+  const auto& r = get(t);
+  std::optional<hit> result;
+  for (const auto id : candidates) {
+    if (id >= capacity || r.slots[id] == capacity) continue;
+    const double d = (r.positions[r.slots[id]] - p).squaredNorm();
+    if (!result || d < result->value) result = hit{id, d};
+  }
+  if (result) result->value = std::sqrt(result->value);
+  return result;
+}
+
+std::vector<spatial_index::hit> spatial_index::nearest_k(team t, const Eigen::Vector2d& p,
+                                                         std::size_t k) const {
+  auto result = within(t, p, std::numeric_limits<double>::infinity());
+  if (result.size() > k) result.resize(k);
+  return result;
+}
+
+std::vector<spatial_index::hit> spatial_index::within(team t, const Eigen::Vector2d& p,
+                                                      double radius) const {
+  const auto& r = get(t);
+  std::vector<hit> result;
+  result.reserve(r.size);
+  for (std::size_t i = 0; i < r.size; ++i) {
+    const double d = (r.positions[i] - p).norm();
+    if (d <= radius) result.push_back({r.ids[i], d});
+  }
+  // 距離が等しいときは ID の昇順
+  std::stable_sort(result.begin(), result.end(),
+                   [](const hit& a, const hit& b) { return a.value < b.value; });
+  return result;
+}
+
+std::optional<spatial_index::hit> spatial_index::closest_to_line(
+    team t, const Eigen::Vector2d& a, const Eigen::Vector2d& b) const {
+  const auto& r = get(t);
+  std::optional<hit> result;
+  for (std::size_t i = 0; i < r.size; ++i) {
+    const double d = distance_to_segment(r.positions[i], a, b);
+    if (!result || d < result->value) result = hit{r.ids[i], d};
+  }
+  return result;
+}
+
+std::optional<spatial_index::hit> spatial_index::time_to_intercept(
+    team t, const Eigen::Vector2d& target, const Eigen::Vector2d& velocity,
+    double max_speed) const {
+  const auto& r = get(t);
+  std::optional<hit> result;
+  for (std::size_t i = 0; i < r.size; ++i) {
+    const auto time = intercept_time(target - r.positions[i], velocity, max_speed);
+    if (time && (!result || *time < result->value)) result = hit{r.ids[i], *time};
+  }
+  return result;
+}
+
+std::optional<spatial_index::hit> spatial_index::time_to_intercept_ball(
+    team t, double max_speed) const {
+  return time_to_intercept(t, ball_position_, ball_velocity_, max_speed);
+}
+
+} // namespace ai_server::game
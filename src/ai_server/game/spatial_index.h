@@ -0,0 +1,118 @@
+#ifndef AI_SERVER_GAME_SPATIAL_INDEX_H
+#define AI_SERVER_GAME_SPATIAL_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include <Eigen/Core>
+
+#include "ai_server/model/team_color.h"
+#include "ai_server/model/world.h"
+
+namespace ai_server::game {
+
+/// @class   spatial_index
+/// @brief   1周期分の world から作る，ロボットとボールの位置に対する問い合わせ
+///
+/// 周期の始めに update() で両チームのロボットの位置を配列にまとめておき,
+/// agent や action が個別に model::our_robots(...) を取り出して std::hypot で
+/// 最も近いロボットを探していた処理を置き換える.
+/// ロボットは1チーム高々 model::world::max_robots 台なので, 各問い合わせは配列の走査で行う
+class spatial_index {
+public:
+  /// どちらのチームのロボットを調べるか
+  enum class team {
+    ours,    ///< 自チーム
+    enemies, ///< 敵チーム
+  };
+
+  /// 問い合わせの結果
+  struct hit {
+    unsigned int id; ///< ロボットのID
+    double value;    ///< 距離 [mm] (time_to_intercept() では時間 [s])
+  };
+
+  spatial_index() = default;
+
+  /// @param world            world model
+  /// @param color            自チームのチームカラー
+  spatial_index(const model::world& world, model::team_color color);
+
+  /// @brief                  world から作り直す (領域は確保しない)
+  /// @param world            world model
+  /// @param color            自チームのチームカラー
+  void update(const model::world& world, model::team_color color);
+
+  /// @brief                  ロボットの台数を取得する
+  std::size_t size(team t) const;
+
+  /// @brief                  ロボットの位置を取得する (見えていないときは std::nullopt)
+  std::optional<Eigen::Vector2d> position(team t, unsigned int id) const;
+
+  /// @brief                  ボールの位置を取得する
+  const Eigen::Vector2d& ball_position() const;
+
+  /// @brief                  ボールの速度を取得する
+  const Eigen::Vector2d& ball_velocity() const;
+
+  /// @brief                  p に最も近いロボットを探す
+  std::optional<hit> nearest(team t, const Eigen::Vector2d& p) const;
+
+  /// @brief                  candidates のうち p に最も近いロボットを探す
+  ///
+  /// 距離が等しいときは candidates で先に現れるものを返す.
+  /// 見えていないロボットの ID は無視する
+  std::optional<hit> nearest(team t, const Eigen::Vector2d& p,
+                             const std::vector<unsigned int>& candidates) const;
+
+  /// @brief                  p に近い順に k 台までのロボットを返す
+  std::vector<hit> nearest_k(team t, const Eigen::Vector2d& p, std::size_t k) const;
+
+  /// @brief                  p から radius 以内にいるロボットを近い順に返す
+  std::vector<hit> within(team t, const Eigen::Vector2d& p, double radius) const;
+
+  /// @brief                  線分 a-b に最も近いロボットを探す (パスコースを塞ぐロボットなど)
+  std::optional<hit> closest_to_line(team t, const Eigen::Vector2d& a,
+                                     const Eigen::Vector2d& b) const;
+
+  /// @brief                  等速で動く目標に最も早く追いつけるロボットを探す
+  /// @param target           目標の現在位置
+  /// @param velocity         目標の速度
+  /// @param max_speed        ロボットの最高速度 [mm/s]
+  /// @return                 追いつくまでの時間が最も短いロボット (誰も追いつけないときは nullopt)
+  std::optional<hit> time_to_intercept(team t, const Eigen::Vector2d& target,
+                                       const Eigen::Vector2d& velocity, double max_speed) const;
+
+  /// @brief                  ボールに最も早く追いつけるロボットを探す
+  std::optional<hit> time_to_intercept_ball(team t, double max_speed) const;
+
+private:
+  static constexpr std::size_t capacity = model::world::max_robots;
+
+  // 1チーム分のロボット (見えているものを ID の昇順に詰めて並べる)
+  struct robots {
+    std::size_t size = 0;
+    std::array<unsigned int, capacity> ids;
+    std::array<Eigen::Vector2d, capacity> positions;
+    // ID から配列の添字へ (見えていないときは capacity)
+    std::array<std::size_t, capacity> slots;
+
+    robots() {
+      slots.fill(capacity);
+    }
+
+    void assign(const model::world::robots_list& list);
+  };
+
+  const robots& get(team t) const;
+
+  robots ours_;
+  robots enemies_;
+  Eigen::Vector2d ball_position_ = Eigen::Vector2d::Zero();
+  Eigen::Vector2d ball_velocity_ = Eigen::Vector2d::Zero();
+};
+
+} // namespace ai_server::game
+
+#endif // AI_SERVER_GAME_SPATIAL_INDEX_H
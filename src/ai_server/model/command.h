@@ -105,7 +105,7 @@ public:
     motion_ = motion;
   }
 
-  std::shared_ptr<model::motion::base> motion() {
+  const std::shared_ptr<model::motion::base>& motion() const {
     return motion_;
   }
 
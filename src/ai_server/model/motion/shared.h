@@ -0,0 +1,24 @@
+#ifndef AI_SERVER_MODEL_MOTION_SHARED_H
+#define AI_SERVER_MODEL_MOTION_SHARED_H
+
+#include <memory>
+#include <type_traits>
+
+#include "base.h"
+
+namespace ai_server::model::motion {
+
+/// @brief   動作 T の共有インスタンスを取得する
+///
+/// 動作は状態を持たないので, プロセス内で1つのインスタンスを使い回す.
+/// 命令を作る度に std::make_shared<T>() で確保する代わりに command::set_motion() に渡す
+template <class T>
+const std::shared_ptr<base>& shared() {
+  static_assert(std::is_base_of_v<base, T>, "T must be derived from motion::base");
+  static const std::shared_ptr<base> instance = std::make_shared<T>();
+  return instance;
+}
+
+} // namespace ai_server::model::motion
+
+#endif // AI_SERVER_MODEL_MOTION_SHARED_H
@@ -1,7 +1,10 @@
 #ifndef AI_SERVER_MODEL_OBSTACLE_FIELD_H
 #define AI_SERVER_MODEL_OBSTACLE_FIELD_H
 
+#include <memory>
+
 #include "ai_server/model/field.h"
+#include "ai_server/planner/detail/distance_field.h"
 #include "box.h"
 #include "point.h"
 
@@ -39,6 +42,24 @@ static inline obstacle::box enemy_penalty_area(const model::field& field, double
            {field.x_max() + over_length, field.penalty_y_max()}},
           margin};
 }
+/// @brief 自陣側と敵陣側のペナルティエリアの距離場を取得する
+///
+/// フィールドの形状と margin が同じであれば，前回作ったものを共有する
+/// @param field フィールドの情報
+/// @param margin ペナリティエリアのマージン
+/// @return planner::obstacle_list::set_static() に渡す距離場
+static inline std::shared_ptr<const planner::detail::distance_field> penalty_areas(
+    const model::field& field, double margin) {
+  // 格子を作る範囲のフィールドからの広さと，格子の間隔
+  constexpr double padding    = 1000.0;
+  constexpr double resolution = 10.0;
+
+  const planner::detail::envelope_type area{
+      {field.x_min() - padding, field.y_min() - padding},
+      {field.x_max() + padding, field.y_max() + padding}};
+  return planner::detail::distance_field::cached(
+      area, resolution, {our_penalty_area(field, margin), enemy_penalty_area(field, margin)});
+}
 } // namespace ai_server::model::obstacle
 
 #endif
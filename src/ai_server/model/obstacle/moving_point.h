@@ -0,0 +1,17 @@
+#ifndef AI_SERVER_MODEL_OBSTACLE_MOVING_POINT_H
+#define AI_SERVER_MODEL_OBSTACLE_MOVING_POINT_H
+
+#include <Eigen/Core>
+
+namespace ai_server::model::obstacle {
+/// 等速直線運動をしていると見なす点 (移動するロボットなど)
+struct moving_point {
+  using geometry_type = Eigen::Vector2d;
+
+  geometry_type geometry; // 現在位置
+  Eigen::Vector2d velocity;
+  double margin;
+};
+} // namespace ai_server::model::obstacle
+
+#endif
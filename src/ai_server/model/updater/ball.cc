@@ -9,13 +9,17 @@ namespace ai_server {
 namespace model {
 namespace updater {
 
-ball::ball() : ball_{}, affine_{Eigen::Translation3d{.0, .0, .0}} {}
+ball::ball() : ball_{}, generation_{0}, affine_{Eigen::Translation3d{.0, .0, .0}} {}
 
 model::ball ball::value() const {
   std::unique_lock lock(mutex_);
   return ball_;
 }
 
+std::uint64_t ball::generation() const {
+  return generation_;
+}
+
 void ball::set_transformation_matrix(const Eigen::Affine3d& matrix) {
   std::unique_lock lock(mutex_);
   affine_ = matrix;
@@ -30,16 +34,43 @@ void ball::update(const ssl_protos::vision::Frame& detection) {
   const auto captured_time =
       std::chrono::system_clock::time_point{util::to_duration(detection.t_capture())};
 
+  // 扱えるIDの範囲外のカメラで検出されたものは無視する
+  if (camera_id >= raw_balls_.capacity()) return;
+
+  if (tracker_) {
+    // トラッカーが設定されていたら, 検出された全てのボールを渡して最も確からしいものを使う
+    observations_.clear();
+    for (const auto& b : detection.balls()) {
+      observations_.push_back(
+          {util::math::transform(affine_, model::ball{b.x(), b.y(), b.z()}), b.confidence()});
+    }
+    tracker_->update(observations_, captured_time);
+
+    // 最も確からしいトラックがこのフレームで観測されたときだけ値を更新する
+    // (他のカメラのフレームで同じ値を新しい時刻として渡すと, Filter が求める速度が小さくなる)
+    if (const auto best = tracker_->best_track(); !best) {
+      apply(std::nullopt, captured_time);
+    } else if (best->last_seen == captured_time) {
+      apply(best->ball, captured_time);
+    }
+
+    ++generation_;
+    return;
+  }
+
   // 検出されたボールの中から, 最もconfidenceの高い値を選択候補に登録する
   // FIXME:
-  // 現在の実装は, フィールドにボールが1つしかないと仮定している
+  // この方法は, フィールドにボールが1つしかないと仮定している
   // 1つのカメラで複数のボールが検出された場合, 意図しないデータが選択される可能性がある
+  // (誤検出が問題になる場合は set_tracker() でトラッカーを使う)
   const auto& balls    = detection.balls();
   const auto candidate = std::max_element(balls.cbegin(), balls.cend(), [](auto& a, auto& b) {
     return a.confidence() < b.confidence();
   });
   if (candidate != balls.cend()) {
-    raw_balls_[camera_id] = *candidate;
+    raw_balls_.insert_or_assign(
+        camera_id,
+        ball_detection{candidate->x(), candidate->y(), candidate->z(), candidate->confidence()});
   } else {
     raw_balls_.erase(camera_id);
   }
@@ -47,35 +78,44 @@ void ball::update(const ssl_protos::vision::Frame& detection) {
   // 候補の中から, 最もconfidenceの高いボールを求める
   const auto reliable =
       std::max_element(raw_balls_.cbegin(), raw_balls_.cend(), [](auto& a, auto& b) {
-        return std::get<1>(a).confidence() < std::get<1>(b).confidence();
+        return std::get<1>(a).confidence < std::get<1>(b).confidence;
       });
 
   if (reliable != raw_balls_.cend()) {
     // 選択された値のカメラIDとdetectionのカメラIDが一致していたらデータを更新する
     if (std::get<0>(*reliable) == camera_id) {
-      const auto value = util::math::transform(affine_, [reliable] {
-        const auto& r = std::get<1>(*reliable);
-        return model::ball{r.x(), r.y(), r.z()};
-      }());
-
-      if (filter_same_) {
-        // filter_same_が設定されていたらFilterを通した値を使う
-        if (auto v = filter_same_->update(value, captured_time); v.has_value()) {
-          ball_ = std::move(*v);
-          ball_.set_is_lost(false);
-        } else {
-          ball_.set_is_lost(true);
-        }
-      } else if (filter_manual_) {
-        // filter_manual_が設定されていたら観測値を通知する
-        filter_manual_->set_raw_value(value, captured_time);
-      } else {
-        // Filterが登録されていない場合はそのままの値を使う
-        ball_.set_x(value.x());
-        ball_.set_y(value.y());
-        ball_.set_z(value.z());
+      const auto& r = std::get<1>(*reliable);
+      apply(util::math::transform(affine_, model::ball{r.x, r.y, r.z}), captured_time);
+    }
+  } else {
+    apply(std::nullopt, captured_time);
+  }
+
+  ++generation_;
+}
+
+void ball::apply(std::optional<model::ball> value,
+                 std::chrono::system_clock::time_point captured_time) {
+  if (value) {
+    if (filter_same_) {
+      // filter_same_が設定されていたらFilterを通した値を使う
+      if (auto v = filter_same_->update(value, captured_time); v.has_value()) {
+        ball_ = std::move(*v);
         ball_.set_is_lost(false);
+      } else {
+        ball_.set_is_lost(true);
       }
+    } else if (filter_manual_) {
+      // filter_manual_が設定されていたら観測値を通知する
+      filter_manual_->set_raw_value(value, captured_time);
+    } else {
+      // Filterが登録されていない場合はそのままの値を使う
+      ball_.set_x(value->x());
+      ball_.set_y(value->y());
+      ball_.set_z(value->z());
+      ball_.set_vx(value->vx());
+      ball_.set_vy(value->vy());
+      ball_.set_is_lost(false);
     }
   } else {
     // Filter が設定されていたらロストしたことを通知する
@@ -94,6 +134,16 @@ void ball::update(const ssl_protos::vision::Frame& detection) {
   }
 }
 
+void ball::clear_tracker() {
+  std::unique_lock lock(mutex_);
+  tracker_.reset();
+}
+
+std::vector<filter::ball_tracker::track> ball::tracks() const {
+  std::unique_lock lock(mutex_);
+  return tracker_ ? tracker_->tracks() : std::vector<filter::ball_tracker::track>{};
+}
+
 void ball::clear_filter() {
   std::unique_lock lock(mutex_);
   filter_same_.reset();
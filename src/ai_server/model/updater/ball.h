@@ -1,16 +1,22 @@
 #ifndef AI_SERVER_MODEL_UPDATER_BALL_H
 #define AI_SERVER_MODEL_UPDATER_BALL_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include <Eigen/Geometry>
 
+#include "ai_server/filter/ball_tracker.h"
 #include "ai_server/filter/base.h"
 #include "ai_server/model/ball.h"
+#include "detection.h"
 #include "ssl-protos/vision_detection.pb.h"
 
 namespace ai_server {
@@ -38,10 +44,34 @@ public:
   /// @brief           値を取得する
   model::ball value() const;
 
+  /// @brief           値が更新されるたびに増加するカウンタを取得する
+  std::uint64_t generation() const;
+
   /// @brief           updaterに変換行列を設定する
   /// @param matrix    変換行列
   void set_transformation_matrix(const Eigen::Affine3d& matrix);
 
+  /// @brief           複数のボールの候補を追跡するトラッカーを設定する
+  /// @param args      filter::ball_tracker のコンストラクタの引数
+  ///
+  /// トラッカーが設定されている間は, 各カメラで検出された全てのボールをトラッカーに渡し,
+  /// 最もスコアの高い候補がそのフレームで観測されていれば, その値を使う.
+  /// Filterが設定されていればその値をFilterに通す
+  template <class... Args>
+  void set_tracker(Args&&... args) {
+    std::unique_lock lock(mutex_);
+    tracker_.emplace(std::forward<Args>(args)...);
+  }
+
+  /// @brief           設定されたトラッカーを解除する
+  void clear_tracker();
+
+  /// @brief           トラッカーが追跡している候補をスコアの高い順に取得する
+  ///
+  /// 先頭の要素が value() に使われている候補で, 残りはそれ以外の候補となる.
+  /// トラッカーが設定されていなければ空のリストを返す
+  std::vector<filter::ball_tracker::track> tracks() const;
+
   /// @brief           設定されたFilterを解除する
   void clear_filter();
 
@@ -78,6 +108,7 @@ public:
           } else {
             ball_.set_is_lost(true);
           }
+          ++generation_;
         },
         // 残りの引数
         std::forward<Args>(args)...);
@@ -86,13 +117,25 @@ public:
   }
 
 private:
+  /// @brief           選ばれた値をFilterに通して ball_ を更新する
+  /// @param value     選ばれた値 (ボールが検出されなかった場合は nullopt)
+  void apply(std::optional<model::ball> value,
+             std::chrono::system_clock::time_point captured_time);
+
   mutable std::recursive_mutex mutex_;
 
   /// 最終的な値
   model::ball ball_;
+  /// ball_ が更新された回数
+  std::atomic<std::uint64_t> generation_;
+
+  /// 各カメラで検出されたボールの生データ (KeyはカメラID)
+  per_camera<ball_detection> raw_balls_;
 
-  /// 各カメラで検出されたボールの生データ
-  std::unordered_map<unsigned int, ssl_protos::vision::Ball> raw_balls_;
+  /// 複数のボールの候補を追跡するトラッカー
+  std::optional<filter::ball_tracker> tracker_;
+  /// トラッカーに渡す観測値 (毎フレームの確保を避けるため使い回す)
+  std::vector<filter::ball_tracker::observation> observations_;
 
   /// 更新タイミングがsameなFilter
   std::shared_ptr<filter_same_type> filter_same_;
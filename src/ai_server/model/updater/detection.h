@@ -0,0 +1,35 @@
+#ifndef AI_SERVER_MODEL_UPDATER_DETECTION_H
+#define AI_SERVER_MODEL_UPDATER_DETECTION_H
+
+#include <cstddef>
+
+#include "ai_server/util/fixed_map.h"
+
+namespace ai_server::model::updater {
+
+/// 扱えるカメラ ID の上限 (これ以上の ID のカメラからの Detection は無視される)
+inline constexpr std::size_t max_cameras = 16;
+
+/// SSL-Vision で検出されたロボットの生データ
+struct robot_detection {
+  double x;
+  double y;
+  double theta;
+  double confidence;
+};
+
+/// SSL-Vision で検出されたボールの生データ
+struct ball_detection {
+  double x;
+  double y;
+  double z;
+  double confidence;
+};
+
+/// KeyがカメラIDの固定長の連想配列
+template <class T>
+using per_camera = util::fixed_map<T, max_cameras>;
+
+} // namespace ai_server::model::updater
+
+#endif // AI_SERVER_MODEL_UPDATER_DETECTION_H
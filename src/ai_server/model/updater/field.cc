@@ -7,7 +7,7 @@ namespace ai_server {
 namespace model {
 namespace updater {
 
-field::field() : field_{} {}
+field::field() : field_{}, generation_{0} {}
 
 void field::update(const ssl_protos::vision::Geometry& geometry) {
   std::unique_lock<std::shared_timed_mutex> lock(mutex_);
@@ -31,6 +31,8 @@ void field::update(const ssl_protos::vision::Geometry& geometry) {
       field_.set_penalty_length(line.p2().x() - line.p1().x());
     }
   }
+
+  ++generation_;
 }
 
 model::field field::value() const {
@@ -38,6 +40,10 @@ model::field field::value() const {
   return field_;
 }
 
+std::uint64_t field::generation() const {
+  return generation_;
+}
+
 } // namespace updater
 } // namespace model
 } // namespace ai_server
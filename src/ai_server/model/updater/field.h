@@ -1,6 +1,8 @@
 #ifndef AI_SERVER_MODEL_UPDATER_FIELD_H
 #define AI_SERVER_MODEL_UPDATER_FIELD_H
 
+#include <atomic>
+#include <cstdint>
 #include <shared_mutex>
 #include "ai_server/model/field.h"
 
@@ -20,6 +22,8 @@ namespace updater {
 class field {
   mutable std::shared_timed_mutex mutex_;
   model::field field_;
+  /// field_ が更新された回数
+  std::atomic<std::uint64_t> generation_;
 
 public:
   field();
@@ -33,6 +37,9 @@ public:
 
   /// @brief          値を取得する
   model::field value() const;
+
+  /// @brief          値が更新されるたびに増加するカウンタを取得する
+  std::uint64_t generation() const;
 };
 
 } // namespace updater
@@ -2,6 +2,8 @@
 #define AI_SERVER_MODEL_WORLD_UPDATER_ROBOT_IMPL_H
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 
 #include "ai_server/util/math/affine.h"
 #include "ai_server/util/time.h"
@@ -23,7 +25,10 @@ const robot<model::team_color::yellow>::source_function_pointer_type
     robot<model::team_color::yellow>::src_ = &ssl_protos::vision::Frame::robots_yellow;
 
 template <model::team_color Color>
-robot<Color>::robot() : affine_{Eigen::Translation3d{.0, .0, .0}} {}
+robot<Color>::robot()
+    : generation_{0},
+      fusion_window_{std::chrono::system_clock::duration::zero()},
+      affine_{Eigen::Translation3d{.0, .0, .0}} {}
 
 template <model::team_color Color>
 void robot<Color>::update(const ssl_protos::vision::Frame& detection) {
@@ -35,90 +40,76 @@ void robot<Color>::update(const ssl_protos::vision::Frame& detection) {
   const auto captured_time =
       std::chrono::system_clock::time_point{util::to_duration(detection.t_capture())};
 
-  // 保持している生データを更新する
-  raw_robots_[camera_id] = (detection.*src_)();
-
-  // カメラIDをKeyに, 各カメラで検出されたロボットの情報を保持しているraw_robots_から
-  // | Key(cam_id) | Value({Robot})           |
-  // | ----------- | ------------------------ |
-  // |           0 | {Robot(ID0), Robot(ID1)} |
-  // |           1 | {Robot(ID1), Robot(ID2)} |
-  // ロボットIDをKeyに,
-  // 1つ以上のロボットの情報をカメラIDとともに保持するハッシュテーブルを作る
-  // | Key(robo_id)  | Value({cam_id, Robot})                       |
-  // | ------------- | -------------------------------------------- |
-  // |             0 | {{cam_id, Robot(ID0)}}                       |
-  // |             1 | {{cam_id, Robot(ID1)}, {cam_id, Robot(ID1)}} |
-  // |             2 | {{cam_id, Robot(ID2)}}                       |
-  const auto candidates = [this] {
-    using robot_with_camera_id = std::tuple<unsigned int, raw_data_array_type::const_iterator>;
-    std::unordered_multimap<unsigned int, robot_with_camera_id> table{};
-    for (auto it1 = raw_robots_.cbegin(); it1 != raw_robots_.cend(); ++it1) {
-      const auto& robots_list = it1->second;
-      for (auto it2 = robots_list.cbegin(); it2 != robots_list.cend(); ++it2) {
-        table.emplace(it2->robot_id(), std::forward_as_tuple(it1->first, it2));
-      }
+  // 扱えるIDの範囲外のカメラで検出されたものは無視する
+  if (camera_id >= max_cameras) return;
+
+  captured_times_.insert_or_assign(camera_id, captured_time);
+
+  // 各IDのスロットのうち, このカメラの分だけを更新する
+  // 同じカメラで同じIDのロボットが複数検出されたときはconfidenceの高いほうを残す
+  for (auto& slots : raw_robots_) slots.erase(camera_id);
+  for (const auto& r : (detection.*src_)()) {
+    // 扱えるIDの範囲外のロボットは無視する
+    if (r.robot_id() >= robots_list_type::capacity()) continue;
+    auto& slots = raw_robots_[r.robot_id()];
+    if (const auto it = slots.find(camera_id);
+        it == slots.end() || it->second.confidence < r.confidence()) {
+      slots.insert_or_assign(camera_id,
+                             robot_detection{r.x(), r.y(), r.orientation(), r.confidence()});
     }
-    return table;
-  }();
-
-  // 作ったハッシュテーブルから, 各IDの最もconfidenceの高い要素を選択して値の更新を行う
-  robots_list_type reliables{};
-  for (auto it = candidates.cbegin(); it != candidates.cend();) {
-    const auto robot_id = it->first;
-
-    // IDがrobot_idのロボットの中で, 最もconfidenceの高い値を選択する
-    const auto range    = candidates.equal_range(robot_id);
-    const auto reliable = std::max_element(range.first, range.second, [](auto& a, auto& b) {
-      return std::get<1>(a.second)->confidence() < std::get<1>(b.second)->confidence();
-    });
-
-    // その値が検出されたカメラIDとdetectionのカメラIDを比較
-    if (std::get<0>(reliable->second) == camera_id) {
-      // 一致していたら値の更新を行う
+  }
+
+  // このカメラで検出されたIDについて値の更新を行う
+  // (他のカメラでのみ検出されたIDは前の値を引き継ぐ)
+  for (unsigned int robot_id = 0; robot_id < robots_list_type::capacity(); ++robot_id) {
+    const auto& slots = raw_robots_[robot_id];
+    if (!slots.contains(camera_id)) continue;
+
+    std::optional<model::robot> observed{};
+    if (fusion_window_ > std::chrono::system_clock::duration::zero()) {
+      // 各カメラの値を confidence と経過時間で重み付けして統合する
+      observed = fuse(slots, captured_time);
+    } else if (const auto reliable = std::max_element(
+                   slots.cbegin(), slots.cend(),
+                   [](auto& a, auto& b) { return a.second.confidence < b.second.confidence; });
+               reliable->first == camera_id) {
+      // 最もconfidenceの高い値が現在のカメラで検出されたものであれば更新を行う
       // (現在のカメラで新たに検出された or
       // 現在のカメラで検出された値のほうがconfidenceが高かった)
-      const auto value    = util::math::transform(affine_, [reliable] {
-        const auto r = std::get<1>(reliable->second);
-        return model::robot{r->x(), r->y(), r->orientation()};
-      }());
-      reliables[robot_id] = value;
-
-      // 2つのFilterが設定されておらず, かつfilter_initializer_が設定されていたら
-      // filter_initializer_でFilterを初期化する
-      if (filter_initializer_ && !filters_same_.count(robot_id) &&
-          !filters_manual_.count(robot_id)) {
-        filters_same_[robot_id] = filter_initializer_();
-      }
+      const auto& r = reliable->second;
+      observed      = model::robot{r.x, r.y, r.theta};
+    }
+    if (!observed) continue;
 
-      if (auto f = filters_same_.find(robot_id); f != filters_same_.end()) {
-        // `timing::same` なFilterが設定されていたらFilterを通した値を使う
-        if (auto v = f->second->update(value, captured_time); v.has_value()) {
-          robots_[robot_id] = std::move(*v);
-        } else {
-          robots_.erase(robot_id);
-        }
-      } else if (auto f = filters_manual_.find(robot_id); f != filters_manual_.end()) {
-        // `timing::manual` なFilterが設定されていたら観測値を通知する
-        f->second->set_raw_value(value, captured_time);
+    const auto value = util::math::transform(affine_, *observed);
+
+    // 2つのFilterが設定されておらず, かつfilter_initializer_が設定されていたら
+    // filter_initializer_でFilterを初期化する
+    if (filter_initializer_ && !filters_same_.count(robot_id) &&
+        !filters_manual_.count(robot_id)) {
+      filters_same_[robot_id] = filter_initializer_();
+    }
+
+    if (auto f = filters_same_.find(robot_id); f != filters_same_.end()) {
+      // `timing::same` なFilterが設定されていたらFilterを通した値を使う
+      if (auto v = f->second->update(value, captured_time); v.has_value()) {
+        robots_[robot_id] = std::move(*v);
       } else {
-        // Filterが登録されていない場合はそのままの値を使う
-        robots_[robot_id] = value;
+        robots_.erase(robot_id);
       }
+    } else if (auto f = filters_manual_.find(robot_id); f != filters_manual_.end()) {
+      // `timing::manual` なFilterが設定されていたら観測値を通知する
+      f->second->set_raw_value(value, captured_time);
     } else {
-      // カメラIDが一致しないときは前の値を引き継ぐ
-      // (現在のカメラで検出されたがconfidenceが低かった or 現在のカメラで検出されなかった)
-      reliables[robot_id] = reliable_robots_.at(robot_id);
+      // Filterが登録されていない場合はそのままの値を使う
+      robots_[robot_id] = value;
     }
-
-    // イテレータを次のロボットIDの位置まで進める
-    it = range.second;
   }
 
   // 最終的なデータのリストから, フィールド全体で検出されなかったIDを取り除く
   for (auto it = robots_.begin(); it != robots_.end();) {
     const auto id = it->first;
-    if (reliables.count(id)) {
+    if (!raw_robots_[id].empty()) {
       ++it;
     } else {
       // Filter が設定されていたらロストしたことを通知する
@@ -138,7 +129,50 @@ void robot<Color>::update(const ssl_protos::vision::Frame& detection) {
     }
   }
 
-  reliable_robots_ = std::move(reliables);
+  ++generation_;
+}
+
+template <model::team_color Color>
+model::robot robot<Color>::fuse(const per_camera<robot_detection>& slots,
+                                std::chrono::system_clock::time_point time) const {
+  using duration = std::chrono::duration<double>;
+  const auto window = std::chrono::duration_cast<duration>(fusion_window_).count();
+
+  double sw = 0.0, sx = 0.0, sy = 0.0, ss = 0.0, sc = 0.0;
+  for (const auto& [cam_id, r] : slots) {
+    // 新しい値ほど重くし, fusion_window_ 以上前の値は使わない
+    const auto age =
+        std::max(std::chrono::duration_cast<duration>(time - captured_times_.at(cam_id)).count(),
+                 0.0);
+    if (age >= window) continue;
+
+    const auto w = r.confidence * (1.0 - age / window);
+    sw += w;
+    sx += w * r.x;
+    sy += w * r.y;
+    // 角度は単位ベクトルの重み付き和から求める
+    ss += w * std::sin(r.theta);
+    sc += w * std::cos(r.theta);
+  }
+
+  // 重みがつかなかったとき (confidence が全て 0 など) は単純な平均を使う
+  if (sw <= 0.0) {
+    for (const auto& [cam_id, r] : slots) {
+      sw += 1.0;
+      sx += r.x;
+      sy += r.y;
+      ss += std::sin(r.theta);
+      sc += std::cos(r.theta);
+    }
+  }
+
+  return {sx / sw, sy / sw, std::atan2(ss, sc)};
+}
+
+template <model::team_color Color>
+void robot<Color>::set_fusion_window(std::chrono::system_clock::duration window) {
+  std::unique_lock lock(mutex_);
+  fusion_window_ = window;
 }
 
 template <model::team_color Color>
@@ -147,6 +181,11 @@ typename robot<Color>::robots_list_type robot<Color>::value() const {
   return robots_;
 }
 
+template <model::team_color Color>
+std::uint64_t robot<Color>::generation() const {
+  return generation_;
+}
+
 template <model::team_color Color>
 void robot<Color>::set_transformation_matrix(const Eigen::Affine3d& matrix) {
   std::unique_lock lock(mutex_);
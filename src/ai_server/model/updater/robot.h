@@ -1,6 +1,10 @@
 #ifndef AI_SERVER_MODEL_UPDATER_ROBOT_H
 #define AI_SERVER_MODEL_UPDATER_ROBOT_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -13,6 +17,8 @@
 #include "ai_server/filter/base.h"
 #include "ai_server/model/robot.h"
 #include "ai_server/model/team_color.h"
+#include "ai_server/model/world.h"
+#include "detection.h"
 #include "ssl-protos/vision_detection.pb.h"
 
 namespace ai_server {
@@ -23,13 +29,11 @@ namespace updater {
 /// @brief   SSL-VisionのDetectionパケットでロボットの情報を更新する
 template <model::team_color Color>
 class robot {
-  /// KeyがID, Valueがロボットのハッシュテーブルの型
-  using robots_list_type = std::unordered_map<unsigned int, model::robot>;
+  /// KeyがID, Valueがロボットの連想配列の型
+  using robots_list_type = model::world::robots_list;
 
-  /// 生データの型
-  using raw_data_type = ssl_protos::vision::Robot;
   /// 生データが格納されている配列の型
-  using raw_data_array_type = google::protobuf::RepeatedPtrField<raw_data_type>;
+  using raw_data_array_type = google::protobuf::RepeatedPtrField<ssl_protos::vision::Robot>;
   /// ロボットの生データを取得するFrameのメンバ関数へのポインタの型
   using source_function_pointer_type =
       const raw_data_array_type& (ssl_protos::vision::Frame::*)() const;
@@ -51,10 +55,21 @@ public:
   /// @brief           値を取得する
   robots_list_type value() const;
 
+  /// @brief           値が更新されるたびに増加するカウンタを取得する
+  std::uint64_t generation() const;
+
   /// @brief           updaterに変換行列を設定する
   /// @param matrix    変換行列
   void set_transformation_matrix(const Eigen::Affine3d& matrix);
 
+  /// @brief           複数のカメラで検出された値を統合する時間幅を設定する
+  /// @param window    統合に使う値の, 最新の値からの経過時間の上限
+  ///
+  /// 0 (デフォルト) のときは最もconfidenceの高いカメラの値のみを使う.
+  /// 正の値を設定すると, 現在のカメラで検出されたロボットの値を
+  /// window 以内に各カメラで検出された値の confidence と経過時間による重み付き平均とする
+  void set_fusion_window(std::chrono::system_clock::duration window);
+
   /// @brief           設定されたFilterを解除する
   /// @param id        Filterを解除するロボットのID
   void clear_filter(unsigned int id);
@@ -104,6 +119,7 @@ public:
             // valueが値を持っていなかった場合はリストから要素を削除する
             robots_.erase(id);
           }
+          ++generation_;
         },
         // 残りの引数
         std::forward<Args>(args)...);
@@ -124,6 +140,12 @@ public:
   }
 
 private:
+  /// @brief           各カメラで検出された値を統合する
+  /// @param slots     1台のロボットの, 各カメラで検出された値
+  /// @param time      現在のカメラでキャプチャされた時刻
+  model::robot fuse(const per_camera<robot_detection>& slots,
+                    std::chrono::system_clock::time_point time) const;
+
   mutable std::recursive_mutex mutex_;
 
   /// ロボットの生データを取得するFrameのメンバ関数へのポインタ
@@ -132,11 +154,15 @@ private:
 
   /// 最終的な値
   robots_list_type robots_;
-
-  /// 各カメラで検出されたロボットの生データ (KeyはカメラID)
-  std::unordered_map<unsigned int, raw_data_array_type> raw_robots_;
-  /// 検出された中から選ばれた, 各IDをの最も確かとされる値のリスト
-  robots_list_type reliable_robots_;
+  /// robots_ が更新された回数
+  std::atomic<std::uint64_t> generation_;
+
+  /// 各カメラで検出されたロボットの生データ (添字はロボットID)
+  std::array<per_camera<robot_detection>, robots_list_type::capacity()> raw_robots_;
+  /// 各カメラで最後にキャプチャされた時刻
+  per_camera<std::chrono::system_clock::time_point> captured_times_;
+  /// 複数のカメラで検出された値を統合する時間幅
+  std::chrono::system_clock::duration fusion_window_;
 
   /// 更新タイミングがsameなFilter
   std::unordered_map<unsigned int, std::shared_ptr<filters_same_type>> filters_same_;
@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "ai_server/util/math/affine.h"
+#include "ai_server/util/time.h"
 #include "world.h"
 #include "ssl-protos/vision_wrapper.pb.h"
 
@@ -6,7 +9,15 @@ namespace ai_server {
 namespace model {
 namespace updater {
 
+world::world() : snapshot_generation_{0}, frame_count_{0} {
+  publish();
+}
+
 void world::update(const ssl_protos::vision::Packet& packet) {
+  // receiver::vision は受信したスレッドで直ちに呼び出すので, これを受信時刻とする
+  const auto received_time = std::chrono::system_clock::now();
+  bool completed           = false;
+
   if (packet.has_detection()) {
     const auto& detection = packet.detection();
 
@@ -16,16 +27,98 @@ void world::update(const ssl_protos::vision::Packet& packet) {
     ball_.update(detection);
     robots_blue_.update(detection);
     robots_yellow_.update(detection);
+
+    completed = track_frame(
+        detection.camera_id(),
+        std::chrono::system_clock::time_point{util::to_duration(detection.t_capture())});
   }
 
   if (packet.has_geometry()) {
     const auto& geometry = packet.geometry();
     field_.update(geometry);
   }
+
+  publish();
+
+  // snapshot() に反映してから通知する
+  if (completed) {
+    {
+      std::lock_guard lock{last_frame_mutex_};
+      last_frame_           = {};
+      last_frame_.frame     = frame_count_;
+      last_frame_.captured  = frame_time_;
+      last_frame_.received  = received_time;
+      last_frame_.published = std::chrono::system_clock::now();
+    }
+    frame_completed_(frame_time_);
+  }
+}
+
+bool world::track_frame(unsigned int camera_id,
+                        std::chrono::system_clock::time_point captured_time) {
+  if (camera_id >= max_cameras) return false;
+
+  bool completed = false;
+  if (received_cameras_.test(camera_id)) {
+    // 揃う前に同じカメラから次の検出結果が届いた
+    // 届かなかったカメラは無効化されたか見えなくなったものとして, ここまでを1フレームとする
+    frame_cameras_ = received_cameras_;
+    received_cameras_.reset();
+    completed = true;
+  }
+  received_cameras_.set(camera_id);
+  frame_time_ = completed ? captured_time : std::max(frame_time_, captured_time);
+
+  if (!completed && frame_cameras_.any() && (frame_cameras_ & ~received_cameras_).none()) {
+    // 前のフレームを構成した全てのカメラから届いた
+    frame_cameras_ = received_cameras_;
+    received_cameras_.reset();
+    completed = true;
+  }
+
+  if (completed) ++frame_count_;
+  return completed;
+}
+
+std::uint64_t world::frame_count() const {
+  return frame_count_;
+}
+
+trace::frame_timestamps world::last_frame() const {
+  std::lock_guard lock{last_frame_mutex_};
+  return last_frame_;
+}
+
+boost::signals2::connection world::on_frame_completed(
+    const frame_signal_type::slot_type& slot) {
+  return frame_completed_.connect(slot);
 }
 
 model::world world::value() const {
-  return {field_.value(), ball_.value(), robots_blue_.value(), robots_yellow_.value()};
+  return *snapshot();
+}
+
+std::shared_ptr<const model::world> world::snapshot() const {
+  // manual な Filter などによって update() 以外で値が更新されていたら作り直す
+  if (snapshot_generation_ != generation()) publish();
+  return std::atomic_load(&snapshot_);
+}
+
+std::uint64_t world::generation() const {
+  return field_.generation() + ball_.generation() + robots_blue_.generation() +
+         robots_yellow_.generation();
+}
+
+void world::publish() const {
+  std::lock_guard lock{snapshot_mutex_};
+
+  // 値を取得する前の世代を記録しておく
+  // (取得中に更新された場合は次の snapshot() で再度作り直される)
+  const auto g = generation();
+  std::atomic_store(&snapshot_, std::make_shared<const model::world>(
+                                    field_.value(), ball_.value(), robots_blue_.value(),
+                                    robots_yellow_.value()));
+  snapshot_generation_ = g;
 }
 
 void world::set_transformation_matrix(const Eigen::Affine3d& matrix) {
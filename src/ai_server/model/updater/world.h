@@ -1,12 +1,20 @@
 #ifndef AI_SERVER_MODEL_UPDATER_WORLD_H
 #define AI_SERVER_MODEL_UPDATER_WORLD_H
 
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <set>
+#include <boost/signals2.hpp>
 #include <Eigen/Geometry>
 
 #include "ai_server/model/world.h"
+#include "ai_server/trace/latency.h"
 #include "ball.h"
+#include "detection.h"
 #include "field.h"
 #include "robot.h"
 
@@ -22,6 +30,13 @@ namespace model {
 namespace updater {
 
 class world {
+public:
+  /// 全てのカメラからの検出結果が揃ったときに発火する signal の型
+  /// (引数はそのフレームで最も新しい撮影時刻)
+  using frame_signal_type =
+      boost::signals2::signal<void(std::chrono::system_clock::time_point)>;
+
+private:
   mutable std::mutex mutex_;
 
   /// フィールドのupdater
@@ -38,8 +53,41 @@ class world {
 
   Eigen::Affine3d matrix_ = Eigen::Affine3d::Identity();
 
+  /// snapshot_ の生成を直列化するための mutex
+  mutable std::mutex snapshot_mutex_;
+  /// 最後に公開した値
+  /// 読み出しは std::atomic_load で行うため, 読み出し側が mutex を取ることはない
+  mutable std::shared_ptr<const model::world> snapshot_;
+  /// snapshot_ を生成したときの各updaterの世代の合計
+  mutable std::atomic<std::uint64_t> snapshot_generation_;
+
+  /// 前のフレームを構成したカメラ
+  std::bitset<max_cameras> frame_cameras_;
+  /// 現在のフレームで検出結果が届いたカメラ
+  std::bitset<max_cameras> received_cameras_;
+  /// 現在のフレームで最も新しい撮影時刻
+  std::chrono::system_clock::time_point frame_time_;
+  /// これまでに揃ったフレームの数
+  std::atomic<std::uint64_t> frame_count_;
+  /// フレームが揃ったときに発火する signal
+  frame_signal_type frame_completed_;
+  /// last_frame_ を保護する mutex
+  mutable std::mutex last_frame_mutex_;
+  /// 最後に揃ったフレームの各段階の時刻
+  trace::frame_timestamps last_frame_;
+
+  /// @brief           カメラ camera_id の検出結果が届いたことを記録する
+  /// @return          フレームが揃ったか
+  bool track_frame(unsigned int camera_id, std::chrono::system_clock::time_point captured_time);
+
+  /// @brief           各updaterの世代の合計を求める
+  std::uint64_t generation() const;
+
+  /// @brief           各updaterの値から snapshot_ を作り直す
+  void publish() const;
+
 public:
-  world()             = default;
+  world();
   world(const world&) = delete;
   world& operator=(const world&) = delete;
 
@@ -50,6 +98,30 @@ public:
   /// @brief           値を取得する
   model::world value() const;
 
+  /// @brief           最新の値を共有する読み取り専用のオブジェクトを取得する
+  ///
+  /// 値は Vision のパケットを処理するたびに作り直される.
+  /// 返されたオブジェクトは以降の更新の影響を受けないので, 呼び出し側は
+  /// ロックを取らずに参照し続けることができる
+  std::shared_ptr<const model::world> snapshot() const;
+
+  /// @brief           これまでに揃ったフレームの数を取得する
+  std::uint64_t frame_count() const;
+
+  /// @brief           最後に揃ったフレームが受信され, snapshot() に反映された時刻を取得する
+  ///
+  /// 戦略部と Driver はこれに各自の時刻を書き足して trace::latency に記録する
+  trace::frame_timestamps last_frame() const;
+
+  /// @brief           フレームが揃ったときに slot が呼ばれるようにする
+  ///
+  /// 有効な全てのカメラから同じ撮影周期の検出結果が届き，snapshot() に反映された直後に
+  /// update() を呼んだスレッドで発火する. 揃うのを待つカメラは直前のフレームを構成した
+  /// ものとし, 先に同じカメラから次の検出結果が届いたときは揃わなかったものとして
+  /// その時点で発火する (カメラの増減には1フレームで追従する)
+  /// @param slot      フレームが揃ったときに呼びたい関数オブジェクト
+  boost::signals2::connection on_frame_completed(const frame_signal_type::slot_type& slot);
+
   /// @brief           updaterに変換行列を設定する
   /// @param matrix    変換行列
   void set_transformation_matrix(const Eigen::Affine3d& matrix);
@@ -1,9 +1,10 @@
 #ifndef AI_SERVER_MODEL_WORLD_H
 #define AI_SERVER_MODEL_WORLD_H
 
+#include <cstddef>
 #include <string>
-#include <unordered_map>
 
+#include "ai_server/util/fixed_map.h"
 #include "ball.h"
 #include "field.h"
 #include "robot.h"
@@ -16,17 +17,21 @@ namespace model {
 /// @brief   SSL-Visionからのデータを表現するクラス
 class world {
 public:
-  using robots_list = std::unordered_map<unsigned int, model::robot>;
+  /// 1チームで扱えるロボットIDの数 (ID 0 ~ max_robots - 1)
+  static constexpr std::size_t max_robots = 16;
+
+  /// KeyがID, Valueがロボットの連想配列の型
+  using robots_list = util::fixed_map<model::robot, max_robots>;
 
   world() = default;
 
   world(model::field&& field, model::ball&& ball, robots_list&& robots_blue,
         robots_list&& robots_yellow);
 
-  model::field field() const;
-  model::ball ball() const;
-  robots_list robots_blue() const;
-  robots_list robots_yellow() const;
+  const model::field& field() const;
+  const model::ball& ball() const;
+  const robots_list& robots_blue() const;
+  const robots_list& robots_yellow() const;
 
   void set_field(const model::field& field) {
     field_ = field;
@@ -23,4 +23,14 @@ void base::set_area(const model::field& field, double padding) {
   min_pos_ = {field.x_min() - padding, field.y_min() - padding};
   max_pos_ = {field.x_max() + padding, field.y_max() + padding};
 }
+
+void base::set_seed(std::uint32_t) {}
+
+void base::set_deadline(std::chrono::steady_clock::time_point) {}
+
+void base::set_current_velocity(const Eigen::Vector2d&) {}
+
+std::optional<Eigen::Vector2d> base::velocity_at(double) const {
+  return std::nullopt;
+}
 } // namespace ai_server::planner
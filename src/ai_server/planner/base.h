@@ -1,7 +1,10 @@
 #ifndef AI_SERVER_PLANNER_BASE_H
 #define AI_SERVER_PLANNER_BASE_H
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <Eigen/Core>
 #include "ai_server/model/field.h"
 #include "obstacle_list.h"
@@ -30,6 +33,26 @@ public:
   /// @param max_p フィールドを広げる量
   void set_area(const model::field& field, double padding);
 
+  /// @brief 乱数を使うplannerの乱数シードを設定する (乱数を使わないplannerでは何もしない)
+  /// @param seed 乱数シード
+  virtual void set_seed(std::uint32_t seed);
+
+  /// @brief 時間内で探索を続けるplannerの探索を打ち切る時刻を設定する
+  ///        (決まった量だけ探索するplannerでは何もしない)
+  /// @param deadline 探索を打ち切る時刻
+  virtual void set_deadline(std::chrono::steady_clock::time_point deadline);
+
+  /// @brief 現在の速度から軌道を予測するplannerにロボットの速度を設定する
+  ///        (速度を使わないplannerでは何もしない)
+  /// @param v 計測したロボットの速度 [mm/s]
+  virtual void set_current_velocity(const Eigen::Vector2d& v);
+
+  /// @brief 時刻付きの軌道を出力するplannerで，直前の探索の開始から t 秒後の速度を取得する
+  ///
+  /// 軌道を出力しないplannerや，目標へ直進できて目標位置を指令すればよいときは nullopt を返す
+  /// @param t 探索の開始からの時間 [s]
+  virtual std::optional<Eigen::Vector2d> velocity_at(double t) const;
+
   /// @brief 経路探索を行う関数オブジェクトを生成する
   virtual planner_type planner() = 0;
 
@@ -2,9 +2,11 @@
 #define AI_SERVER_PLANNER_DETAIL_CLIPPING_H
 
 #include <algorithm>
+#include <optional>
 #include <type_traits>
 #include <vector>
 #include <boost/geometry/algorithms/intersection.hpp>
+#include <boost/geometry/geometries/box.hpp>
 #include <boost/geometry/geometries/linestring.hpp>
 #include <boost/geometry/geometries/segment.hpp>
 
@@ -31,6 +33,43 @@ inline auto clipped(const boost::geometry::model::segment<Point>& segment,
   });
   return result;
 }
+
+/// @brief 線分を矩形でクリッピングし，結果を返す
+///
+/// Liang-Barsky のアルゴリズムで直接求めるため，clipped() と異なりメモリを確保しない
+/// @param segment            クリッピング対象の線分
+/// @param region             クリッピングする矩形
+/// @return クリッピング後の線分 (矩形と重ならないときはstd::nullopt)
+template <class Point>
+inline std::optional<boost::geometry::model::segment<Point>> clipped_by_box(
+    const boost::geometry::model::segment<Point>& segment,
+    const boost::geometry::model::box<Point>& region) {
+  const auto& [a, b] = segment;
+  const Point d      = b - a;
+
+  // 線分を a + t * d (0 <= t <= 1) と表したときの，矩形内を通る t の範囲
+  double t0 = 0.0;
+  double t1 = 1.0;
+  // 各辺について，外側から内側に入る (p < 0) か内側から外側に出る (p > 0) かで範囲を狭める
+  const auto clip = [&t0, &t1](double p, double q) {
+    if (p == 0.0) return q >= 0.0;
+    const double t = q / p;
+    if (p < 0.0) {
+      t0 = std::max(t0, t);
+    } else {
+      t1 = std::min(t1, t);
+    }
+    return t0 <= t1;
+  };
+
+  const auto& min = region.min_corner();
+  const auto& max = region.max_corner();
+  if (!clip(-d.x(), a.x() - min.x()) || !clip(d.x(), max.x() - a.x()) ||
+      !clip(-d.y(), a.y() - min.y()) || !clip(d.y(), max.y() - a.y())) {
+    return std::nullopt;
+  }
+  return boost::geometry::model::segment<Point>{a + t0 * d, a + t1 * d};
+}
 } // namespace ai_server::planner::detail
 
 #endif
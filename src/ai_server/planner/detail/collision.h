@@ -3,15 +3,20 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <variant>
 #include <type_traits>
 #include <boost/geometry/algorithms/distance.hpp>
 #include <boost/geometry/geometries/segment.hpp>
 #include <Eigen/Core>
 
+#include "ai_server/model/obstacle/box.h"
 #include "ai_server/model/obstacle/point.h"
+#include "ai_server/model/obstacle/segment.h"
+#include "distance_field.h"
 #include "geometry_helper.h"
 #include "obstacle_tree.h"
+#include "ray_intersection.h"
 
 namespace ai_server::planner::detail {
 
@@ -49,62 +54,88 @@ inline auto is_collided(const Geometry& g, const tree_type<ObstacleTypes...>& ob
   });
 }
 
-/// @brief 障害物にぶつかるときの長さを計算する
-/// @param first rayの長さを小さい順に並べたリストの最初の要素
-/// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
+/// @brief 距離場に対する当たり判定を行い，結果を返す
+/// @param p 点
+/// @param field 距離場
+/// @return 当たっているときtrue.
+inline bool is_collided(const Eigen::Vector2d& p, const distance_field& field) {
+  return field.is_collided(p);
+}
+
+/// @brief 距離場に対する当たり判定を行い，結果を返す
+/// @param s 線分
+/// @param field 距離場
+/// @return 当たっているときtrue.
+inline bool is_collided(const boost::geometry::model::segment<Eigen::Vector2d>& s,
+                        const distance_field& field) {
+  return field.is_collided(s.first, s.second);
+}
+
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param g ジオメトリ
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+template <class Geometry, class... ObstacleTypes>
+inline auto is_collided(const Geometry& g, const layered_tree<ObstacleTypes...>& obstacles) {
+  return (obstacles.field && is_collided(g, *obstacles.field)) ||
+         (obstacles.shared && is_collided(g, *obstacles.shared)) ||
+         is_collided(g, obstacles.local);
+}
+
+/// @brief rayが障害物に当たるまでの距離を計算する
 /// @param start 開始地点
-/// @param dir rayを伸ばす方向
+/// @param dir rayを伸ばす方向 (単位ベクトル)
 /// @param o 障害物
-/// @return 障害物にぶつかる最小長さの要素
-template <class Iterator, class Obstacle>
-inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
-                                 const Eigen::Vector2d& dir, const Obstacle& o) {
-  static_assert(std::is_floating_point_v<typename std::iterator_traits<Iterator>::value_type>);
+/// @return 当たるまでの距離 (当たらないときは no_intersection)
+inline double ray_distance(const Eigen::Vector2d& start, const Eigen::Vector2d& dir,
+                           const model::obstacle::point& o) {
+  return ray_circle(start.x(), start.y(), dir.x(), dir.y(), o.geometry.x(), o.geometry.y(),
+                    o.margin);
+}
 
-  using ray_type = boost::geometry::model::segment<Eigen::Vector2d>;
+/// @brief rayが障害物に当たるまでの距離を計算する
+/// @param start 開始地点
+/// @param dir rayを伸ばす方向 (単位ベクトル)
+/// @param o 障害物
+/// @return 当たるまでの距離 (当たらないときは no_intersection)
+inline double ray_distance(const Eigen::Vector2d& start, const Eigen::Vector2d& dir,
+                           const model::obstacle::segment& o) {
+  const auto& [p1, p2] = o.geometry;
+  return ray_capsule(start.x(), start.y(), dir.x(), dir.y(), p1.x(), p1.y(), p2.x(), p2.y(),
+                     o.margin);
+}
 
-  return std::partition_point(first, last, [&start, &dir, &o](auto l) {
-    return !is_collided(ray_type{start, start + l * dir}, o);
-  });
+/// @brief rayが障害物に当たるまでの距離を計算する
+/// @param start 開始地点
+/// @param dir rayを伸ばす方向 (単位ベクトル)
+/// @param o 障害物
+/// @return 当たるまでの距離 (当たらないときは no_intersection)
+inline double ray_distance(const Eigen::Vector2d& start, const Eigen::Vector2d& dir,
+                           const model::obstacle::box& o) {
+  const auto& min = o.geometry.min_corner();
+  const auto& max = o.geometry.max_corner();
+  return ray_rounded_box(start.x(), start.y(), dir.x(), dir.y(), min.x(), min.y(), max.x(),
+                         max.y(), o.margin);
 }
 
 /// @brief 障害物にぶつかるときの長さを計算する
 /// @param first rayの長さを小さい順に並べたリストの最初の要素
 /// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
 /// @param start 開始地点
-/// @param dir rayを伸ばす方向
+/// @param dir rayを伸ばす方向 (単位ベクトル)
 /// @param o 障害物
 /// @return 障害物にぶつかる最小長さの要素
-template <class Iterator>
+template <class Iterator, class Obstacle>
 inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
-                                 const Eigen::Vector2d& dir, const model::obstacle::point& o) {
+                                 const Eigen::Vector2d& dir, const Obstacle& o) {
   static_assert(std::is_floating_point_v<typename std::iterator_traits<Iterator>::value_type>);
 
-  using ray_type = boost::geometry::model::segment<Eigen::Vector2d>;
-
   // 要素が空のとき
   if (first == last) return last;
 
-  // 最大まで伸ばしたray
-  const ray_type ray{start, start + *std::prev(last, 1) * dir};
-
-  // 衝突するとき
-  if (is_collided(ray, o)) {
-    // スタートから障害物中心まで
-    const Eigen::Vector2d to_obstacle = o.geometry - start;
-    const double dot                  = to_obstacle.dot(dir);
-
-    const double squared_height = (to_obstacle - dot * dir).squaredNorm();
-    const double squared_hypot  = o.margin * o.margin;
-    // 正確な衝突距離
-    const double length = dot - std::sqrt(squared_hypot - squared_height);
-
-    // 衝突距離以上の値が出てくる場所を探す
-    return std::lower_bound(first, last, length);
-  }
-
-  // 衝突しないとき
-  return last;
+  // rayを伸ばしていったときに初めて障害物にぶつかる長さを解析的に求め，
+  // それ以上の値が出てくる場所を探す
+  return std::lower_bound(first, last, ray_distance(start, dir, o));
 }
 
 /// @brief 障害物にぶつかるときの長さを計算する
@@ -162,6 +193,29 @@ inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vec
   return last;
 }
 
+/// @brief 障害物にぶつかるときの長さを計算する
+/// @param first rayの長さを小さい順に並べたリストの最初の要素
+/// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
+/// @param start 開始地点
+/// @param dir rayを伸ばす方向
+/// @param obstacles 障害物
+/// @return 障害物にぶつかる最小長さの要素
+template <class Iterator, class... ObstacleTypes>
+inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
+                                 const Eigen::Vector2d& dir,
+                                 const layered_tree<ObstacleTypes...>& obstacles) {
+  static_assert(std::is_floating_point_v<typename std::iterator_traits<Iterator>::value_type>);
+
+  if (obstacles.field && first != last) {
+    last = std::lower_bound(
+        first, last, obstacles.field->ray_distance(start, dir, *std::prev(last, 1)));
+  }
+  if (obstacles.shared) {
+    last = find_collided_length(first, last, start, dir, *obstacles.shared);
+  }
+  return find_collided_length(first, last, start, dir, obstacles.local);
+}
+
 /// @brief 衝突している障害物を抽出する
 /// @param obstacles 障害物
 /// @param g ジオメトリ
@@ -176,6 +230,20 @@ inline auto extract_collisions(const tree_type<ObstacleTypes...>& obstacles,
                           boost::geometry::index::satisfies(
                               [&g](const auto& a) { return is_collided(g, std::get<1>(a)); }));
 }
+
+/// @brief 衝突している障害物を抽出する
+/// @param obstacles 障害物
+/// @param g ジオメトリ
+/// @param out 衝突している障害物を書き込むイテレータ
+/// @return 書き込んだ要素の末尾の次を指すイテレータ
+template <class Geometry, class OutputIterator, class... ObstacleTypes>
+inline OutputIterator extract_collisions(const layered_tree<ObstacleTypes...>& obstacles,
+                                         const Geometry& g, OutputIterator out) {
+  if (obstacles.shared) {
+    out = std::copy(extract_collisions(*obstacles.shared, g), obstacles.shared->qend(), out);
+  }
+  return std::copy(extract_collisions(obstacles.local, g), obstacles.local.qend(), out);
+}
 } // namespace ai_server::planner::detail
 
 #endif
@@ -0,0 +1,230 @@
+#ifndef AI_SERVER_PLANNER_DETAIL_DISTANCE_FIELD_H
+#define AI_SERVER_PLANNER_DETAIL_DISTANCE_FIELD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <variant>
+#include <vector>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/box.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/model/obstacle/segment.h"
+#include "geometry_helper.h"
+#include "ray_intersection.h"
+
+namespace ai_server::planner::detail {
+
+/// @class   distance_field
+/// @brief   動かない障害物 (ペナルティエリアなど) までの符号付き距離を格子状に保持する
+///
+/// 各格子点には，最も近い障害物の margin の外側までの距離 (中に入っているときは負) を持つ.
+/// box の内側では最も近い辺までの深さの分だけさらに小さくするため，中でも勾配は 0 にならない.
+/// 格子の内側では双線形補間により O(1) で距離を求め，外側では障害物から直接計算する.
+/// フィールドの形状が変わったときだけ作り直せばよいため，cached() で作ったものを共有する
+class distance_field {
+public:
+  using obstacle_type =
+      std::variant<model::obstacle::point, model::obstacle::segment, model::obstacle::box>;
+
+  /// @param area        格子を作る範囲
+  /// @param resolution  格子の間隔 [mm]
+  /// @param obstacles   障害物
+  distance_field(const envelope_type& area, double resolution,
+                 std::vector<obstacle_type> obstacles)
+      : origin_{area.min_corner()},
+        resolution_{resolution},
+        nx_{static_cast<std::size_t>(
+                std::ceil((area.max_corner().x() - area.min_corner().x()) / resolution)) +
+            1},
+        ny_{static_cast<std::size_t>(
+                std::ceil((area.max_corner().y() - area.min_corner().y()) / resolution)) +
+            1},
+        obstacles_{std::move(obstacles)},
+        grid_(nx_ * ny_) {
+    for (std::size_t j = 0; j < ny_; ++j) {
+      for (std::size_t i = 0; i < nx_; ++i) {
+        grid_[j * nx_ + i] = static_cast<float>(exact_clearance(
+            origin_ + Eigen::Vector2d{i * resolution_, j * resolution_}));
+      }
+    }
+  }
+
+  /// @brief 同じ範囲, 間隔, 障害物から作った distance_field を共有する
+  ///
+  /// 直近に作ったものを幾つか覚えておき，条件が同じであれば作り直さずに返す
+  static std::shared_ptr<const distance_field> cached(
+      const envelope_type& area, double resolution,
+      const std::vector<obstacle_type>& obstacles) {
+    // 覚えておく数
+    constexpr std::size_t capacity = 8;
+
+    static std::mutex mutex;
+    static std::vector<std::shared_ptr<const distance_field>> cache;
+
+    std::unique_lock lock{mutex};
+    const auto it = std::find_if(cache.begin(), cache.end(), [&](const auto& f) {
+      return f->matches(area, resolution, obstacles);
+    });
+    if (it != cache.end()) return *it;
+
+    auto f = std::make_shared<const distance_field>(area, resolution, obstacles);
+    if (cache.size() >= capacity) cache.erase(cache.begin());
+    cache.push_back(f);
+    return f;
+  }
+
+  /// @brief 格子の間隔を取得する
+  double resolution() const {
+    return resolution_;
+  }
+
+  /// @brief 障害物を取得する
+  const std::vector<obstacle_type>& obstacles() const {
+    return obstacles_;
+  }
+
+  /// @brief 点から障害物の margin の外側までの距離 (中に入っているときは負) を求める
+  double clearance(const Eigen::Vector2d& p) const {
+    const double fx = (p.x() - origin_.x()) / resolution_;
+    const double fy = (p.y() - origin_.y()) / resolution_;
+    // 格子の外側
+    if (!(fx >= 0.0 && fy >= 0.0 && fx < nx_ - 1 && fy < ny_ - 1)) return exact_clearance(p);
+
+    const auto i    = static_cast<std::size_t>(fx);
+    const auto j    = static_cast<std::size_t>(fy);
+    const double tx = fx - i;
+    const double ty = fy - j;
+    const float* c  = &grid_[j * nx_ + i];
+    return (1.0 - ty) * ((1.0 - tx) * c[0] + tx * c[1]) +
+           ty * ((1.0 - tx) * c[nx_] + tx * c[nx_ + 1]);
+  }
+
+  /// @brief 点が障害物に当たっているか
+  bool is_collided(const Eigen::Vector2d& p) const {
+    return clearance(p) < 0.0;
+  }
+
+  /// @brief 線分 a-b が障害物に当たっているか
+  bool is_collided(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const {
+    const Eigen::Vector2d ab = b - a;
+    const double l           = ab.norm();
+    if (l == 0.0) return is_collided(a);
+    return ray_distance(a, ab / l, l) < l;
+  }
+
+  /// @brief rayが最初に障害物に当たるまでの距離を求める
+  ///
+  /// 距離の分だけ進むことを繰り返す (sphere tracing)
+  /// @param start       開始地点
+  /// @param dir         rayを伸ばす方向 (単位ベクトル)
+  /// @param max_length  調べる最大の長さ
+  /// @return            当たるまでの距離 (max_length までに当たらないときは no_intersection)
+  double ray_distance(const Eigen::Vector2d& start, const Eigen::Vector2d& dir,
+                      double max_length) const {
+    // 当たったとみなす距離
+    constexpr double epsilon = 1.0;
+    // 障害物の縁に沿って進むときに打ち切る回数
+    constexpr int max_steps = 256;
+
+    double t = 0.0;
+    for (int n = 0; n < max_steps; ++n) {
+      const double c = clearance(start + t * dir);
+      if (c < epsilon) return t;
+      t += c;
+      if (t > max_length) return no_intersection;
+    }
+    // 障害物の縁に沿って進み続けて打ち切ったときは当たったとみなす
+    return clearance(start + t * dir) < resolution_ ? t : no_intersection;
+  }
+
+  /// @brief 距離が最も大きくなる方向 (障害物から離れる方向) を求める
+  Eigen::Vector2d gradient(const Eigen::Vector2d& p) const {
+    const double h = resolution_;
+    const Eigen::Vector2d g{clearance(p + Eigen::Vector2d{h, 0.0}) -
+                                clearance(p - Eigen::Vector2d{h, 0.0}),
+                            clearance(p + Eigen::Vector2d{0.0, h}) -
+                                clearance(p - Eigen::Vector2d{0.0, h})};
+    const double n = g.norm();
+    return n > 0.0 ? Eigen::Vector2d{g / n} : Eigen::Vector2d::Zero();
+  }
+
+private:
+  // 障害物から直接計算した距離
+  double exact_clearance(const Eigen::Vector2d& p) const {
+    double result = no_intersection;
+    for (const auto& o : obstacles_) {
+      result = std::min(result, std::visit([&p](const auto& a) { return clearance(p, a); }, o));
+    }
+    return result;
+  }
+
+  static double clearance(const Eigen::Vector2d& p, const model::obstacle::point& o) {
+    return (p - o.geometry).norm() - o.margin;
+  }
+
+  static double clearance(const Eigen::Vector2d& p, const model::obstacle::segment& o) {
+    const auto& [p1, p2] = o.geometry;
+    return std::sqrt(
+               squared_distance_to_segment(p.x(), p.y(), p1.x(), p1.y(), p2.x(), p2.y())) -
+           o.margin;
+  }
+
+  static double clearance(const Eigen::Vector2d& p, const model::obstacle::box& o) {
+    const auto& min = o.geometry.min_corner();
+    const auto& max = o.geometry.max_corner();
+    // 内側では，最も近い辺までの距離を負にする
+    const double depth = std::min({p.x() - min.x(), max.x() - p.x(), p.y() - min.y(),
+                                   max.y() - p.y()});
+    if (depth > 0.0) return -depth - o.margin;
+    return std::sqrt(
+               squared_distance_to_box(p.x(), p.y(), min.x(), min.y(), max.x(), max.y())) -
+           o.margin;
+  }
+
+  // 同じ条件で作ったものか
+  bool matches(const envelope_type& area, double resolution,
+               const std::vector<obstacle_type>& obstacles) const {
+    if (resolution != resolution_ || area.min_corner() != origin_ ||
+        nx_ != static_cast<std::size_t>(std::ceil(
+                   (area.max_corner().x() - area.min_corner().x()) / resolution)) + 1 ||
+        ny_ != static_cast<std::size_t>(std::ceil(
+                   (area.max_corner().y() - area.min_corner().y()) / resolution)) + 1 ||
+        obstacles.size() != obstacles_.size()) {
+      return false;
+    }
+    return std::equal(obstacles.begin(), obstacles.end(), obstacles_.begin(),
+                      [](const auto& a, const auto& b) { return same(a, b); });
+  }
+
+  static bool same(const obstacle_type& a, const obstacle_type& b) {
+    if (a.index() != b.index()) return false;
+    if (const auto p = std::get_if<model::obstacle::point>(&a)) {
+      const auto& q = std::get<model::obstacle::point>(b);
+      return p->geometry == q.geometry && p->margin == q.margin;
+    }
+    if (const auto s = std::get_if<model::obstacle::segment>(&a)) {
+      const auto& t = std::get<model::obstacle::segment>(b);
+      return s->geometry.first == t.geometry.first && s->geometry.second == t.geometry.second &&
+             s->margin == t.margin;
+    }
+    const auto& x = std::get<model::obstacle::box>(a);
+    const auto& y = std::get<model::obstacle::box>(b);
+    return x.geometry.min_corner() == y.geometry.min_corner() &&
+           x.geometry.max_corner() == y.geometry.max_corner() && x.margin == y.margin;
+  }
+
+  Eigen::Vector2d origin_;
+  double resolution_;
+  std::size_t nx_;
+  std::size_t ny_;
+  std::vector<obstacle_type> obstacles_;
+  // 格子点での距離 (y 方向に nx_ 個ずつ並べる)
+  std::vector<float> grid_;
+};
+} // namespace ai_server::planner::detail
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef AI_SERVER_PLANNER_DETAIL_OBSTACLE_ARRAYS_H
+#define AI_SERVER_PLANNER_DETAIL_OBSTACLE_ARRAYS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <boost/geometry/algorithms/intersects.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/box.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/model/obstacle/segment.h"
+#include "distance_field.h"
+#include "geometry_helper.h"
+#include "obstacle_tree.h"
+#include "ray_intersection.h"
+
+namespace ai_server::planner::detail {
+
+/// @class   obstacle_arrays
+/// @brief   障害物を種類毎に座標の配列 (structure of arrays) として保持する
+///
+/// 1回の経路探索で同じ障害物に対して何百回も当たり判定を行うときに使う.
+/// 全ての障害物に対する判定を種類毎の連続したループで行うため,
+/// -march=native でビルドしたときにはコンパイラによって SIMD 命令にベクトル化される
+class obstacle_arrays {
+public:
+  /// @brief 全ての障害物を削除する (確保した領域は再利用する)
+  void clear() {
+    points_.clear();
+    segments_.clear();
+    boxes_.clear();
+    field_ = nullptr;
+  }
+
+  /// @brief 障害物を追加する
+  void add(const model::obstacle::point& o) {
+    points_.x.push_back(o.geometry.x());
+    points_.y.push_back(o.geometry.y());
+    points_.margin.push_back(o.margin);
+  }
+
+  /// @brief 障害物を追加する
+  void add(const model::obstacle::segment& o) {
+    const auto& [p1, p2] = o.geometry;
+    segments_.x1.push_back(p1.x());
+    segments_.y1.push_back(p1.y());
+    segments_.x2.push_back(p2.x());
+    segments_.y2.push_back(p2.y());
+    segments_.margin.push_back(o.margin);
+  }
+
+  /// @brief 障害物を追加する
+  void add(const model::obstacle::box& o) {
+    const auto& min = o.geometry.min_corner();
+    const auto& max = o.geometry.max_corner();
+    boxes_.min_x.push_back(min.x());
+    boxes_.min_y.push_back(min.y());
+    boxes_.max_x.push_back(max.x());
+    boxes_.max_y.push_back(max.y());
+    boxes_.margin.push_back(o.margin);
+  }
+
+  /// @brief 障害物を追加する
+  template <class... ObstacleTypes>
+  void add(const std::variant<ObstacleTypes...>& o) {
+    std::visit([this](const auto& arg) { add(arg); }, o);
+  }
+
+  /// @brief RTreeから，範囲内にかかる障害物を全て追加する
+  /// @param obstacles 障害物
+  /// @param area      範囲
+  template <class... ObstacleTypes>
+  void add(const tree_type<ObstacleTypes...>& obstacles, const envelope_type& area) {
+    // qbegin() の型消去されたイテレータはメモリを確保するため，出力イテレータで受け取る
+    obstacles.query(
+        boost::geometry::index::intersects(area),
+        boost::make_function_output_iterator([this](const auto& e) { add(std::get<1>(e)); }));
+  }
+
+  /// @brief (近似Box, 障害物) の組の列から，範囲内にかかる障害物を全て追加する
+  /// @param first 最初の要素
+  /// @param last  末尾の次の要素
+  /// @param area  範囲
+  template <class Iterator>
+  void add(Iterator first, Iterator last, const envelope_type& area) {
+    for (; first != last; ++first) {
+      if (boost::geometry::intersects(std::get<0>(*first), area)) add(std::get<1>(*first));
+    }
+  }
+
+  /// @brief RTreeから，範囲内にかかる障害物を全て追加する
+  /// @param obstacles 障害物
+  /// @param area      範囲
+  template <class... ObstacleTypes>
+  void add(const layered_tree<ObstacleTypes...>& obstacles, const envelope_type& area) {
+    if (obstacles.shared) add(*obstacles.shared, area);
+    add(obstacles.local, area);
+    if (obstacles.field) field_ = obstacles.field;
+  }
+
+  /// @brief 動かない障害物の距離場を設定する
+  void set_field(std::shared_ptr<const distance_field> field) {
+    field_ = std::move(field);
+  }
+
+  /// @brief 障害物の数を取得する (距離場の障害物は含まない)
+  std::size_t size() const {
+    return points_.x.size() + segments_.x1.size() + boxes_.min_x.size();
+  }
+
+  /// @brief 点が何れかの障害物に当たっているか
+  bool is_collided(const Eigen::Vector2d& p) const {
+    const double px = p.x();
+    const double py = p.y();
+    // 途中で抜けずに全て調べた方がベクトル化される分速い
+    bool hit = false;
+    for (std::size_t i = 0; i < points_.x.size(); ++i) {
+      const double ex = px - points_.x[i];
+      const double ey = py - points_.y[i];
+      hit |= ex * ex + ey * ey < points_.margin[i] * points_.margin[i];
+    }
+    for (std::size_t i = 0; i < segments_.x1.size(); ++i) {
+      hit |= squared_distance_to_segment(px, py, segments_.x1[i], segments_.y1[i],
+                                         segments_.x2[i], segments_.y2[i]) <
+             segments_.margin[i] * segments_.margin[i];
+    }
+    for (std::size_t i = 0; i < boxes_.min_x.size(); ++i) {
+      hit |= squared_distance_to_box(px, py, boxes_.min_x[i], boxes_.min_y[i], boxes_.max_x[i],
+                                     boxes_.max_y[i]) < boxes_.margin[i] * boxes_.margin[i];
+    }
+    return hit || (field_ && field_->is_collided(p));
+  }
+
+  /// @brief 線分 a-b が何れかの障害物に当たっているか
+  bool is_collided(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const {
+    const Eigen::Vector2d ab = b - a;
+    const double l           = ab.norm();
+    if (l == 0.0) return is_collided(a);
+    return ray_distance(a, ab / l, l) < l;
+  }
+
+  /// @brief rayが最初に障害物に当たるまでの距離を求める
+  /// @param start 開始地点
+  /// @param dir   rayを伸ばす方向 (単位ベクトル)
+  /// @return      当たるまでの距離 (当たらないときは no_intersection)
+  double ray_distance(const Eigen::Vector2d& start, const Eigen::Vector2d& dir) const {
+    return ray_distance(start, dir, no_intersection);
+  }
+
+  /// @brief rayが最初に障害物に当たるまでの距離を求める
+  /// @param start      開始地点
+  /// @param dir        rayを伸ばす方向 (単位ベクトル)
+  /// @param max_length 距離場に対して調べる最大の長さ
+  /// @return           当たるまでの距離 (当たらないときは no_intersection)
+  double ray_distance(const Eigen::Vector2d& start, const Eigen::Vector2d& dir,
+                      double max_length) const {
+    const double sx = start.x();
+    const double sy = start.y();
+    const double dx = dir.x();
+    const double dy = dir.y();
+    double t        = no_intersection;
+    for (std::size_t i = 0; i < points_.x.size(); ++i) {
+      t = std::min(t,
+                   ray_circle(sx, sy, dx, dy, points_.x[i], points_.y[i], points_.margin[i]));
+    }
+    for (std::size_t i = 0; i < segments_.x1.size(); ++i) {
+      t = std::min(t, ray_capsule(sx, sy, dx, dy, segments_.x1[i], segments_.y1[i],
+                                  segments_.x2[i], segments_.y2[i], segments_.margin[i]));
+    }
+    for (std::size_t i = 0; i < boxes_.min_x.size(); ++i) {
+      t = std::min(t, ray_rounded_box(sx, sy, dx, dy, boxes_.min_x[i], boxes_.min_y[i],
+                                      boxes_.max_x[i], boxes_.max_y[i], boxes_.margin[i]));
+    }
+    // 距離場は，配列の障害物に当たるところまで調べればよい
+    if (field_) t = std::min(t, field_->ray_distance(start, dir, std::min(t, max_length)));
+    return t;
+  }
+
+private:
+  // 点 (円)
+  struct {
+    std::vector<double> x, y, margin;
+    void clear() {
+      x.clear();
+      y.clear();
+      margin.clear();
+    }
+  } points_;
+
+  // 線分 (カプセル)
+  struct {
+    std::vector<double> x1, y1, x2, y2, margin;
+    void clear() {
+      x1.clear();
+      y1.clear();
+      x2.clear();
+      y2.clear();
+      margin.clear();
+    }
+  } segments_;
+
+  // 矩形 (角の丸い矩形)
+  struct {
+    std::vector<double> min_x, min_y, max_x, max_y, margin;
+    void clear() {
+      min_x.clear();
+      min_y.clear();
+      max_x.clear();
+      max_y.clear();
+      margin.clear();
+    }
+  } boxes_;
+
+  // 動かない障害物の距離場
+  std::shared_ptr<const distance_field> field_;
+};
+
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param p 点
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+inline bool is_collided(const Eigen::Vector2d& p, const obstacle_arrays& obstacles) {
+  return obstacles.is_collided(p);
+}
+
+/// @brief 障害物にぶつかるときの長さを計算する
+/// @param first rayの長さを小さい順に並べたリストの最初の要素
+/// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
+/// @param start 開始地点
+/// @param dir rayを伸ばす方向 (単位ベクトル)
+/// @param obstacles 障害物
+/// @return 障害物にぶつかる最小長さの要素
+template <class Iterator>
+inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
+                                 const Eigen::Vector2d& dir, const obstacle_arrays& obstacles) {
+  static_assert(std::is_floating_point_v<typename std::iterator_traits<Iterator>::value_type>);
+  if (first == last) return last;
+  return std::lower_bound(first, last, obstacles.ray_distance(start, dir, *std::prev(last, 1)));
+}
+} // namespace ai_server::planner::detail
+
+#endif
@@ -1,10 +1,12 @@
 #ifndef AI_SERVER_PLANNER_DETAIL_OBSTACLE_TREE_H
 #define AI_SERVER_PLANNER_DETAIL_OBSTACLE_TREE_H
 
+#include <memory>
 #include <utility>
 #include <variant>
 #include <boost/geometry/index/rtree.hpp>
 
+#include "distance_field.h"
 #include "geometry_helper.h"
 
 namespace ai_server::planner::detail {
@@ -15,6 +17,18 @@ template <class... ObstacleTypes>
 using tree_type =
     boost::geometry::index::rtree<std::pair<envelope_type, std::variant<ObstacleTypes...>>,
                                   boost::geometry::index::rstar<20>>;
+
+// 複数のロボットで共有する障害物RTreeと，ロボット毎に追加された障害物RTreeの組
+// 当たり判定は両方の木と，動かない障害物の距離場に対して行う
+template <class... ObstacleTypes>
+struct layered_tree {
+  // 共有されたRTree (無いときはnullptr)
+  std::shared_ptr<const tree_type<ObstacleTypes...>> shared;
+  // ロボット毎に追加された障害物のRTree
+  tree_type<ObstacleTypes...> local;
+  // 動かない障害物の距離場 (無いときはnullptr)
+  std::shared_ptr<const distance_field> field = nullptr;
+};
 } // namespace ai_server::planner::detail
 
 #endif
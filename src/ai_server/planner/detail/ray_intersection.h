@@ -0,0 +1,103 @@
+#ifndef AI_SERVER_PLANNER_DETAIL_RAY_INTERSECTION_H
+#define AI_SERVER_PLANNER_DETAIL_RAY_INTERSECTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ai_server::planner::detail {
+
+// rayが図形に当たらないときの距離
+constexpr double no_intersection = std::numeric_limits<double>::infinity();
+
+// 以下の関数は，始点 (sx, sy) から単位ベクトル (dx, dy) の方向に伸ばしたrayが
+// 図形に入るまでの距離を返す (始点が図形の中にあるときは 0，当たらないときは no_intersection)
+// 障害物の数だけ繰り返し呼ばれるため，ループがベクトル化されるよう分岐を避けて書く
+
+/// @brief 中心 (cx, cy)，半径 r の円に入るまでの距離
+inline double ray_circle(double sx, double sy, double dx, double dy, double cx, double cy,
+                         double r) {
+  const double ox   = cx - sx;
+  const double oy   = cy - sy;
+  const double b    = ox * dx + oy * dy;
+  const double c    = ox * ox + oy * oy - r * r;
+  const double disc = b * b - c;
+  const double t    = b - std::sqrt(std::max(disc, 0.0));
+  return c < 0.0 ? 0.0 : (disc >= 0.0 && b >= 0.0 ? t : no_intersection);
+}
+
+/// @brief 軸に平行な矩形 [min_x, max_x] x [min_y, max_y] に入るまでの距離
+inline double ray_box(double sx, double sy, double dx, double dy, double min_x, double min_y,
+                      double max_x, double max_y) {
+  // 0 除算で NaN が出ないよう，方向成分が 0 のときは十分小さい値で割る
+  const double inv_x = 1.0 / (dx == 0.0 ? 1e-300 : dx);
+  const double inv_y = 1.0 / (dy == 0.0 ? 1e-300 : dy);
+  const double tx1   = (min_x - sx) * inv_x;
+  const double tx2   = (max_x - sx) * inv_x;
+  const double ty1   = (min_y - sy) * inv_y;
+  const double ty2   = (max_y - sy) * inv_y;
+  // slab法
+  const double t_in  = std::max({std::min(tx1, tx2), std::min(ty1, ty2), 0.0});
+  const double t_out = std::min(std::max(tx1, tx2), std::max(ty1, ty2));
+  return t_in <= t_out ? t_in : no_intersection;
+}
+
+/// @brief 線分 (x1, y1)-(x2, y2) から距離 r 以内の領域 (カプセル) に入るまでの距離
+inline double ray_capsule(double sx, double sy, double dx, double dy, double x1, double y1,
+                          double x2, double y2, double r) {
+  // 端点の円
+  const double t_end =
+      std::min(ray_circle(sx, sy, dx, dy, x1, y1, r), ray_circle(sx, sy, dx, dy, x2, y2, r));
+
+  // 線分の方向を x 軸とする座標系で，[0, l] x [-r, r] の矩形として調べる
+  const double ux = x2 - x1;
+  const double uy = y2 - y1;
+  const double l  = std::sqrt(ux * ux + uy * uy);
+  const double ax = l > 0.0 ? ux / l : 1.0;
+  const double ay = l > 0.0 ? uy / l : 0.0;
+  const double px = sx - x1;
+  const double py = sy - y1;
+  const double t_side =
+      ray_box(px * ax + py * ay, -px * ay + py * ax, dx * ax + dy * ay, -dx * ay + dy * ax, 0.0,
+              -r, l, r);
+
+  return std::min(t_end, t_side);
+}
+
+/// @brief 矩形 [min_x, max_x] x [min_y, max_y] から距離 r 以内の領域に入るまでの距離
+inline double ray_rounded_box(double sx, double sy, double dx, double dy, double min_x,
+                              double min_y, double max_x, double max_y, double r) {
+  // 辺の方向に広げた2つの矩形と，角の円の和集合
+  const double t_box = std::min(ray_box(sx, sy, dx, dy, min_x - r, min_y, max_x + r, max_y),
+                                ray_box(sx, sy, dx, dy, min_x, min_y - r, max_x, max_y + r));
+  const double t_corner = std::min({ray_circle(sx, sy, dx, dy, min_x, min_y, r),
+                                    ray_circle(sx, sy, dx, dy, min_x, max_y, r),
+                                    ray_circle(sx, sy, dx, dy, max_x, min_y, r),
+                                    ray_circle(sx, sy, dx, dy, max_x, max_y, r)});
+  return std::min(t_box, t_corner);
+}
+
+/// @brief 点 (px, py) と線分 (x1, y1)-(x2, y2) の距離の2乗
+inline double squared_distance_to_segment(double px, double py, double x1, double y1,
+                                          double x2, double y2) {
+  const double ux = x2 - x1;
+  const double uy = y2 - y1;
+  const double wx = px - x1;
+  const double wy = py - y1;
+  const double uu = ux * ux + uy * uy;
+  const double k  = uu > 0.0 ? std::clamp((wx * ux + wy * uy) / uu, 0.0, 1.0) : 0.0;
+  const double ex = wx - k * ux;
+  const double ey = wy - k * uy;
+  return ex * ex + ey * ey;
+}
+
+/// @brief 点 (px, py) と軸に平行な矩形 [min_x, max_x] x [min_y, max_y] の距離の2乗
+inline double squared_distance_to_box(double px, double py, double min_x, double min_y,
+                                      double max_x, double max_y) {
+  const double ex = std::max({min_x - px, 0.0, px - max_x});
+  const double ey = std::max({min_y - py, 0.0, py - max_y});
+  return ex * ex + ey * ey;
+}
+} // namespace ai_server::planner::detail
+
+#endif
@@ -1,34 +1,63 @@
+#include <algorithm>
+
+#include "ai_server/planner/detail/obstacle_arrays.h"
 #include "ai_server/util/math/to_vector.h"
 #include "impl/human_like.h"
 #include "human_like.h"
 
 namespace ai_server::planner {
 
+human_like::human_like() : rotations_{impl::make_rotations(direction_count_)} {
+  update_length_ladder();
+}
+
 void human_like::set_direction_count(int count) {
   direction_count_ = count;
+  rotations_       = impl::make_rotations(direction_count_);
 }
 
 void human_like::set_max_exit_length(double length) {
   max_exit_length_ = length;
+  update_length_ladder();
 }
 
 void human_like::set_max_length(double length) {
   max_length_ = length;
+  update_length_ladder();
 }
 
 void human_like::set_min_length(double length) {
   min_length_ = length;
+  update_length_ladder();
 }
 
 void human_like::set_step_length(double length) {
   step_length_ = length;
+  update_length_ladder();
+}
+
+void human_like::update_length_ladder() {
+  impl::make_length_list(min_length_, std::max(max_length_, max_exit_length_), step_length_,
+                         length_ladder_);
+}
+
+void human_like::make_length_list(double l_min, double l_max,
+                                  std::vector<double>& result) const {
+  // ゴールが min_length_ より近いときなどは，length_ladder_ と異なるリストになる
+  // (l_max は max_length_ か max_exit_length_ 以下なので，length_ladder_ の範囲に収まる)
+  if (l_min != min_length_ || l_min > l_max) {
+    impl::make_length_list(l_min, l_max, step_length_, result);
+    return;
+  }
+  // length_ladder_ は同じ順序で足し合わせて作っているため，l_max 未満の部分はそのまま使える
+  result.assign(length_ladder_.begin(),
+                std::lower_bound(length_ladder_.begin(), length_ladder_.end(), l_max));
+  result.push_back(l_max);
 }
 
 base::planner_type human_like::planner() {
   return [this](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
                 const obstacle_list& obs) {
-    // 障害物
-    const auto obstacles = obs.to_tree();
     // 移動可能領域
     impl::box_type area{min_pos_, max_pos_};
     // スタートからゴールまでのベクトル
@@ -38,13 +67,18 @@ base::planner_type human_like::planner() {
     const double l_max = std::min(max_length_, sg.norm());
     const double l_min = std::min(min_length_, l_max);
 
+    // 障害物
+    // rayの届く範囲にあるものだけを取り出し，配列にまとめて当たり判定を行う
+    obstacles_.clear();
+    obs.collect(detail::to_envelope(start, std::max(l_max, max_exit_length_)), obstacles_);
+
     // 方向と長さのリスト
-    const auto lengths = impl::make_length_list(l_min, l_max, step_length_);
-    const auto dirs    = impl::make_directions(
-        sg.norm() > 0.0 ? sg.normalized() : Eigen::Vector2d::UnitX(), direction_count_);
+    make_length_list(l_min, l_max, lengths_);
+    impl::make_directions(sg.norm() > 0.0 ? sg.normalized() : Eigen::Vector2d::UnitX(),
+                          rotations_, dirs_);
 
     // Human-Likeによる探索結果
-    const auto plan_result = impl::planned_position(start, dirs, lengths, obstacles, area);
+    const auto plan_result = impl::planned_position(start, dirs_, lengths_, obstacles_, area);
 
     // 最終的な結果
     Eigen::Vector2d result;
@@ -52,8 +86,9 @@ base::planner_type human_like::planner() {
       result = plan_result.value();
     } else {
       // 脱出
-      const auto exit_lengths = impl::make_length_list(l_min, max_exit_length_, step_length_);
-      const auto exit_p       = impl::exit_position(start, dirs, exit_lengths, obstacles, area);
+      make_length_list(l_min, max_exit_length_, exit_lengths_);
+      const auto exit_p =
+          impl::exit_position(start, dirs_, exit_lengths_, obstacles_, area, exit_buffer_);
 
       result = exit_p.value_or(
           // 最低でも min_length_ は進ませる
@@ -1,11 +1,18 @@
 #ifndef AI_SERVER_PLANNER_HUMAN_LIKE_H
 #define AI_SERVER_PLANNER_HUMAN_LIKE_H
 
+#include <vector>
+#include <Eigen/Core>
+
 #include "base.h"
+#include "detail/obstacle_arrays.h"
+#include "impl/human_like.h"
 
 namespace ai_server::planner {
 class human_like : public base {
 public:
+  human_like();
+
   /// @brief ロボットが進むことのできる方向の数を設定する
   /// @param count            設定値
   void set_direction_count(int count);
@@ -39,6 +46,24 @@ private:
   double min_length_ = 100.0;
   // 障害物エリアから脱出するときの最大距離
   double max_exit_length_ = 3000.0;
+
+  // 基準方向からrayを伸ばす方向への回転行列 (set_direction_count() で作り直す)
+  std::vector<Eigen::Matrix2d> rotations_;
+  // min_length_ から step_length_ 毎に並べた長さ (長さの設定が変わったときに作り直す)
+  std::vector<double> length_ladder_;
+
+  // 以下は呼び出し毎に中身を作り直す作業領域 (確保した領域を再利用する)
+  std::vector<Eigen::Vector2d> dirs_;
+  std::vector<double> lengths_;
+  std::vector<double> exit_lengths_;
+  detail::obstacle_arrays obstacles_;
+  impl::exit_buffer exit_buffer_;
+
+  // length_ladder_ を作り直す
+  void update_length_ladder();
+
+  // impl::make_length_list(l_min, l_max, step_length_, result) と同じリストを作る
+  void make_length_list(double l_min, double l_max, std::vector<double>& result) const;
 };
 } // namespace ai_server::planner
 
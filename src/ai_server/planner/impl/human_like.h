@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <optional>
+#include <tuple>
 #include <vector>
 #include <boost/geometry/algorithms/centroid.hpp>
 #include <boost/geometry/geometries/box.hpp>
@@ -16,62 +18,108 @@
 #include "ai_server/util/math/to_vector.h"
 #include "ai_server/planner/detail/clipping.h"
 #include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/detail/obstacle_arrays.h"
 #include "ai_server/planner/obstacle_list.h"
 
 namespace ai_server::planner::impl {
 using box_type     = boost::geometry::model::box<Eigen::Vector2d>;
 using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
 
-/// @brief rayを伸ばす方向のリストを作る
-/// @param dir                   基準方向
+/// @brief 基準方向からrayを伸ばす方向への回転行列のリストを作る
+///
+/// 基準方向に近いものから順に，+側と-側を交互に並べる
 /// @param dir_count             伸ばす方向の数
 /// @return 作成したリスト
-inline std::vector<Eigen::Vector2d> make_directions(const Eigen::Vector2d& dir, int dir_count) {
+inline std::vector<Eigen::Matrix2d> make_rotations(int dir_count) {
   // rayとrayの間の角度
   const double step = boost::math::constants::two_pi<double>() / dir_count;
 
   const int max     = dir_count / 2 + 1;
   const bool is_odd = dir_count % 2 > 0;
 
-  std::vector<Eigen::Vector2d> result;
+  std::vector<Eigen::Matrix2d> result;
   for (int i = 0; i < max; ++i) {
     Eigen::Rotation2D<double> rot{i * step};
     // +側
-    result.push_back(rot * dir);
+    result.push_back(rot.toRotationMatrix());
     // -側
     if (i > 0 && (is_odd || i + 1 < max)) {
-      result.push_back(rot.inverse() * dir);
+      result.push_back(rot.inverse().toRotationMatrix());
     }
   }
   return result;
 }
 
+/// @brief rayを伸ばす方向のリストを作る
+/// @param dir                   基準方向
+/// @param rotations             make_rotations(...)で作成したリスト
+/// @param result                作成したリストの格納先 (確保済みの領域を再利用する)
+inline void make_directions(const Eigen::Vector2d& dir,
+                            const std::vector<Eigen::Matrix2d>& rotations,
+                            std::vector<Eigen::Vector2d>& result) {
+  result.resize(rotations.size());
+  for (std::size_t i = 0; i < rotations.size(); ++i) {
+    result[i] = rotations[i] * dir;
+  }
+}
+
+/// @brief rayを伸ばす方向のリストを作る
+/// @param dir                   基準方向
+/// @param dir_count             伸ばす方向の数
+/// @return 作成したリスト
+inline std::vector<Eigen::Vector2d> make_directions(const Eigen::Vector2d& dir, int dir_count) {
+  std::vector<Eigen::Vector2d> result;
+  make_directions(dir, make_rotations(dir_count), result);
+  return result;
+}
+
 /// @brief rayを伸ばす長さのリストを作る
 /// @param l_min                 最小長さ
 /// @param l_max                 最大長さ
 /// @param l_step                １段階分の長さ
-/// @return 作成したリスト
-inline std::vector<double> make_length_list(double l_min, double l_max, double l_step) {
-  std::vector<double> result;
+/// @param result                作成したリストの格納先 (確保済みの領域を再利用する)
+inline void make_length_list(double l_min, double l_max, double l_step,
+                             std::vector<double>& result) {
+  result.clear();
   for (double l = l_min; l < l_max; l += l_step) {
     result.push_back(l);
   }
   if (l_min <= l_max) result.push_back(l_max);
+}
+
+/// @brief rayを伸ばす長さのリストを作る
+/// @param l_min                 最小長さ
+/// @param l_max                 最大長さ
+/// @param l_step                １段階分の長さ
+/// @return 作成したリスト
+inline std::vector<double> make_length_list(double l_min, double l_max, double l_step) {
+  std::vector<double> result;
+  make_length_list(l_min, l_max, l_step, result);
   return result;
 }
 
+/// exit_position(...) が呼び出し毎に使う作業領域
+struct exit_buffer {
+  // 方向，最小長さ，最大長さ
+  std::vector<std::tuple<Eigen::Vector2d, double, double>> rays;
+  // 脱出先からの距離リスト
+  std::vector<double> line_lengths;
+};
+
 /// @brief  Human-Likeアルゴリズムが使えないときの経路探索を行い，結果を返す
 /// @param start                 初期位置
 /// @param dirs                  make_directions(...)で作成したリスト
 /// @param lengths               make_length_list(...)で作成したリスト
 /// @param obstacles             障害物リスト
 /// @param area                  移動可能範囲
+/// @param buffer                作業領域 (確保済みの領域を再利用する)
 /// @return 経路探索の結果
+template <class Obstacles>
 inline std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start,
                                                     const std::vector<Eigen::Vector2d>& dirs,
                                                     const std::vector<double>& lengths,
-                                                    const obstacle_list::tree_type& obstacles,
-                                                    const box_type& area) {
+                                                    const Obstacles& obstacles,
+                                                    const box_type& area, exit_buffer& buffer) {
   // 候補がないとき
   if (dirs.empty() || lengths.empty()) return std::nullopt;
 
@@ -83,17 +131,17 @@ inline std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start
   { // 脱出先を探索
 
     // 方向，最小長さ，最大長さ
-    std::vector<std::tuple<Eigen::Vector2d, double, double>> rays;
+    auto& rays = buffer.rays;
+    rays.clear();
     // エリア内を通る範囲を調べる
     for (auto dir : dirs) {
       // 調査範囲の候補
       const segment_type line{start, start + lengths.back() * dir};
       // エリア内を通る部分を抽出
-      const auto inside_line = detail::clipped(line, area);
+      const auto inside_line = detail::clipped_by_box(line, area);
 
-      if (!inside_line.empty()) {
-        // 線分をboxでクリッピングすると，結果は１本以下の線分になる
-        const auto& [search_start, search_end] = inside_line.front();
+      if (inside_line) {
+        const auto& [search_start, search_end] = *inside_line;
         double min_length                      = (start - search_start).norm();
         double max_length                      = (start - search_end).norm();
 
@@ -126,7 +174,8 @@ inline std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start
   if (exit_length == lengths.end()) return std::nullopt;
 
   // 脱出先からの距離リスト
-  std::vector<double> line_lengths;
+  auto& line_lengths = buffer.line_lengths;
+  line_lengths.clear();
   {
     // 最大長さになりうる値を導いておく
     const auto max_length = std::partition_point(
@@ -151,6 +200,23 @@ inline std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start
              : exit_p + *std::prev(collied_l, 1) * exit_dir;
 }
 
+/// @brief  Human-Likeアルゴリズムが使えないときの経路探索を行い，結果を返す
+/// @param start                 初期位置
+/// @param dirs                  make_directions(...)で作成したリスト
+/// @param lengths               make_length_list(...)で作成したリスト
+/// @param obstacles             障害物リスト
+/// @param area                  移動可能範囲
+/// @return 経路探索の結果
+template <class Obstacles>
+inline std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start,
+                                                    const std::vector<Eigen::Vector2d>& dirs,
+                                                    const std::vector<double>& lengths,
+                                                    const Obstacles& obstacles,
+                                                    const box_type& area) {
+  exit_buffer buffer{};
+  return exit_position(start, dirs, lengths, obstacles, area, buffer);
+}
+
 /// @brief  何もできないときに進む先を返す
 /// @param start                 初期位置
 /// @param dir                   進みたい方向
@@ -176,10 +242,12 @@ inline Eigen::Vector2d default_position(const Eigen::Vector2d& start,
 /// @param obstacles             障害物リスト
 /// @param area                  移動可能範囲
 /// @return 経路探索の結果
-inline std::optional<Eigen::Vector2d> planned_position(
-    const Eigen::Vector2d& start, const std::vector<Eigen::Vector2d>& dirs,
-    const std::vector<double>& lengths, const obstacle_list::tree_type& obstacles,
-    const box_type& area) {
+template <class Obstacles>
+inline std::optional<Eigen::Vector2d> planned_position(const Eigen::Vector2d& start,
+                                                       const std::vector<Eigen::Vector2d>& dirs,
+                                                       const std::vector<double>& lengths,
+                                                       const Obstacles& obstacles,
+                                                       const box_type& area) {
   if ( // 障害物に当たっている
       detail::is_collided(start, obstacles) ||
       // 候補が無い
@@ -211,12 +279,11 @@ inline std::optional<Eigen::Vector2d> planned_position(
     // 調査範囲の候補
     const segment_type line{start + l_min * dir, start + max_length * dir};
     // エリア内を通る部分を抽出
-    const auto inside_line = detail::clipped(line, area);
+    const auto inside_line = detail::clipped_by_box(line, area);
 
     // エリア内に入っている部分が無い
-    if (inside_line.empty()) continue;
-    // 線分をboxでクリッピングすると，結果は１本以下の線分になる
-    const auto& [search_start, search_end] = inside_line.front();
+    if (!inside_line) continue;
+    const auto& [search_start, search_end] = *inside_line;
 
     // 探索範囲の最小値
     const auto first =
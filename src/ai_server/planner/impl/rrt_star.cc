@@ -1,27 +1,17 @@
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <limits>
 #include <random>
+#include <vector>
 #include <boost/geometry/algorithms/centroid.hpp>
 #include <boost/geometry/algorithms/intersection.hpp>
 #include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/detail/obstacle_arrays.h"
 #include "ai_server/util/math/geometry.h"
 #include "ai_server/util/math/to_vector.h"
 #include "rrt_star.h"
 
-// RTree用
-namespace boost::geometry::index {
-using node_ptr_t = std::shared_ptr<ai_server::planner::impl::rrt_star::node>;
-
-template <>
-struct indexable<node_ptr_t> {
-  using value_type  = node_ptr_t;
-  using result_type = const Eigen::Vector2d&;
-  result_type operator()(const value_type& v) const {
-    return v->position;
-  }
-};
-} // namespace boost::geometry::index
-
 namespace ai_server::planner::impl {
 
 using double_limits = std::numeric_limits<double>;
@@ -29,6 +19,8 @@ using double_limits = std::numeric_limits<double>;
 rrt_star::rrt_star()
     : node_count_(10),
       max_branch_length_(300.0),
+      max_node_count_(2000),
+      warm_start_(false),
       area_({double_limits::lowest(), double_limits::lowest()},
             {double_limits::max(), double_limits::max()}) {
   std::random_device rnd;
@@ -51,11 +43,27 @@ void rrt_star::set_max_branch_length(double length) {
   max_branch_length_ = length;
 }
 
+void rrt_star::set_seed(std::uint32_t seed) {
+  mt_.seed(seed);
+}
+
+void rrt_star::set_deadline(std::optional<clock_type::time_point> deadline) {
+  deadline_ = deadline;
+}
+
+void rrt_star::set_max_node_count(int count) {
+  max_node_count_ = count;
+}
+
+void rrt_star::set_warm_start(bool enable) {
+  warm_start_ = enable;
+}
+
 rrt_star::result_type rrt_star::execute(const Eigen::Vector2d& start_pos,
                                         const Eigen::Vector2d& goal_pos,
                                         const obstacle_list& obs) {
   // 障害物取得
-  const auto obstacles = obs.to_tree();
+  const auto obstacles = obs.index();
 
   // 障害物の圏内から脱出する必要があるとき
   if (auto p = exit_position(start_pos, goal_pos, max_branch_length_, obstacles)) {
@@ -69,91 +77,105 @@ rrt_star::result_type rrt_star::execute(const Eigen::Vector2d& start_pos,
 
   // === rrt star ===
 
-  // 探索木(nodeの集まり)
-  tree_t tree;
+  // 探索中は同じ障害物に対して何度も当たり判定を行うため，配列にまとめておく
+  auto& arrays = arrays_;
+  arrays.clear();
+  arrays.add(obstacles,
+             detail::envelope_type{{double_limits::lowest(), double_limits::lowest()},
+                                   {double_limits::max(), double_limits::max()}});
+
+  priority_points_ = {};
 
-  // 初期ノード追加
-  tree.insert(std::make_shared<node>(start_pos, 0.0, nullptr));
+  // 前回の探索木を引き継げなければ，探索木を空にして初期ノードを追加
+  if (!warm_start_ || !reroot(start_pos, arrays)) {
+    positions_.clear();
+    nodes_.clear();
+    add_node(start_pos, 0.0, no_parent);
+  }
+  // node_count_ 個は必ず作り, 時刻まで探索するときは max_node_count_ 個まで増やす
+  const auto min_nodes = nodes_.size() + std::max(node_count_, 0);
+  const auto max_nodes =
+      deadline_ ? std::max(static_cast<std::size_t>(std::max(max_node_count_, 1)), min_nodes)
+                : min_nodes;
+  positions_.reserve(max_nodes);
+  nodes_.reserve(max_nodes);
 
   // 基準半径
   const double r_a = 2000 / std::sqrt(std::log10(2.0) / 2.0);
 
-  for (int c = 0; c < node_count_; ++c) {
-    // 新しいノード
-    const auto new_node = make_node(goal_pos, max_branch_length_, obstacles, tree);
+  // 少なくとも node_count_ 回探索し，打ち切る時刻が設定されていればその時刻まで続ける
+  // (時刻を過ぎてから呼ばれても，経路を見つけられないまま終わらないようにする)
+  for (int c = 0; c < node_count_ || (deadline_ && clock_type::now() < *deadline_); ++c) {
+    if (nodes_.size() >= max_nodes) break;
 
-    // 近傍点リストを作る円の半径
-    const double r = r_a * std::sqrt(std::log10(c + 1) / (c + 1));
+    // 新しいノード
+    const auto new_node = make_node(goal_pos, max_branch_length_, arrays);
+    const auto np       = positions_[new_node];
 
-    // 先に大まかに絞り込むための範囲
-    const auto around = detail::to_envelope(new_node->position, r);
+    // 近傍点リストを作る円の半径 (根以外のノード数で決まる)
+    const double n = new_node;
+    const double r = r_a * std::sqrt(std::log10(n) / n);
 
     // 近傍点リスト
-    std::vector<std::weak_ptr<node>> list;
     // 半径と障害物でフィルタリング
-    tree.query(boost::geometry::index::within(around) &&
-                   boost::geometry::index::satisfies(
-                       [&obstacles, &np = new_node->position, r](const auto& a) {
-                         return (a->position - np).norm() < r &&
-                                !detail::is_collided(line_t{a->position, np}, obstacles);
-                       }),
-               std::back_inserter(list));
+    neighbours_.clear();
+    for (index_type i = 0; i < new_node; ++i) {
+      if ((positions_[i] - np).squaredNorm() < r * r &&
+          !arrays.is_collided(positions_[i], np)) {
+        neighbours_.push_back(i);
+      }
+    }
 
     // これまでの道と新しいノードからの道を比較してコスト低ならノード再接続
-    if (!list.empty()) {
+    if (!neighbours_.empty()) {
       const auto min = *std::min_element(
-          list.begin(), list.end(), [&np = new_node->position](const auto& a, const auto& b) {
-            return a.lock()->cost + (np - a.lock()->position).norm() <
-                   b.lock()->cost + (np - b.lock()->position).norm();
+          neighbours_.begin(), neighbours_.end(), [this, &np](auto a, auto b) {
+            return nodes_[a].cost + (np - positions_[a]).norm() <
+                   nodes_[b].cost + (np - positions_[b]).norm();
           });
 
       //コスト低ならノード再接続
-      const auto min_cost =
-          min.lock()->cost + (new_node->position - min.lock()->position).norm();
-      if (min_cost < new_node->cost) {
-        new_node->parent = min.lock();
-        new_node->cost   = min_cost;
+      const auto min_cost = nodes_[min].cost + (np - positions_[min]).norm();
+      if (min_cost < nodes_[new_node].cost) {
+        nodes_[new_node].parent = min;
+        nodes_[new_node].cost   = min_cost;
       }
     }
 
-    // treeに追加
-    tree.insert(new_node);
-
     // 他のノードから新たなノードに再接続
-    for (auto& a : list) {
-      const double cost = new_node->cost + (new_node->position - a.lock()->position).norm();
-      if (cost < a.lock()->cost) {
-        a.lock()->parent = new_node;
-        a.lock()->cost   = cost;
+    for (auto a : neighbours_) {
+      const double cost = nodes_[new_node].cost + (np - positions_[a]).norm();
+      if (cost < nodes_[a].cost) {
+        nodes_[a].parent = new_node;
+        nodes_[a].cost   = cost;
       }
     }
   }
 
   // 目標位置に最も近いノード
-  const auto nearest_node = tree.qbegin(boost::geometry::index::nearest(goal_pos, 1));
+  const auto nearest_node = nearest(goal_pos);
 
   double trajectory_length;
 
   // 目的地を探す。
-  const auto& p = [this, &nearest_node, &start_pos, &goal_pos, &obstacles,
-                   &trajectory_length]() {
+  const auto& p = [this, nearest_node, &start_pos, &goal_pos, &arrays, &trajectory_length]() {
     // 目的地とその一つ手前のノード間の距離を代入
-    trajectory_length = ((*nearest_node)->position - goal_pos).norm();
+    trajectory_length = (positions_[nearest_node] - goal_pos).norm();
 
     // スムージングした後の値を返す。
-    for (std::weak_ptr<node> n = *nearest_node; n.lock()->parent.lock(); n = n.lock()->parent) {
-      const auto& p = n.lock()->position;
+    for (auto n = nearest_node; nodes_[n].parent != no_parent; n = nodes_[n].parent) {
+      const auto& p = positions_[n];
       priority_points_.push(p);
 
       // それぞれのノード間の距離を積分
-      trajectory_length += (p - n.lock()->parent.lock()->position).norm();
+      trajectory_length += (p - positions_[nodes_[n].parent]).norm();
 
       // スタート地点とノード間に障害物が無くなったとき
-      if (!detail::is_collided(line_t{start_pos, p}, obstacles)) {
+      if (!arrays.is_collided(start_pos, p)) {
         // スタート地点とノード間の距離を加算
         trajectory_length += (p - start_pos).norm();
 
-        return n.lock()->position;
+        return p;
       }
     }
     // start_posを指定し続ける
@@ -166,16 +188,25 @@ rrt_star::result_type rrt_star::execute(const Eigen::Vector2d& start_pos,
 
 std::optional<Eigen::Vector2d> rrt_star::exit_position(
     const Eigen::Vector2d& start, const Eigen::Vector2d& goal, double d,
-    const obstacle_list::tree_type& obstacles) const {
-  const auto collided_itr = detail::extract_collisions(obstacles, start);
+    const obstacle_list::index_type& obstacles) const {
+  std::vector<obstacle_list::element_type> collisions;
+  detail::extract_collisions(obstacles, start, std::back_inserter(collisions));
 
   // 衝突する障害物がない
-  if (collided_itr == obstacles.qend()) {
+  if (collisions.empty()) {
     // field外のとき
     if (!boost::geometry::within(start, area_)) {
       return Eigen::Vector2d::Zero();
     }
 
+    // 動かない障害物の距離場の中にいるときは，距離が大きくなる方向へ
+    if (obstacles.field && obstacles.field->is_collided(start)) {
+      const auto g = obstacles.field->gradient(start);
+      // 複数の辺から等距離で方向が決まらないときは，フィールドの中心へ
+      if (g.isZero()) return boost::geometry::return_centroid<point_t>(area_);
+      return start + d * g;
+    }
+
     // 障害物から離れる必要がない
     return std::nullopt;
   }
@@ -187,8 +218,8 @@ std::optional<Eigen::Vector2d> rrt_star::exit_position(
   };
 
   // 最も近い要素を探す
-  const auto nearest = *std::min_element(
-      collided_itr, obstacles.qend(), [&obstacle_distance](const auto& a, const auto& b) {
+  const auto& nearest = *std::min_element(
+      collisions.begin(), collisions.end(), [&obstacle_distance](const auto& a, const auto& b) {
         return obstacle_distance(std::get<1>(a)) < obstacle_distance(std::get<1>(b));
       });
 
@@ -272,10 +303,122 @@ std::optional<Eigen::Vector2d> rrt_star::exit_position(
   return std::nullopt;
 }
 
-std::shared_ptr<rrt_star::node> rrt_star::make_node(const Eigen::Vector2d& goal,
-                                                    double max_branch_length,
-                                                    const obstacle_list::tree_type& obstacles,
-                                                    const tree_t& tree) {
+bool rrt_star::reroot(const Eigen::Vector2d& start, const detail::obstacle_arrays& obstacles) {
+  enum : std::uint8_t { unknown, visiting, kept, pruned };
+
+  const auto size = static_cast<index_type>(nodes_.size());
+  if (size == 0) return false;
+
+  // 新しい根から直接見える，最も近いノード
+  auto first      = no_parent;
+  double min_dist = double_limits::max();
+  for (index_type i = 0; i < size; ++i) {
+    const double d = (positions_[i] - start).squaredNorm();
+    if (d < min_dist && !obstacles.is_collided(positions_[i]) &&
+        !obstacles.is_collided(start, positions_[i])) {
+      first    = i;
+      min_dist = d;
+    }
+  }
+  if (first == no_parent) return false;
+
+  // first から古い根までの親子関係を逆にし，新しい根 (番号 size) の子にする
+  const auto root = add_node(start, 0.0, no_parent);
+  for (auto prev = root, n = first; n != no_parent;) {
+    const auto next  = nodes_[n].parent;
+    nodes_[n].parent = prev;
+    prev             = n;
+    n                = next;
+  }
+
+  // 根まで障害物に当たらずに辿れるノードを残し，コストを計算し直す
+  states_.assign(nodes_.size(), unknown);
+  costs_.assign(nodes_.size(), 0.0);
+  states_[root] = kept;
+  for (index_type i = 0; i < size; ++i) {
+    // 状態の分かっているノードまで親を辿る
+    stack_.clear();
+    auto n = i;
+    while (states_[n] == unknown) {
+      states_[n] = visiting;
+      stack_.push_back(n);
+      n = nodes_[n].parent;
+    }
+    // 親子関係が閉路になっていたときは，閉路ごと取り除く
+    const bool cycle = states_[n] == visiting;
+
+    // 根に近い方から決めていく
+    for (auto it = stack_.rbegin(); it != stack_.rend(); ++it) {
+      const auto m = *it;
+      const auto p = nodes_[m].parent;
+      const auto& pos = positions_[m];
+      if (cycle || states_[p] == pruned || !boost::geometry::within(pos, area_) ||
+          obstacles.is_collided(pos) || obstacles.is_collided(positions_[p], pos)) {
+        states_[m] = pruned;
+      } else {
+        states_[m] = kept;
+        costs_[m]  = costs_[p] + (pos - positions_[p]).norm();
+      }
+    }
+  }
+
+  // 残すノードが多すぎるときは，コストの大きいものから捨てる
+  // 子のコストは親より小さくならないため，部分木ごと捨てることになる
+  const auto limit = static_cast<std::size_t>(std::max(max_node_count_ / 2, 1));
+  stack_.clear();
+  for (index_type i = 0; i < nodes_.size(); ++i) {
+    if (states_[i] == kept) stack_.push_back(i);
+  }
+  if (stack_.size() > limit) {
+    std::nth_element(stack_.begin(), stack_.begin() + limit, stack_.end(),
+                     [this](auto a, auto b) { return costs_[a] < costs_[b]; });
+    const double threshold = costs_[stack_[limit]];
+    for (index_type i = 0; i < nodes_.size(); ++i) {
+      if (i != root && costs_[i] >= threshold) states_[i] = pruned;
+    }
+  }
+
+  // 残すノードを前に詰める (番号の対応は stack_ に持つ)
+  stack_.assign(nodes_.size(), no_parent);
+  index_type count = 0;
+  for (index_type i = 0; i < nodes_.size(); ++i) {
+    if (states_[i] == kept) stack_[i] = count++;
+  }
+  for (index_type i = 0; i < nodes_.size(); ++i) {
+    const auto j = stack_[i];
+    if (j == no_parent) continue;
+    const auto p  = nodes_[i].parent;
+    positions_[j] = positions_[i];
+    nodes_[j]     = {costs_[i], p == no_parent ? no_parent : stack_[p]};
+  }
+  positions_.resize(count);
+  nodes_.resize(count);
+
+  return true;
+}
+
+rrt_star::index_type rrt_star::add_node(const Eigen::Vector2d& position, double cost,
+                                        index_type parent) {
+  positions_.push_back(position);
+  nodes_.push_back({cost, parent});
+  return static_cast<index_type>(nodes_.size() - 1);
+}
+
+rrt_star::index_type rrt_star::nearest(const Eigen::Vector2d& p) const {
+  index_type result = 0;
+  double min        = double_limits::max();
+  for (index_type i = 0; i < positions_.size(); ++i) {
+    const double d = (positions_[i] - p).squaredNorm();
+    if (d < min) {
+      result = i;
+      min    = d;
+    }
+  }
+  return result;
+}
+
+rrt_star::index_type rrt_star::make_node(const Eigen::Vector2d& goal, double max_branch_length,
+                                         const detail::obstacle_arrays& obstacles) {
   // ランダム点の分布
   constexpr double rand_margin = 1000.0;
   const boost::random::uniform_real_distribution<> rand_x{area_.min_corner().x() - rand_margin,
@@ -314,22 +457,19 @@ std::shared_ptr<rrt_star::node> rrt_star::make_node(const Eigen::Vector2d& goal,
     }();
 
     // 最も近い点
-    const auto nearest_node = tree.qbegin(boost::geometry::index::nearest(sample, 1));
+    const auto nearest_node = nearest(sample);
+    const auto nearest_p    = positions_[nearest_node];
 
     // 同じ点だったら却下
-    if (!boost::geometry::equals(sample, (*nearest_node)->position)) {
+    if (!boost::geometry::equals(sample, nearest_p)) {
       // 最も近い点から一定距離を置いて点を打ち、コースに障害物がないことを確認
-      const auto new_p = to_new_p((*nearest_node)->position, sample);
+      const auto new_p = to_new_p(nearest_p, sample);
 
-      if (!detail::is_collided(new_p, obstacles) && boost::geometry::within(new_p, area_)) {
-        return std::make_shared<node>(
-            new_p, (*nearest_node)->cost + (new_p - (*nearest_node)->position).norm(),
-            *nearest_node);
+      if (!obstacles.is_collided(new_p) && boost::geometry::within(new_p, area_)) {
+        return add_node(new_p, nodes_[nearest_node].cost + (new_p - nearest_p).norm(),
+                        nearest_node);
       }
     }
   }
 }
-
-rrt_star::node::node(const Eigen::Vector2d& pos, double c, const std::shared_ptr<node>& ptr)
-    : position(pos), cost(c), parent(ptr) {}
 } // namespace ai_server::planner::impl
@@ -1,9 +1,12 @@
 #ifndef AI_SERVER_PLANNER_IMPL_RRT_STAR_H
 #define AI_SERVER_PLANNER_IMPL_RRT_STAR_H
 
-#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <queue>
+#include <vector>
 #include <boost/geometry/algorithms/distance.hpp>
 #include <boost/geometry/geometries/box.hpp>
 #include <boost/geometry/geometries/segment.hpp>
@@ -11,21 +14,26 @@
 #include <Eigen/Core>
 
 #include "ai_server/util/math/geometry_traits.h"
+#include "ai_server/planner/detail/obstacle_arrays.h"
 #include "ai_server/planner/obstacle_list.h"
 
 namespace ai_server::planner::impl {
 class rrt_star {
 public:
-  // 節点
-  struct node {
-    Eigen::Vector2d position;   // 座標
-    double cost;                // 親ノードまでに必要なコスト
-    std::weak_ptr<node> parent; // 親ノードを指すポインタ
+  // ノードの番号
+  using index_type = std::uint32_t;
+
+  // 親ノードが無いことを表す番号
+  static constexpr index_type no_parent = std::numeric_limits<index_type>::max();
 
-    node(const Eigen::Vector2d& pos, double c, const std::shared_ptr<node>& ptr);
+  // 節点 (座標は positions_ に別に持つ)
+  struct node {
+    double cost;       // 親ノードまでに必要なコスト
+    index_type parent; // 親ノードの番号
   };
 
   using result_type = std::pair<Eigen::Vector2d, double>;
+  using clock_type  = std::chrono::steady_clock;
 
   rrt_star();
 
@@ -45,6 +53,28 @@ public:
   /// @param length 設定値．
   void set_max_branch_length(double length);
 
+  /// @brief 乱数シードを設定する
+  /// @param seed 設定値．
+  void set_seed(std::uint32_t seed);
+
+  /// @brief 探索を打ち切る時刻を設定する
+  ///
+  /// 設定すると node_count 回の探索の後も, 時刻になるまで (最大 max_node_count まで) 探索木を
+  /// 伸ばし続ける. std::nullopt を渡すと node_count 回で打ち切る
+  /// @param deadline 設定値．
+  void set_deadline(std::optional<clock_type::time_point> deadline);
+
+  /// @brief 探索木のノード数の上限を設定する
+  /// @param count 設定値．
+  void set_max_node_count(int count);
+
+  /// @brief 前回の探索木を引き継ぐかを設定する
+  ///
+  /// 引き継ぐときは, 前回の探索木を新しい初期位置に根を付け替え,
+  /// 新しい障害物に当たるノードと枝を取り除いてから探索を続ける
+  /// @param enable 設定値．
+  void set_warm_start(bool enable);
+
   result_type execute(const Eigen::Vector2d& start_pos, const Eigen::Vector2d& goal_pos,
                       const obstacle_list& obs);
 
@@ -52,8 +82,6 @@ private:
   using point_t = Eigen::Vector2d;
   using box_t   = boost::geometry::model::box<point_t>;
   using line_t  = boost::geometry::model::segment<point_t>;
-  using tree_t =
-      boost::geometry::index::rtree<std::shared_ptr<node>, boost::geometry::index::rstar<20>>;
 
   // サンプル取得時用の乱数生成器(処理速度が優れているため，boostのものを使用)
   mutable boost::random::mt19937 mt_;
@@ -64,12 +92,47 @@ private:
   // 伸ばす枝の最大距離
   double max_branch_length_;
 
+  // 探索を打ち切る時刻
+  std::optional<clock_type::time_point> deadline_;
+
+  // 探索木のノード数の上限
+  int max_node_count_;
+
+  // 前回の探索木を引き継ぐか
+  bool warm_start_;
+
   // 移動可能領域
   detail::envelope_type area_;
 
   // あるループで生成された最適なルート木，次ループで優先して探索
   std::queue<Eigen::Vector2d> priority_points_;
 
+  // 探索木
+  // execute() の度に先頭から積み直し，確保した領域は次の execute() でも使う
+  // ノード i の座標は positions_[i]，コストと親は nodes_[i]
+  std::vector<Eigen::Vector2d> positions_;
+  std::vector<node> nodes_;
+  // 近傍点リスト (execute() 内で使い回す)
+  std::vector<index_type> neighbours_;
+  // 当たり判定用の障害物 (execute() 内で使い回す)
+  detail::obstacle_arrays arrays_;
+  // 根の付け替えに使う作業領域 (reroot() 内で使い回す)
+  std::vector<std::uint8_t> states_;
+  std::vector<index_type> stack_;
+  std::vector<double> costs_;
+
+  /// @brief  探索木にノードを追加する
+  index_type add_node(const Eigen::Vector2d& position, double cost, index_type parent);
+
+  /// @brief  前回の探索木の根を start に付け替え，障害物に当たる部分を取り除く
+  /// @param  start      新しい根の位置
+  /// @param  obstacles  障害物
+  /// @return 付け替えられたか (できなければ探索木は空になる)
+  bool reroot(const Eigen::Vector2d& start, const detail::obstacle_arrays& obstacles);
+
+  /// @brief  探索木の中で p に最も近いノードを探す
+  index_type nearest(const Eigen::Vector2d& p) const;
+
   /// @brief  障害物から離れる必要がある時，移動先を求める
   /// @param  start   初期位置
   /// @param  goal    目標位置
@@ -77,16 +140,15 @@ private:
   //  @param  obstacles 障害物
   std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start,
                                                const Eigen::Vector2d& goal, double d,
-                                               const obstacle_list::tree_type& obstacles) const;
+                                               const obstacle_list::index_type& obstacles) const;
 
-  /// @brief  あるエリアの範囲内で新規のノードを作成する
+  /// @brief  あるエリアの範囲内で新規のノードを作成し，探索木に追加する
   /// @param  goal               最終目的地
   /// @param  max_branch_length  ノード間長さの最大値
   /// @param  obstacles          障害物
-  /// @param  tree               探索木
-  std::shared_ptr<node> make_node(const Eigen::Vector2d& goal, double max_branch_length,
-                                  const obstacle_list::tree_type& obstacles,
-                                  const tree_t& tree);
+  /// @return 追加したノードの番号
+  index_type make_node(const Eigen::Vector2d& goal, double max_branch_length,
+                       const detail::obstacle_arrays& obstacles);
 };
 } // namespace ai_server::planner::impl
 
@@ -0,0 +1,112 @@
+#ifndef AI_SERVER_PLANNER_IMPL_VELOCITY_OBSTACLE_H
+#define AI_SERVER_PLANNER_IMPL_VELOCITY_OBSTACLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/moving_point.h"
+#include "ai_server/planner/detail/obstacle_arrays.h"
+#include "ai_server/planner/detail/ray_intersection.h"
+
+namespace ai_server::planner::impl {
+
+/// 時刻付きの軌道上の点
+struct trajectory_point {
+  double time;              // 計画開始からの時刻 [s]
+  Eigen::Vector2d position; // 位置 [mm]
+  Eigen::Vector2d velocity; // 速度 [mm/s]
+};
+
+/// @brief 初速度 v0 から加速度 a_max 以下で速度 v1 に向かい，その後は等速で進むときの状態
+/// @param p0     初期位置
+/// @param v0     初速度
+/// @param v1     目標速度
+/// @param a_max  最大加速度
+/// @param t      時刻
+/// @return       時刻 t での位置と速度
+inline std::pair<Eigen::Vector2d, Eigen::Vector2d> constant_acceleration_state(
+    const Eigen::Vector2d& p0, const Eigen::Vector2d& v0, const Eigen::Vector2d& v1,
+    double a_max, double t) {
+  const Eigen::Vector2d dv = v1 - v0;
+  const double dv_norm     = dv.norm();
+  // 目標速度に達するまでの時間
+  const double t_a = a_max > 0.0 ? dv_norm / a_max : 0.0;
+
+  if (t < t_a) {
+    const Eigen::Vector2d a = dv / t_a;
+    return {p0 + v0 * t + 0.5 * a * t * t, v0 + a * t};
+  }
+  return {p0 + 0.5 * (v0 + v1) * t_a + v1 * (t - t_a), v1};
+}
+
+/// @brief 時間 dt の間に，点が a から b へ，障害物が q から q + u * dt へ等速で動くとき，
+///        初めて距離が r 未満になるまでの時間
+///        初めから距離が r 未満のときは，近づく向きに動く場合だけ当たったとする
+/// @return 当たるまでの時間 (当たらないときは detail::no_intersection)
+inline double time_to_collision(const Eigen::Vector2d& a, const Eigen::Vector2d& b,
+                                const Eigen::Vector2d& q, const Eigen::Vector2d& u, double r,
+                                double dt) {
+  // 障害物から見た点の相対運動
+  const Eigen::Vector2d s = a - q;
+  const Eigen::Vector2d w = (b - a) / dt - u;
+
+  // 初期位置が障害物の中にあるときは，近づかない動きなら当たらないとする
+  if (s.squaredNorm() < r * r) return s.dot(w) < 0.0 ? 0.0 : detail::no_intersection;
+
+  const double speed = w.norm();
+  if (speed == 0.0) return detail::no_intersection;
+
+  const double l = detail::ray_circle(s.x(), s.y(), w.x() / speed, w.y() / speed, 0.0, 0.0, r);
+  const double t = l / speed;
+  return t < dt ? t : detail::no_intersection;
+}
+
+/// @brief 軌道が初めて障害物に当たるまでの時間を求める
+/// @param p0        初期位置
+/// @param v0        初速度
+/// @param v1        目標速度
+/// @param a_max     最大加速度
+/// @param horizon   調べる時間
+/// @param dt        調べる時間の刻み幅
+/// @param statics   静止した障害物
+/// @param moving    移動する障害物
+/// @param area      移動可能領域
+/// @return          当たるまでの時間 (horizon 内で当たらないときは detail::no_intersection)
+template <class Box>
+inline double trajectory_collision_time(const Eigen::Vector2d& p0, const Eigen::Vector2d& v0,
+                                        const Eigen::Vector2d& v1, double a_max,
+                                        double horizon, double dt,
+                                        const detail::obstacle_arrays& statics,
+                                        const std::vector<model::obstacle::moving_point>& moving,
+                                        const Box& area) {
+  auto a = p0;
+  for (double t = 0.0; t < horizon; t += dt) {
+    const auto b = constant_acceleration_state(p0, v0, v1, a_max, t + dt).first;
+
+    // 移動可能領域の外に出る
+    if ((b.array() < area.min_corner().array()).any() ||
+        (b.array() > area.max_corner().array()).any()) {
+      return t + dt;
+    }
+
+    // 静止した障害物 (初期位置が障害物の中にあるときは，出るまでの区間を許す)
+    if (!statics.is_collided(a) && statics.is_collided(a, b)) return t;
+
+    // 移動する障害物 (区間内では双方とも等速とみなす)
+    double hit = detail::no_intersection;
+    for (const auto& o : moving) {
+      hit = std::min(
+          hit, time_to_collision(a, b, o.geometry + o.velocity * t, o.velocity, o.margin, dt));
+    }
+    if (hit < detail::no_intersection) return t + hit;
+
+    a = b;
+  }
+  return detail::no_intersection;
+}
+} // namespace ai_server::planner::impl
+
+#endif // AI_SERVER_PLANNER_IMPL_VELOCITY_OBSTACLE_H
@@ -1,6 +1,7 @@
 #ifndef AI_SERVER_PLANNER_OBSTACLE_LIST_H
 #define AI_SERVER_PLANNER_OBSTACLE_LIST_H
 
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -11,9 +12,11 @@
 #include <Eigen/Core>
 
 #include "ai_server/model/obstacle/box.h"
+#include "ai_server/model/obstacle/moving_point.h"
 #include "ai_server/model/obstacle/point.h"
 #include "ai_server/model/obstacle/segment.h"
 #include "detail/geometry_helper.h"
+#include "detail/obstacle_arrays.h"
 #include "detail/obstacle_tree.h"
 
 namespace ai_server::planner {
@@ -24,9 +27,19 @@ public:
   using element_type = typename tree_type::value_type;
   // std::variant<ObstacleTypes...>
   using obstacle_type = typename element_type::second_type;
+  // 共有されたRTreeと，freeze()後に追加された障害物のRTreeの組
+  using index_type = detail::layered_tree<model::obstacle::point, model::obstacle::segment,
+                                          model::obstacle::box>;
 
 private:
+  // freeze()で構築された, コピー間で共有されるRTree
+  std::shared_ptr<const tree_type> shared_;
+  // freeze()後に追加された障害物
   std::vector<element_type> buffer_;
+  // 移動する障害物
+  std::vector<model::obstacle::moving_point> moving_;
+  // 動かない障害物の距離場
+  std::shared_ptr<const detail::distance_field> field_;
 
 public:
   /// @brief リストに障害物を追加する
@@ -39,14 +52,86 @@ public:
     buffer_.emplace_back(std::move(env), std::move(o));
   }
 
-  /// @brief 内部データを取得する
+  /// @brief 動かない障害物 (ペナルティエリアなど) の距離場を設定する
+  ///
+  /// 距離場の障害物は RTree には含まれず，格子から距離を引いて当たり判定を行う
+  /// @param field 距離場 (detail::distance_field::cached() で作ったもの)
+  void set_static(std::shared_ptr<const detail::distance_field> field) {
+    field_ = std::move(field);
+  }
+
+  /// @brief 動かない障害物の距離場を取得する
+  const std::shared_ptr<const detail::distance_field>& static_field() const {
+    return field_;
+  }
+
+  /// @brief リストに移動する障害物を追加する
+  ///
+  /// 移動する障害物は RTree には含まれず，時間を考慮する planner だけが参照する
+  /// @param 追加する障害物
+  void add_moving(const model::obstacle::moving_point& o) {
+    moving_.push_back(o);
+  }
+
+  /// @brief 移動する障害物を取得する
+  const std::vector<model::obstacle::moving_point>& moving() const {
+    return moving_;
+  }
+
+  /// @brief 内部データ (freeze()後に追加された障害物) を取得する
   const std::vector<element_type>& buffer() const {
     return buffer_;
   }
 
-  /// @brief RTreeを構築して返す
+  /// @brief これまでに追加された障害物からRTreeを構築し，コピー間で共有する
+  ///
+  /// フィールドや相手ロボットなど，全てのロボットに共通する障害物を追加した後に呼ぶ．
+  /// 以降のコピーはRTreeを共有するため，ロボット毎に障害物を追加しても
+  /// RTreeの再構築は追加された分だけで済む
+  void freeze() {
+    if (buffer_.empty()) return;
+    if (shared_) buffer_.insert(buffer_.end(), shared_->begin(), shared_->end());
+    // packing algorithm で一括構築する
+    shared_ = std::make_shared<const tree_type>(buffer_.begin(), buffer_.end());
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+  }
+
+  /// @brief 障害物の数を取得する
+  std::size_t size() const {
+    return (shared_ ? shared_->size() : 0) + buffer_.size();
+  }
+
+  /// @brief 共有されたRTreeと，freeze()後に追加された障害物のRTreeを返す
+  index_type index() const {
+    return {shared_, tree_type{buffer_.begin(), buffer_.end()}, field_};
+  }
+
+  /// @brief 範囲内にかかる障害物 (距離場を含む) を全て配列に追加する
+  ///
+  /// index() と異なり freeze()後に追加された障害物のRTreeを作らないため，メモリを確保しない
+  /// @param area   範囲
+  /// @param arrays 追加先
+  void collect(const detail::envelope_type& area, detail::obstacle_arrays& arrays) const {
+    if (shared_) arrays.add(*shared_, area);
+    arrays.add(buffer_.begin(), buffer_.end(), area);
+    if (field_) arrays.set_field(field_);
+  }
+
+  /// @brief 全ての障害物 (距離場の障害物を含む) を含むRTreeを構築して返す
   tree_type to_tree() const {
-    return {buffer_.begin(), buffer_.end()};
+    if (!shared_ && !field_) return {buffer_.begin(), buffer_.end()};
+    std::vector<element_type> elements{};
+    if (shared_) elements.assign(shared_->begin(), shared_->end());
+    elements.insert(elements.end(), buffer_.begin(), buffer_.end());
+    if (field_) {
+      for (const auto& o : field_->obstacles()) {
+        auto env = std::visit(
+            [](auto&& arg) { return detail::to_envelope(arg.geometry, arg.margin); }, o);
+        elements.emplace_back(std::move(env), o);
+      }
+    }
+    return {elements.begin(), elements.end()};
   }
 };
 } // namespace ai_server::planner
@@ -1,4 +1,5 @@
-#include "impl/rrt_star.h"
+#include <utility>
+
 #include "rrt_star.h"
 
 namespace ai_server::planner {
@@ -13,15 +14,33 @@ void rrt_star::set_max_branch_length(double length) {
   max_branch_length_ = length;
 }
 
+void rrt_star::set_seed(std::uint32_t seed) {
+  seed_ = seed;
+}
+
+void rrt_star::set_deadline(std::chrono::steady_clock::time_point deadline) {
+  deadline_ = deadline;
+}
+
+void rrt_star::set_max_node_count(int count) {
+  rrt_.set_max_node_count(count);
+}
+
+void rrt_star::set_warm_start(bool enable) {
+  rrt_.set_warm_start(enable);
+}
+
 base::planner_type rrt_star::planner() {
   return [this](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
                 const obstacle_list& obs) {
-    impl::rrt_star rrt{};
-    rrt.set_max_pos(max_pos_);
-    rrt.set_min_pos(min_pos_);
-    rrt.set_node_count(node_count_);
-    rrt.set_max_branch_length(max_branch_length_);
-    return rrt.execute(start, goal, obs);
+    rrt_.set_max_pos(max_pos_);
+    rrt_.set_min_pos(min_pos_);
+    rrt_.set_node_count(node_count_);
+    rrt_.set_max_branch_length(max_branch_length_);
+    if (seed_) rrt_.set_seed(*seed_);
+    // 打ち切る時刻はその周期の探索にだけ使う
+    rrt_.set_deadline(std::exchange(deadline_, std::nullopt));
+    return rrt_.execute(start, goal, obs);
   };
 }
 } // namespace ai_server::planner
@@ -1,7 +1,12 @@
 #ifndef AI_SERVER_PLANNER_RRT_STAR_H
 #define AI_SERVER_PLANNER_RRT_STAR_H
 
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
 #include "base.h"
+#include "impl/rrt_star.h"
 
 namespace ai_server::planner {
 class rrt_star : public base {
@@ -16,6 +21,24 @@ public:
   /// @param length 設定値．
   void set_max_branch_length(double length);
 
+  /// @brief 乱数シードを設定する (設定しなければ毎回 std::random_device で初期化する)
+  /// @param seed 設定値．
+  void set_seed(std::uint32_t seed) override;
+
+  /// @brief 探索を打ち切る時刻を設定する
+  ///
+  /// 設定すると次の1回の探索は node_count 回の探索の後も, 時刻になるまで探索木を伸ばし続ける
+  /// @param deadline 設定値．
+  void set_deadline(std::chrono::steady_clock::time_point deadline) override;
+
+  /// @brief 探索木のノード数の上限を設定する
+  /// @param count 設定値．
+  void set_max_node_count(int count);
+
+  /// @brief 前回の探索木を引き継ぐかを設定する
+  /// @param enable 設定値．
+  void set_warm_start(bool enable);
+
   base::planner_type planner() override;
 
 private:
@@ -24,6 +47,15 @@ private:
 
   // 伸ばす枝の最大距離
   double max_branch_length_;
+
+  // 乱数シード
+  std::optional<std::uint32_t> seed_;
+
+  // 探索を打ち切る時刻
+  std::optional<std::chrono::steady_clock::time_point> deadline_;
+
+  // 探索木の領域を呼び出し毎に確保し直さないよう，planner が持ち続ける
+  impl::rrt_star rrt_;
 };
 } // namespace ai_server::planner
 
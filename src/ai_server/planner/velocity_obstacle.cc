@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <boost/geometry/geometries/segment.hpp>
+
+#include "ai_server/planner/detail/geometry_helper.h"
+#include "impl/human_like.h"
+#include "velocity_obstacle.h"
+
+namespace ai_server::planner {
+
+using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
+
+// 最大速度と最大加速度の初期値は controller::detail::velocity_generator に合わせる
+velocity_obstacle::velocity_obstacle()
+    : max_velocity_(3000.0),
+      max_acceleration_(5000.0),
+      horizon_(1.5),
+      step_(0.05),
+      direction_count_(16),
+      speed_count_(4),
+      collision_weight_(2000.0),
+      last_velocity_(Eigen::Vector2d::Zero()),
+      direct_(true) {}
+
+void velocity_obstacle::set_max_velocity(double v) {
+  max_velocity_ = v;
+}
+
+void velocity_obstacle::set_max_acceleration(double a) {
+  max_acceleration_ = a;
+}
+
+void velocity_obstacle::set_horizon(double horizon, double step) {
+  horizon_ = horizon;
+  step_    = step;
+}
+
+void velocity_obstacle::set_candidate_count(int direction_count, int speed_count) {
+  direction_count_ = direction_count;
+  speed_count_     = speed_count;
+}
+
+void velocity_obstacle::set_collision_weight(double weight) {
+  collision_weight_ = weight;
+}
+
+void velocity_obstacle::set_current_velocity(const Eigen::Vector2d& v) {
+  current_velocity_ = v;
+}
+
+const velocity_obstacle::trajectory_type& velocity_obstacle::trajectory() const {
+  return trajectory_;
+}
+
+std::optional<Eigen::Vector2d> velocity_obstacle::velocity_at(double t) const {
+  if (direct_ || trajectory_.empty()) return std::nullopt;
+
+  // t を挟む2点の間で線形補間する
+  const auto it = std::find_if(trajectory_.cbegin(), trajectory_.cend(),
+                               [t](const auto& s) { return s.time >= t; });
+  if (it == trajectory_.cend()) return trajectory_.back().velocity;
+  if (it == trajectory_.cbegin()) return it->velocity;
+  const auto& a = *std::prev(it);
+  const double r = (t - a.time) / (it->time - a.time);
+  return Eigen::Vector2d{a.velocity + r * (it->velocity - a.velocity)};
+}
+
+base::planner_type velocity_obstacle::planner() {
+  return [this](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
+                const obstacle_list& obs) {
+    // 移動可能領域
+    const detail::envelope_type area{min_pos_, max_pos_};
+
+    // 現在の速度 (設定されていなければ前回選んだ速度)
+    const Eigen::Vector2d v0 = current_velocity_.value_or(last_velocity_);
+    current_velocity_.reset();
+
+    // 目標で止まれる速さで目標に向かう速度を，最も望ましい速度とする
+    const Eigen::Vector2d sg = goal - start;
+    const double d           = sg.norm();
+    const Eigen::Vector2d dir = d > 0.0 ? Eigen::Vector2d{sg / d} : Eigen::Vector2d::UnitX();
+    const Eigen::Vector2d v_pref =
+        std::min(max_velocity_, std::sqrt(2.0 * max_acceleration_ * d)) * dir;
+
+    // 予測する時間内に届く範囲と，目標までの直線にかかる障害物
+    const double reach = std::max(max_velocity_, v0.norm()) * horizon_;
+    arrays_.clear();
+    arrays_.add(obs.index(), detail::to_envelope(segment_type{start, goal}, reach));
+    const auto& moving = obs.moving();
+
+    // 速度の候補
+    candidates_.clear();
+    candidates_.push_back(v_pref);
+    candidates_.push_back(Eigen::Vector2d::Zero());
+    if (v0.norm() <= max_velocity_) candidates_.push_back(v0);
+    for (const auto& u : impl::make_directions(dir, direction_count_)) {
+      for (int k = 1; k <= speed_count_; ++k) {
+        candidates_.push_back(u * (max_velocity_ * k / speed_count_));
+      }
+    }
+
+    // 最もコストの小さい候補を選ぶ
+    // コストが同じ (どれも当たる) ときは，当たるまでの時間が長い方を選ぶ
+    auto best_v      = v_pref;
+    double best_cost = std::numeric_limits<double>::infinity();
+    double best_tc   = -1.0;
+    for (const auto& v : candidates_) {
+      const double tc = impl::trajectory_collision_time(start, v0, v, max_acceleration_,
+                                                        horizon_, step_, arrays_, moving, area);
+      const double cost = (v - v_pref).norm() + collision_weight_ / tc;
+      if (cost < best_cost || (cost == best_cost && tc > best_tc)) {
+        best_v    = v;
+        best_cost = cost;
+        best_tc   = tc;
+      }
+    }
+    last_velocity_ = best_v;
+
+    // 選んだ速度の軌道を時刻付きで保存する
+    trajectory_.clear();
+    for (double t = 0.0; t <= horizon_ + 0.5 * step_; t += step_) {
+      const auto [p, v] =
+          impl::constant_acceleration_state(start, v0, best_v, max_acceleration_, t);
+      trajectory_.push_back({t, p, v});
+    }
+
+    // 目標まで直進でき，目標に向かう速度で当たらなければ目標を，そうでなければ軌道の終点を返す
+    direct_ = best_v == v_pref && best_tc == detail::no_intersection &&
+              !arrays_.is_collided(start, goal);
+    const Eigen::Vector2d result =
+        direct_ || trajectory_.empty() ? goal : trajectory_.back().position;
+
+    return std::make_pair(result, (result - start).norm() + (goal - result).norm());
+  };
+}
+} // namespace ai_server::planner
@@ -0,0 +1,95 @@
+#ifndef AI_SERVER_PLANNER_VELOCITY_OBSTACLE_H
+#define AI_SERVER_PLANNER_VELOCITY_OBSTACLE_H
+
+#include <optional>
+#include <vector>
+#include <Eigen/Core>
+
+#include "base.h"
+#include "impl/velocity_obstacle.h"
+
+namespace ai_server::planner {
+
+/// @class   velocity_obstacle
+/// @brief   移動する障害物の予測軌道を考慮して，速度空間で経路を探索する
+///
+/// 目標に向かう速度を中心に速度の候補を作り，現在の速度から加速度の上限内で
+/// 各候補の速度に向かったときの軌道を時刻付きで予測する．予測した軌道が
+/// 静止した障害物や，等速で動くとみなした移動する障害物 (obstacle_list::add_moving())
+/// に当たるまでの時間が短いほど大きなコストを与え，最もコストの小さい速度を選ぶ
+class velocity_obstacle : public base {
+public:
+  using trajectory_type = std::vector<impl::trajectory_point>;
+
+  velocity_obstacle();
+
+  /// @brief 最大速度を設定する
+  /// @param v               設定値 [mm/s]
+  void set_max_velocity(double v);
+
+  /// @brief 最大加速度を設定する
+  /// @param a               設定値 [mm/s^2]
+  void set_max_acceleration(double a);
+
+  /// @brief 軌道を予測する時間を設定する
+  /// @param horizon         設定値 [s]
+  /// @param step            予測の刻み幅 [s]
+  void set_horizon(double horizon, double step);
+
+  /// @brief 速度の候補の数を設定する
+  /// @param direction_count 方向の数
+  /// @param speed_count     速さの段階の数
+  void set_candidate_count(int direction_count, int speed_count);
+
+  /// @brief 障害物に当たるまでの時間に対するコストの重みを設定する
+  /// @param weight          設定値 [mm] (当たるまでの時間 t に対し weight / t のコストを与える)
+  void set_collision_weight(double weight);
+
+  /// @brief 現在の速度を設定する
+  ///
+  /// 設定しなければ，前回選んだ速度で動いているとみなす
+  /// (game::action::with_planner は探索の度に計測したロボットの速度を設定する)
+  /// @param v               設定値 [mm/s]
+  void set_current_velocity(const Eigen::Vector2d& v) override;
+
+  /// @brief 前回の探索で選んだ軌道を取得する
+  const trajectory_type& trajectory() const;
+
+  /// @brief 前回の探索で選んだ軌道の，探索の開始から t 秒後の速度を取得する
+  ///
+  /// 目標へ直進できたときは，目標位置を指令すればよいので nullopt を返す
+  std::optional<Eigen::Vector2d> velocity_at(double t) const override;
+
+  base::planner_type planner() override;
+
+private:
+  // 最大速度
+  double max_velocity_;
+  // 最大加速度
+  double max_acceleration_;
+  // 軌道を予測する時間とその刻み幅
+  double horizon_;
+  double step_;
+  // 速度の候補の数
+  int direction_count_;
+  int speed_count_;
+  // 障害物に当たるまでの時間に対するコストの重み
+  double collision_weight_;
+
+  // 現在の速度
+  std::optional<Eigen::Vector2d> current_velocity_;
+  // 前回選んだ速度
+  Eigen::Vector2d last_velocity_;
+  // 前回選んだ軌道
+  trajectory_type trajectory_;
+  // 前回の探索で目標へ直進できたか
+  bool direct_;
+
+  // 速度の候補 (呼び出し毎に使い回す)
+  std::vector<Eigen::Vector2d> candidates_;
+  // 当たり判定用の障害物 (呼び出し毎に使い回す)
+  detail::obstacle_arrays arrays_;
+};
+} // namespace ai_server::planner
+
+#endif // AI_SERVER_PLANNER_VELOCITY_OBSTACLE_H
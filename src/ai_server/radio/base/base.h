@@ -1,11 +1,29 @@
 #ifndef AI_SERVER_RADIO_BASE_BASE_H
 #define AI_SERVER_RADIO_BASE_BASE_H
 
+#include <vector>
+
 #include "ai_server/model/command.h"
 #include "ai_server/model/team_color.h"
 
 namespace ai_server::radio::base {
 
+/// 1台のロボットへの速度指令
+struct robot_command {
+  /// ロボットの ID
+  unsigned int id;
+  /// キッカーへの命令
+  model::command::kick_flag_t kick_flag;
+  /// ドリブラーへの命令
+  int dribble;
+  /// x 軸方向の速度
+  double vx;
+  /// y 軸方向の速度
+  double vy;
+  /// 角速度
+  double omega;
+};
+
 /// ロボットへの命令の送信
 class command {
 public:
@@ -25,6 +43,26 @@ public:
 
   virtual void send(model::team_color color, unsigned int id,
                     std::shared_ptr<model::motion::base> motion) = 0;
+
+  /// @brief            複数のロボットへの命令をまとめて送信する
+  /// @param color      チームカラー
+  /// @param commands   各ロボットへの命令
+  ///
+  /// 1周期分の命令を一度に渡すことで, 実装側でパケットを1つにまとめられるようにする.
+  /// デフォルトではロボット毎に send() を呼び出す
+  virtual void send_batch(model::team_color color, const std::vector<robot_command>& commands) {
+    for (const auto& c : commands) {
+      send(color, c.id, c.kick_flag, c.dribble, c.vx, c.vy, c.omega);
+    }
+  }
+
+  /// @brief            速度による命令を send_batch() でまとめて受け付けるか
+  ///
+  /// true のとき, Driver は1周期分の速度による命令を send_batch() で送る.
+  /// false のときは動作による命令をロボット毎に send() で送る
+  virtual bool batched() const {
+    return false;
+  }
 };
 
 /// シミュレータの制御コマンドの送信
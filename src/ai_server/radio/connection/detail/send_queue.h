@@ -0,0 +1,98 @@
+#ifndef AI_SERVER_RADIO_CONNECTION_DETAIL_SEND_QUEUE_H
+#define AI_SERVER_RADIO_CONNECTION_DETAIL_SEND_QUEUE_H
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+
+#include <boost/asio/buffer.hpp>
+
+namespace ai_server::radio::connection::detail {
+
+/// @class   send_queue
+/// @brief   送信待ちのメッセージを固定長のバッファに保持するリングバッファ
+///
+/// push() は任意のスレッドから呼び出せる. front() と pop() は送信を行う1つのスレッドから呼び出す.
+/// 領域は全て事前に確保されるため, メッセージ毎のヒープ確保は発生しない
+template <std::size_t MaxMessageSize, std::size_t Slots>
+class send_queue {
+public:
+  /// 送信待ちのメッセージ1つ分の領域
+  struct slot {
+    std::array<char, MaxMessageSize> data;
+    std::size_t size;
+
+    boost::asio::const_buffer buffer() const {
+      return boost::asio::buffer(data.data(), size);
+    }
+  };
+
+  /// push() の結果
+  enum class status {
+    /// 追加された
+    queued,
+    /// 追加された. 取り出す側が待機しているので起こす必要がある
+    queued_and_wake,
+    /// メッセージが大きすぎる
+    too_large,
+    /// キューが一杯
+    full,
+  };
+
+  send_queue() : head_{0}, size_{0}, waiting_{false} {}
+
+  /// @brief        メッセージを末尾にコピーする
+  /// @param buffer 追加するメッセージ
+  template <class ConstBufferSequence>
+  status push(const ConstBufferSequence& buffer) {
+    const auto size = boost::asio::buffer_size(buffer);
+    if (size > MaxMessageSize) return status::too_large;
+
+    std::unique_lock lock{mutex_};
+    if (size_ == Slots) return status::full;
+
+    auto& s = slots_[(head_ + size_) % Slots];
+    s.size  = boost::asio::buffer_copy(boost::asio::buffer(s.data), buffer);
+    ++size_;
+
+    if (waiting_) {
+      waiting_ = false;
+      return status::queued_and_wake;
+    }
+    return status::queued;
+  }
+
+  /// @brief  先頭のメッセージを取得する
+  ///
+  /// キューが空なら待機中の状態にして nullptr を返す.
+  /// 返された領域は pop() を呼び出すまで書き換えられない
+  const slot* front() {
+    std::unique_lock lock{mutex_};
+    if (size_ == 0) {
+      waiting_ = true;
+      return nullptr;
+    }
+    return &slots_[head_];
+  }
+
+  /// @brief  先頭のメッセージを取り除く
+  void pop() {
+    std::unique_lock lock{mutex_};
+    head_ = (head_ + 1) % Slots;
+    --size_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::array<slot, Slots> slots_;
+  /// 先頭の位置
+  std::size_t head_;
+  /// 格納されているメッセージ数
+  std::size_t size_;
+  /// 取り出す側がメッセージを待っているか
+  bool waiting_;
+};
+
+} // namespace ai_server::radio::connection::detail
+
+#endif // AI_SERVER_RADIO_CONNECTION_DETAIL_SEND_QUEUE_H
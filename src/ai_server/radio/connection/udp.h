@@ -2,7 +2,7 @@
 #define AI_SERVER_RADIO_CONNECTION_UDP_H
 
 #include <chrono>
-#include <utility>
+#include <cstddef>
 
 #define BOOST_COROUTINES_NO_DEPRECATION_WARNING
 #include <boost/asio.hpp>
@@ -13,11 +13,17 @@
 
 #include "ai_server/logger/logger.h"
 #include "detail/post_and_return_future.h"
+#include "detail/send_queue.h"
 
 namespace ai_server::radio::connection {
 
 class udp {
 public:
+  /// 1メッセージの最大長 [byte] (Ethernet の MTU から IP/UDP ヘッダを除いた大きさ)
+  static constexpr std::size_t max_message_size = 1472;
+  /// 送信待ちにできるメッセージ数
+  static constexpr std::size_t queue_size = 32;
+
   udp(boost::asio::io_context& io_context, const boost::asio::ip::udp::endpoint& endpoint)
       : total_messages_{},
         messages_per_second_{},
@@ -27,24 +33,39 @@ public:
         work_{boost::asio::make_work_guard(io_context_)},
         endpoint_{endpoint},
         socket_{io_context_, endpoint_.protocol()},
-        timer_{io_context_} {
+        timer_{io_context_},
+        wake_{io_context_} {
     boost::asio::spawn(timer_.get_executor(),
                        [&](auto yield) { count_messages_per_second(yield); });
+    boost::asio::spawn(wake_.get_executor(), [&](auto yield) { send_queued_messages(yield); });
   }
 
+  /// @brief        メッセージを送信キューにコピーする
+  ///
+  /// 実際の送信は io_context 上の1つのコルーチンが順番に行う.
+  /// キューが一杯のときや max_message_size を超えるメッセージは破棄され, 失敗として数えられる
   template <class Buffer>
-  auto send(Buffer buffer) -> decltype(boost::asio::buffer(buffer), void()) {
-    boost::asio::spawn(io_context_, [this, buffer = std::move(buffer)](auto yield) {
-      boost::system::error_code ec{};
-      socket_.async_send_to(boost::asio::buffer(buffer), endpoint_, yield[ec]);
-      if (ec) {
-        logger_.error(fmt::format("send() failed ({}): {}", endpoint_, ec.message()));
-        total_errors_++;
-      } else {
-        total_messages_++;
-        last_sent_ = std::chrono::system_clock::now();
-      }
-    });
+  auto send(const Buffer& buffer) -> decltype(boost::asio::buffer(buffer), void()) {
+    switch (queue_.push(boost::asio::buffer(buffer))) {
+      case queue_type::status::queued:
+        break;
+      case queue_type::status::queued_and_wake:
+        // 送信待ちのコルーチンを起こす
+        boost::asio::post(io_context_, [this] { wake_.cancel(); });
+        break;
+      case queue_type::status::too_large:
+        boost::asio::post(io_context_, [this] {
+          logger_.error(fmt::format("send() failed ({}): message too large", endpoint_));
+          total_errors_++;
+        });
+        break;
+      case queue_type::status::full:
+        boost::asio::post(io_context_, [this] {
+          logger_.error(fmt::format("send() failed ({}): queue is full", endpoint_));
+          total_errors_++;
+        });
+        break;
+    }
   }
 
   /// @brief 送信した総メッセージ数を取得する
@@ -70,6 +91,45 @@ public:
   }
 
 private:
+  using queue_type = detail::send_queue<max_message_size, queue_size>;
+
+  void send_queued_messages(boost::asio::yield_context yield) {
+    boost::system::error_code ec;
+
+    socket_.non_blocking(true);
+
+    for (;;) {
+      const auto s = queue_.front();
+
+      if (!s) {
+        // send() で起こされるまで待つ
+        wake_.expires_at(boost::asio::steady_timer::time_point::max());
+        wake_.async_wait(yield[ec]);
+        if (ec != boost::asio::error::operation_aborted) {
+          logger_.warn(fmt::format("sender is stopped ({})", endpoint_));
+          break;
+        }
+        continue;
+      }
+
+      // UDP の送信はほとんどブロックしないので, まずはその場で送信を試みる
+      socket_.send_to(s->buffer(), endpoint_, 0, ec);
+      if (ec == boost::asio::error::would_block) {
+        socket_.async_wait(boost::asio::ip::udp::socket::wait_write, yield[ec]);
+        if (!ec) continue;
+      }
+      queue_.pop();
+
+      if (ec) {
+        logger_.error(fmt::format("send() failed ({}): {}", endpoint_, ec.message()));
+        total_errors_++;
+      } else {
+        total_messages_++;
+        last_sent_ = std::chrono::system_clock::now();
+      }
+    }
+  }
+
   void count_messages_per_second(boost::asio::yield_context yield) {
     using namespace std::chrono_literals;
 
@@ -111,6 +171,10 @@ private:
   boost::asio::ip::udp::endpoint endpoint_;
   boost::asio::ip::udp::socket socket_;
   boost::asio::steady_timer timer_;
+  /// 送信キューが空のときに送信用のコルーチンを待たせておくためのタイマ
+  boost::asio::steady_timer wake_;
+
+  queue_type queue_;
 
   logger::logger_for<udp> logger_;
 };
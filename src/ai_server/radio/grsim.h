@@ -2,6 +2,7 @@
 #define AI_SERVER_RADIO_GRSIM_H
 
 #include <memory>
+#include <vector>
 
 #include <boost/math/constants/constants.hpp>
 
@@ -36,9 +37,32 @@ public:
     connection_->send(packet.SerializeAsString());
   }
 
-  void send([[maybe_unused]] model::team_color color, unsigned int id,
-            std::shared_ptr<model::motion::base> motion) override {
-    if (motion) std::cout << id << ": " << motion->motion_id() << std::endl;
+  /// 動作による命令には対応しない (送った命令は driver の radio::telemetry で確認する)
+  void send([[maybe_unused]] model::team_color color, [[maybe_unused]] unsigned int id,
+            [[maybe_unused]] std::shared_ptr<model::motion::base> motion) override {}
+
+  /// 全ロボットの命令を1つの Commands に詰めて1回で送信する
+  void send_batch(model::team_color color,
+                  const std::vector<base::robot_command>& commands) override {
+    if (commands.empty()) return;
+
+    ssl_protos::grsim::Packet packet{};
+
+    auto gr_cmds = packet.mutable_commands();
+    gr_cmds->set_isteamyellow(color == model::team_color::yellow);
+    gr_cmds->set_timestamp(0.0);
+    gr_cmds->mutable_robot_commands()->Reserve(static_cast<int>(commands.size()));
+
+    for (const auto& c : commands) {
+      auto gr_cmd = gr_cmds->add_robot_commands();
+      convert(c.id, c.kick_flag, c.dribble, c.vx, c.vy, c.omega, *gr_cmd);
+    }
+
+    connection_->send(packet.SerializeAsString());
+  }
+
+  bool batched() const override {
+    return true;
   }
 
   void set_ball_position(double x, double y) override {
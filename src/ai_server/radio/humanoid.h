@@ -3,7 +3,6 @@
 
 #include <cmath>
 #include <cstdint>
-#include <iostream>
 #include <memory>
 #include <vector>
 
@@ -70,7 +69,6 @@ public:
   void send([[maybe_unused]] model::team_color color, unsigned int id,
             std::shared_ptr<model::motion::base> motion) override {
     if (motion) {
-      std::cout << id << ": " << static_cast<int>(motion->motion_id()) << std::endl;
       std::vector<std::uint8_t> data(2);
       data[0] = id;
       data[1] = motion->motion_id();
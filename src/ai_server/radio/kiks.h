@@ -2,8 +2,8 @@
 #define AI_SERVER_RADIO_KIKS_H
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <iostream>
 #include <memory>
 #include <vector>
 
@@ -26,8 +26,40 @@ public:
   void send([[maybe_unused]] model::team_color color, unsigned int id,
             const model::command::kick_flag_t& kick_flag, int dribble, double vx, double vy,
             double omega) override {
-    std::vector<std::uint8_t> data(11);
+    std::vector<std::uint8_t> data(frame_size);
+    encode(id, kick_flag, dribble, vx, vy, omega, data.data());
+    connection_->send(std::move(data));
+  }
+
+  /// 全ロボット分のフレームを1つのバッファに連結して1回で送信する
+  void send_batch([[maybe_unused]] model::team_color color,
+                  const std::vector<base::robot_command>& commands) override {
+    if (commands.empty()) return;
+
+    std::vector<std::uint8_t> data(frame_size * commands.size());
+    auto p = data.data();
+    for (const auto& c : commands) {
+      encode(c.id, c.kick_flag, c.dribble, c.vx, c.vy, c.omega, p);
+      p += frame_size;
+    }
+    connection_->send(std::move(data));
+  }
+
+  bool batched() const override {
+    return true;
+  }
 
+  /// 動作による命令には対応しない (送った命令は driver の radio::telemetry で確認する)
+  void send([[maybe_unused]] model::team_color color, [[maybe_unused]] unsigned int id,
+            [[maybe_unused]] std::shared_ptr<model::motion::base> motion) override {}
+
+protected:
+  /// 1台分のフレームの長さ [byte]
+  static constexpr std::size_t frame_size = 11;
+
+  /// 1台分の命令を data から始まる frame_size バイトに書き込む
+  static void encode(unsigned int id, const model::command::kick_flag_t& kick_flag,
+                     int dribble, double vx, double vy, double omega, std::uint8_t* data) {
     data[0] = (id + 1) & 0b1111;
 
     switch (std::get<0>(kick_flag)) {
@@ -63,16 +95,8 @@ public:
 
     data[9]  = '\r';
     data[10] = '\n';
-
-    connection_->send(std::move(data));
   }
 
-  void send([[maybe_unused]] model::team_color color, unsigned int id,
-            std::shared_ptr<model::motion::base> motion) override {
-    if (motion) std::cout << id << ": " << motion->motion_id() << std::endl;
-  }
-
-protected:
   std::unique_ptr<Connection> connection_;
 };
 
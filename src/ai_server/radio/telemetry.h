@@ -0,0 +1,176 @@
+#ifndef AI_SERVER_RADIO_TELEMETRY_H
+#define AI_SERVER_RADIO_TELEMETRY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "ai_server/model/command.h"
+#include "ai_server/model/team_color.h"
+#include "ai_server/model/world.h"
+
+namespace ai_server::radio {
+
+/// @class   telemetry
+/// @brief   ロボット毎に最近送信した命令を記録するリングバッファ
+///
+/// Driver が送信する度に push() で記録し, GUI やファイルへの書き出しなどが別のスレッドから
+/// drain() で読み出す. 記録も読み出しも lock を取らず, メモリも確保しない.
+/// 各要素は seqlock で保護し, 読み出し中に上書きされた要素は読み飛ばす.
+/// 1台のロボットへの記録は1つのスレッドから行う (読み出すスレッドはいくつでもよい)
+class telemetry {
+public:
+  /// 記録するロボットIDの数 (ID 0 ~ max_robots - 1)
+  static constexpr std::size_t max_robots = model::world::max_robots;
+  /// 1台あたりに保持する命令の数
+  static constexpr std::size_t capacity = 64;
+
+  /// 1回分の命令
+  struct entry {
+    /// 送信した時刻
+    std::chrono::steady_clock::time_point time;
+    /// チームカラー
+    model::team_color color;
+    /// ロボットのID
+    unsigned int id;
+    /// 動作の ID (動作が指定されていないときは -1)
+    int motion_id;
+    /// Controller を通した後のロボット基準の速度
+    double vx;
+    double vy;
+    double omega;
+    /// キッカーへの命令
+    model::command::kick_type_t kick_type;
+    double kick_power;
+    /// ドリブラーへの命令
+    int dribble;
+  };
+
+  telemetry() = default;
+  telemetry(const telemetry&) = delete;
+  telemetry& operator=(const telemetry&) = delete;
+
+  /// @brief                  命令を記録する (容量を超えたら古いものから上書きする)
+  /// @param e                記録する命令 (e.id が max_robots 以上のときは何もしない)
+  void push(const entry& e) {
+    if (e.id >= max_robots) return;
+    auto& r      = robots_[e.id];
+    const auto n = r.head.load(std::memory_order_relaxed);
+    auto& s      = r.slots[n % capacity];
+
+    // 書き込み中は奇数にしておく
+    s.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s.time.store(e.time.time_since_epoch().count(), std::memory_order_relaxed);
+    s.color.store(static_cast<int>(e.color), std::memory_order_relaxed);
+    s.motion_id.store(e.motion_id, std::memory_order_relaxed);
+    s.vx.store(e.vx, std::memory_order_relaxed);
+    s.vy.store(e.vy, std::memory_order_relaxed);
+    s.omega.store(e.omega, std::memory_order_relaxed);
+    s.kick_type.store(static_cast<int>(e.kick_type), std::memory_order_relaxed);
+    s.kick_power.store(e.kick_power, std::memory_order_relaxed);
+    s.dribble.store(e.dribble, std::memory_order_relaxed);
+
+    s.seq.store(2 * n + 2, std::memory_order_release);
+    r.head.store(n + 1, std::memory_order_release);
+  }
+
+  /// @brief                  これまでにロボット id について記録した命令の数を取得する
+  std::uint64_t count(unsigned int id) const {
+    return id < max_robots ? robots_[id].head.load(std::memory_order_acquire) : 0;
+  }
+
+  /// @brief                  ロボット id について cursor 番目以降の命令を古い順に読み出す
+  ///
+  /// 既に上書きされたものや, 読み出し中に上書きされたものは読み飛ばす
+  /// @param cursor           読み出しを始める位置 (呼び出し後は次に読み出す位置になる)
+  /// @param f                読み出した命令 (const entry&) を受け取る関数
+  /// @return                 読み飛ばした命令の数
+  template <class F>
+  std::uint64_t drain(unsigned int id, std::uint64_t& cursor, F&& f) const {
+    if (id >= max_robots) return 0;
+    const auto& r    = robots_[id];
+    const auto head  = r.head.load(std::memory_order_acquire);
+    std::uint64_t skipped = 0;
+
+    // 上書きされた分は読み飛ばす
+    if (head > cursor + capacity) {
+      skipped += head - capacity - cursor;
+      cursor = head - capacity;
+    }
+
+    for (; cursor < head; ++cursor) {
+      if (const auto e = read(id, cursor)) {
+        f(*e);
+      } else {
+        ++skipped;
+      }
+    }
+    return skipped;
+  }
+
+  /// @brief                  ロボット id について最後に記録した命令を取得する
+  std::optional<entry> latest(unsigned int id) const {
+    const auto n = count(id);
+    return n == 0 ? std::nullopt : read(id, n - 1);
+  }
+
+private:
+  // 1回分の命令を保持する要素
+  // 読み出しと上書きが同時に起こり得るので, 全て std::atomic で持つ
+  struct slot {
+    std::atomic<std::uint64_t> seq{0};
+    std::atomic<std::chrono::steady_clock::rep> time{0};
+    std::atomic<int> color{0};
+    std::atomic<int> motion_id{0};
+    std::atomic<double> vx{0.0};
+    std::atomic<double> vy{0.0};
+    std::atomic<double> omega{0.0};
+    std::atomic<int> kick_type{0};
+    std::atomic<double> kick_power{0.0};
+    std::atomic<int> dribble{0};
+  };
+
+  // 1台分のリングバッファ
+  struct ring {
+    // これまでに記録した数
+    std::atomic<std::uint64_t> head{0};
+    std::array<slot, capacity> slots;
+  };
+
+  // n 番目に記録した命令を読み出す (上書きされていたら std::nullopt)
+  std::optional<entry> read(unsigned int id, std::uint64_t n) const {
+    const auto& s  = robots_[id].slots[n % capacity];
+    const auto seq = s.seq.load(std::memory_order_acquire);
+    if (seq != 2 * n + 2) return std::nullopt;
+
+    entry e{};
+    e.time = std::chrono::steady_clock::time_point{
+        std::chrono::steady_clock::duration{s.time.load(std::memory_order_relaxed)}};
+    e.color      = static_cast<model::team_color>(s.color.load(std::memory_order_relaxed));
+    e.id         = id;
+    e.motion_id  = s.motion_id.load(std::memory_order_relaxed);
+    e.vx         = s.vx.load(std::memory_order_relaxed);
+    e.vy         = s.vy.load(std::memory_order_relaxed);
+    e.omega      = s.omega.load(std::memory_order_relaxed);
+    e.kick_type  = static_cast<model::command::kick_type_t>(
+        s.kick_type.load(std::memory_order_relaxed));
+    e.kick_power = s.kick_power.load(std::memory_order_relaxed);
+    e.dribble    = s.dribble.load(std::memory_order_relaxed);
+
+    // 読み出している間に上書きされていないか確認する
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) != seq) return std::nullopt;
+    return e;
+  }
+
+  std::array<ring, max_robots> robots_;
+};
+
+} // namespace ai_server::radio
+
+#endif // AI_SERVER_RADIO_TELEMETRY_H
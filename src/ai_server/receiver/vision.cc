@@ -11,6 +11,7 @@ vision::vision(boost::asio::io_context& io_context, const std::string& listen_ad
       messages_per_second_{},
       parse_error_{},
       last_updated_{},
+      packet_{std::make_unique<ssl_protos::vision::Packet>()},
       receiver_{io_context, listen_addr, multicast_addr, port} {
   // multicast receiver のコールバック関数を登録する
   receiver_.on_receive(
@@ -19,6 +20,8 @@ vision::vision(boost::asio::io_context& io_context, const std::string& listen_ad
   receiver_.on_error([&](const auto& ec) { handle_error(ec); });
 }
 
+vision::~vision() = default;
+
 boost::signals2::connection vision::on_receive(const receive_slot_type& slot) {
   return receive_signal_.connect(slot);
 }
@@ -59,9 +62,10 @@ std::chrono::system_clock::time_point vision::last_updated() const {
 void vision::handle_receive(const util::net::multicast::receiver::buffer_t& buffer,
                             std::size_t size, std::uint64_t total_messages,
                             std::chrono::system_clock::time_point time) {
-  ssl_protos::vision::Packet packet;
+  auto& packet = *packet_;
 
   // パケットをパース
+  // ParseFromArray() は packet を Clear() してから読み込むので, 前回の値は残らない
   if (packet.ParseFromArray(buffer.data(), size)) {
     {
       std::unique_lock lock{mutex_};
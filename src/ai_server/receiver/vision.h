@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <shared_mutex>
 #include <unordered_map>
@@ -49,6 +50,8 @@ public:
   vision(boost::asio::io_context& io_context, const std::string& listen_addr,
          const std::string& multicast_addr, unsigned short port);
 
+  ~vision();
+
   /// @brief                  データ受信時に slot が呼ばれるようにする
   /// @param slot             データ受信時に呼びたい関数オブジェクト
   boost::signals2::connection on_receive(const receive_slot_type& slot);
@@ -103,6 +106,10 @@ private:
   // <カメラ ID, <受信したフレーム数, 時差 + 送受信の時間の平均>
   std::unordered_map<std::uint32_t, std::tuple<std::uint64_t, double>> time_diff_map_;
 
+  /// 受信したメッセージのパースに使い回すパケット
+  /// (Clear() しても確保済みの領域は解放されないため, 受信毎のヒープ確保を避けられる)
+  std::unique_ptr<ssl_protos::vision::Packet> packet_;
+
   receive_signal_type receive_signal_;
   error_signal_type error_signal_;
 
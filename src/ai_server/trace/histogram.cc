@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#include "histogram.h"
+
+namespace ai_server::trace {
+
+namespace {
+
+// value の最上位ビットの位置 (value > 0)
+unsigned int most_significant_bit(std::uint64_t value) {
+  return 63 - static_cast<unsigned int>(__builtin_clzll(value));
+}
+
+// 最小値・最大値を更新する
+template <class Compare>
+void update_extremum(std::atomic<std::uint64_t>& a, std::uint64_t value, Compare comp) {
+  auto current = a.load(std::memory_order_relaxed);
+  while (comp(value, current) &&
+         !a.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace
+
+histogram::histogram() {
+  reset();
+}
+
+void histogram::record(std::uint64_t value, std::uint64_t count) {
+  value = std::min(value, max_value);
+  counts_[index_of(value)].fetch_add(count, std::memory_order_relaxed);
+  total_count_.fetch_add(count, std::memory_order_relaxed);
+  sum_.fetch_add(value * count, std::memory_order_relaxed);
+  update_extremum(min_, value, std::less<>{});
+  update_extremum(max_, value, std::greater<>{});
+}
+
+void histogram::reset() {
+  for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+  total_count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  min_.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t histogram::count() const {
+  return total_count_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t histogram::min() const {
+  return count() == 0 ? 0 : min_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t histogram::max() const {
+  return max_.load(std::memory_order_relaxed);
+}
+
+double histogram::mean() const {
+  const auto n = count();
+  return n == 0 ? 0.0
+                : static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                      static_cast<double>(n);
+}
+
+std::uint64_t histogram::value_at_percentile(double percentile) const {
+  // 記録と並行して読み出しても矛盾しないように, 数は各 bucket の合計から求める
+  std::uint64_t total = 0;
+  for (const auto& c : counts_) total += c.load(std::memory_order_relaxed);
+  if (total == 0) return 0;
+
+  const auto p      = std::clamp(percentile, 0.0, 100.0) / 100.0;
+  const auto target = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(total))));
+
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < bucket_count; ++i) {
+    cumulative += counts_[i].load(std::memory_order_relaxed);
+    if (cumulative >= target) return std::min(highest_equivalent(i), max());
+  }
+  return max();
+}
+
+std::size_t histogram::index_of(std::uint64_t value) {
+  value = std::min(value, max_value);
+  if (value < 2 * sub_bucket_half_count) return static_cast<std::size_t>(value);
+
+  // value >> shift が [half, 2 * half) に入るように区間を選ぶ
+  const auto shift = most_significant_bit(value) - (sub_bucket_bits - 1);
+  return sub_bucket_half_count * shift + static_cast<std::size_t>(value >> shift);
+}
+
+std::uint64_t histogram::lowest_equivalent(std::size_t index) {
+  if (index < 2 * sub_bucket_half_count) return index;
+  const auto shift = index / sub_bucket_half_count - 1;
+  return static_cast<std::uint64_t>(index - sub_bucket_half_count * shift) << shift;
+}
+
+std::uint64_t histogram::highest_equivalent(std::size_t index) {
+  if (index < 2 * sub_bucket_half_count) return index;
+  const auto shift = index / sub_bucket_half_count - 1;
+  return lowest_equivalent(index) + (std::uint64_t{1} << shift) - 1;
+}
+
+} // namespace ai_server::trace
@@ -0,0 +1,80 @@
+#ifndef AI_SERVER_TRACE_HISTOGRAM_H
+#define AI_SERVER_TRACE_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_server::trace {
+
+/// @class   histogram
+/// @brief   HdrHistogram と同じ方式で 0 以上の整数値の分布を記録する
+///
+/// 値を 2 の冪毎の区間に分け, 各区間をさらに等分した bucket の数を数える.
+/// 記録した値と同じ bucket に入る値は区別されないが, その相対誤差は 1 / 64 以下になる.
+/// 記録は std::atomic への加算のみで行うので, 複数のスレッドから lock を取らずに記録でき,
+/// 読み出しも記録を止めずに行える (読み出し中の記録は反映されないことがある)
+class histogram {
+public:
+  /// 2 の冪毎の区間を分割する数の log2 (区間の半分の 64 個が相対誤差を決める)
+  static constexpr unsigned int sub_bucket_bits = 7;
+  /// 記録できる値のビット数 (これより大きな値は max_value として記録する)
+  static constexpr unsigned int value_bits = 32;
+  /// 記録できる最大の値
+  static constexpr std::uint64_t max_value = (std::uint64_t{1} << value_bits) - 1;
+
+  histogram();
+  histogram(const histogram&) = delete;
+  histogram& operator=(const histogram&) = delete;
+
+  /// @brief                  値を記録する
+  /// @param value            記録する値
+  /// @param count            記録する回数
+  void record(std::uint64_t value, std::uint64_t count = 1);
+
+  /// @brief                  記録を全て消去する
+  void reset();
+
+  /// @brief                  記録した値の数を取得する
+  std::uint64_t count() const;
+
+  /// @brief                  記録した最小の値を取得する (記録がないときは 0)
+  std::uint64_t min() const;
+
+  /// @brief                  記録した最大の値を取得する (記録がないときは 0)
+  std::uint64_t max() const;
+
+  /// @brief                  記録した値の平均を取得する (記録がないときは 0)
+  double mean() const;
+
+  /// @brief                  記録した値のうち, 小さい方から percentile [%] にある値を取得する
+  ///
+  /// 値は bucket に入る最大の値で返す (ただし max() を超えない)
+  /// @param percentile       0 から 100 の値
+  std::uint64_t value_at_percentile(double percentile) const;
+
+  /// @brief                  value が入る bucket の添字を求める
+  static std::size_t index_of(std::uint64_t value);
+
+  /// @brief                  添字 index の bucket に入る最小の値を求める
+  static std::uint64_t lowest_equivalent(std::size_t index);
+
+  /// @brief                  添字 index の bucket に入る最大の値を求める
+  static std::uint64_t highest_equivalent(std::size_t index);
+
+private:
+  static constexpr std::size_t sub_bucket_half_count = std::size_t{1} << (sub_bucket_bits - 1);
+  static constexpr std::size_t bucket_count =
+      sub_bucket_half_count * (value_bits - sub_bucket_bits + 2);
+
+  std::array<std::atomic<std::uint64_t>, bucket_count> counts_;
+  std::atomic<std::uint64_t> total_count_;
+  std::atomic<std::uint64_t> sum_;
+  std::atomic<std::uint64_t> min_;
+  std::atomic<std::uint64_t> max_;
+};
+
+} // namespace ai_server::trace
+
+#endif // AI_SERVER_TRACE_HISTOGRAM_H
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include "latency.h"
+
+namespace ai_server::trace {
+
+latency& latency::global() {
+  static latency l{};
+  return l;
+}
+
+void latency::record(stage s, std::chrono::system_clock::duration d) {
+  // 撮影時刻は時差の平均で補正した値なので, 前後が入れ替わることがある
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+  histograms_[static_cast<std::size_t>(s)].record(
+      static_cast<std::uint64_t>(std::max<std::chrono::microseconds::rep>(us, 0)));
+}
+
+void latency::record(const frame_timestamps& t, std::chrono::system_clock::time_point sent) {
+  if (t.frame == 0) return;
+
+  record(stage::vision, t.received - t.captured);
+  record(stage::update, t.published - t.received);
+  record(stage::queue, t.game_started - t.published);
+  record(stage::game, t.game_finished - t.game_started);
+  record(stage::driver, sent - t.game_finished);
+  record(stage::total, sent - t.captured);
+}
+
+latency::summary latency::summarize(stage s) const {
+  const auto& h = histogram_of(s);
+  const auto us = [](auto v) {
+    return std::chrono::microseconds{static_cast<std::chrono::microseconds::rep>(v)};
+  };
+  return {s,
+          h.count(),
+          us(h.min()),
+          us(std::llround(h.mean())),
+          us(h.value_at_percentile(50.0)),
+          us(h.value_at_percentile(90.0)),
+          us(h.value_at_percentile(99.0)),
+          us(h.value_at_percentile(99.9)),
+          us(h.max())};
+}
+
+std::array<latency::summary, latency::stage_count> latency::summarize() const {
+  std::array<summary, stage_count> result{};
+  for (std::size_t i = 0; i < stage_count; ++i) result[i] = summarize(static_cast<stage>(i));
+  return result;
+}
+
+const histogram& latency::histogram_of(stage s) const {
+  return histograms_[static_cast<std::size_t>(s)];
+}
+
+void latency::reset() {
+  for (auto& h : histograms_) h.reset();
+}
+
+void latency::write_csv(std::ostream& os) const {
+  os << "stage,count,min_us,mean_us,p50_us,p90_us,p99_us,p99.9_us,max_us\n";
+  for (const auto& s : summarize()) {
+    os << fmt::format("{},{},{},{},{},{},{},{},{}\n", to_string(s.s), s.count, s.min.count(),
+                      s.mean.count(), s.p50.count(), s.p90.count(), s.p99.count(),
+                      s.p999.count(), s.max.count());
+  }
+}
+
+const char* to_string(latency::stage s) {
+  switch (s) {
+    case latency::stage::vision:
+      return "vision";
+    case latency::stage::update:
+      return "update";
+    case latency::stage::queue:
+      return "queue";
+    case latency::stage::game:
+      return "game";
+    case latency::stage::driver:
+      return "driver";
+    case latency::stage::total:
+      return "total";
+  }
+  return "unknown";
+}
+
+} // namespace ai_server::trace
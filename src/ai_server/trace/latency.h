@@ -0,0 +1,105 @@
+#ifndef AI_SERVER_TRACE_LATENCY_H
+#define AI_SERVER_TRACE_LATENCY_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "histogram.h"
+
+namespace ai_server::trace {
+
+/// Vision のフレーム1つが各段階を通過した時刻
+///
+/// updater::world でフレームが揃ったときに作られ, 戦略部, Driver へと受け渡される
+struct frame_timestamps {
+  using time_point = std::chrono::system_clock::time_point;
+
+  /// updater::world で揃ったフレームの番号 (0 のときは無効)
+  std::uint64_t frame = 0;
+  /// フレームで最も新しい撮影時刻 (receiver::vision で ai-server の時計に合わせたもの)
+  time_point captured;
+  /// フレームを揃えた検出結果を受け取った時刻
+  time_point received;
+  /// world に反映した時刻
+  time_point published;
+  /// 戦略部が処理を始めた時刻
+  time_point game_started;
+  /// 戦略部が命令を出し終えた時刻
+  time_point game_finished;
+};
+
+/// @class   latency
+/// @brief   Vision の撮影から Radio での送信までにかかった時間を段階毎に記録する
+///
+/// 各段階の時間は histogram に [us] 単位で記録する.
+/// 記録は Radio で送信したスレッドで行い, 読み出しはどのスレッドからでも行える
+class latency {
+public:
+  /// 記録する段階
+  enum class stage : std::size_t {
+    vision, ///< 撮影 -> 受信 (SSL-Vision の処理とネットワーク)
+    update, ///< 受信 -> world への反映
+    queue,  ///< world への反映 -> 戦略部の開始
+    game,   ///< 戦略部の開始 -> 命令の更新
+    driver, ///< 命令の更新 -> Radio での送信 (Controller を含む)
+    total,  ///< 撮影 -> Radio での送信
+  };
+  /// 段階の数
+  static constexpr std::size_t stage_count = 6;
+
+  /// 1つの段階の統計量
+  struct summary {
+    stage s;
+    std::uint64_t count;
+    std::chrono::microseconds min;
+    std::chrono::microseconds mean;
+    std::chrono::microseconds p50;
+    std::chrono::microseconds p90;
+    std::chrono::microseconds p99;
+    std::chrono::microseconds p999;
+    std::chrono::microseconds max;
+  };
+
+  latency() = default;
+  latency(const latency&) = delete;
+  latency& operator=(const latency&) = delete;
+
+  /// プロセス内で共通の latency を取得する
+  static latency& global();
+
+  /// @brief                  段階 s にかかった時間を記録する (負の値は 0 とする)
+  void record(stage s, std::chrono::system_clock::duration d);
+
+  /// @brief                  フレームが送信されるまでの各段階の時間を記録する
+  /// @param t                フレームが各段階を通過した時刻 (frame が 0 のときは何もしない)
+  /// @param sent             Radio で送信した時刻
+  void record(const frame_timestamps& t, std::chrono::system_clock::time_point sent);
+
+  /// @brief                  段階 s の統計量を取得する
+  summary summarize(stage s) const;
+
+  /// @brief                  全ての段階の統計量を取得する
+  std::array<summary, stage_count> summarize() const;
+
+  /// @brief                  段階 s の histogram を取得する
+  const histogram& histogram_of(stage s) const;
+
+  /// @brief                  記録を全て消去する
+  void reset();
+
+  /// @brief                  全ての段階の統計量を CSV 形式で書き出す
+  void write_csv(std::ostream& os) const;
+
+private:
+  std::array<histogram, stage_count> histograms_;
+};
+
+/// @brief                    段階の名前を取得する
+const char* to_string(latency::stage s);
+
+} // namespace ai_server::trace
+
+#endif // AI_SERVER_TRACE_LATENCY_H
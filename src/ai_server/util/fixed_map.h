@@ -0,0 +1,288 @@
+#ifndef AI_SERVER_UTIL_FIXED_MAP_H
+#define AI_SERVER_UTIL_FIXED_MAP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ai_server::util {
+
+/// @class   fixed_map
+/// @brief   0 以上 N 未満の整数を Key とする固定長の連想配列
+///
+/// 要素は Key を添字とした配列に直接格納し, 使用中の Key はビットマスクで管理する.
+/// ヒープ領域を使わないためコピーが軽く, 走査は常に Key の昇順で行われる.
+/// インターフェースは std::unordered_map<unsigned int, T> の一部と互換性を持たせている
+template <class T, std::size_t N>
+class fixed_map {
+  static_assert(N <= 64, "fixed_map supports at most 64 keys");
+
+  using mask_type = std::uint64_t;
+
+public:
+  using key_type        = unsigned int;
+  using mapped_type     = T;
+  using value_type      = std::pair<const key_type, T>;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference       = value_type&;
+  using const_reference = const value_type&;
+
+private:
+  template <bool Const>
+  class iterator_base {
+    using map_pointer = std::conditional_t<Const, const fixed_map*, fixed_map*>;
+
+    map_pointer map_;
+    size_type index_;
+
+    friend class fixed_map;
+
+    iterator_base(map_pointer map, size_type index) : map_{map}, index_{index} {}
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = typename fixed_map::value_type;
+    using difference_type   = typename fixed_map::difference_type;
+    using pointer           = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference         = std::conditional_t<Const, const value_type&, value_type&>;
+
+    iterator_base() : map_{nullptr}, index_{N} {}
+
+    // iterator から const_iterator への変換
+    template <bool C = Const, std::enable_if_t<C, std::nullptr_t> = nullptr>
+    iterator_base(const iterator_base<false>& it) : map_{it.map_}, index_{it.index_} {}
+
+    reference operator*() const {
+      return *map_->slots_[index_];
+    }
+
+    pointer operator->() const {
+      return &*map_->slots_[index_];
+    }
+
+    iterator_base& operator++() {
+      index_ = map_->next_index(index_ + 1);
+      return *this;
+    }
+
+    iterator_base operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const iterator_base& a, const iterator_base& b) {
+      return a.index_ == b.index_;
+    }
+
+    friend bool operator!=(const iterator_base& a, const iterator_base& b) {
+      return a.index_ != b.index_;
+    }
+
+    friend class iterator_base<!Const>;
+  };
+
+public:
+  using iterator       = iterator_base<false>;
+  using const_iterator = iterator_base<true>;
+
+  fixed_map() : used_{0} {}
+
+  fixed_map(std::initializer_list<value_type> init) : fixed_map(init.begin(), init.end()) {}
+
+  template <class InputIterator>
+  fixed_map(InputIterator first, InputIterator last) : used_{0} {
+    insert(first, last);
+  }
+
+  fixed_map(const fixed_map&) = default;
+  fixed_map(fixed_map&&)      = default;
+
+  // value_type の first が const のため std::optional の代入演算子は使えない
+  // 要素を作り直すことで代入を実現する
+  fixed_map& operator=(const fixed_map& other) {
+    if (this != &other) assign(other.used_, [&other](auto i) { return *other.slots_[i]; });
+    return *this;
+  }
+
+  fixed_map& operator=(fixed_map&& other) {
+    if (this != &other) {
+      assign(other.used_, [&other](auto i) { return std::move(*other.slots_[i]); });
+    }
+    return *this;
+  }
+
+  /// @brief 格納できる Key の上限 (N)
+  static constexpr size_type capacity() {
+    return N;
+  }
+
+  size_type max_size() const {
+    return N;
+  }
+
+  size_type size() const {
+    return __builtin_popcountll(used_);
+  }
+
+  bool empty() const {
+    return used_ == 0;
+  }
+
+  iterator begin() {
+    return {this, next_index(0)};
+  }
+
+  const_iterator begin() const {
+    return {this, next_index(0)};
+  }
+
+  const_iterator cbegin() const {
+    return begin();
+  }
+
+  iterator end() {
+    return {this, N};
+  }
+
+  const_iterator end() const {
+    return {this, N};
+  }
+
+  const_iterator cend() const {
+    return end();
+  }
+
+  iterator find(key_type key) {
+    return contains(key) ? iterator{this, key} : end();
+  }
+
+  const_iterator find(key_type key) const {
+    return contains(key) ? const_iterator{this, key} : end();
+  }
+
+  size_type count(key_type key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  bool contains(key_type key) const {
+    return key < N && (used_ & bit(key));
+  }
+
+  T& at(key_type key) {
+    if (!contains(key)) throw std::out_of_range("fixed_map::at");
+    return slots_[key]->second;
+  }
+
+  const T& at(key_type key) const {
+    if (!contains(key)) throw std::out_of_range("fixed_map::at");
+    return slots_[key]->second;
+  }
+
+  /// @brief Key が存在しなければ値初期化した要素を追加し, その参照を返す
+  ///
+  /// key が N 以上のときは std::out_of_range を投げる
+  T& operator[](key_type key) {
+    return try_emplace(key).first->second;
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(key_type key, Args&&... args) {
+    if (key >= N) throw std::out_of_range("fixed_map: key exceeds capacity");
+    if (contains(key)) return {iterator{this, key}, false};
+    slots_[key].emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    used_ |= bit(key);
+    return {iterator{this, key}, true};
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(key_type key, Args&&... args) {
+    return try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) insert(*first);
+  }
+
+  template <class M>
+  std::pair<iterator, bool> insert_or_assign(key_type key, M&& obj) {
+    auto result = try_emplace(key, std::forward<M>(obj));
+    if (!result.second) result.first->second = std::forward<M>(obj);
+    return result;
+  }
+
+  size_type erase(key_type key) {
+    if (!contains(key)) return 0;
+    slots_[key].reset();
+    used_ &= ~bit(key);
+    return 1;
+  }
+
+  iterator erase(const_iterator pos) {
+    const auto index = pos.index_;
+    erase(static_cast<key_type>(index));
+    return {this, next_index(index + 1)};
+  }
+
+  void clear() {
+    for (auto& s : slots_) s.reset();
+    used_ = 0;
+  }
+
+  friend bool operator==(const fixed_map& a, const fixed_map& b) {
+    if (a.used_ != b.used_) return false;
+    for (const auto& [key, value] : a) {
+      if (!(value == b.slots_[key]->second)) return false;
+    }
+    return true;
+  }
+
+  friend bool operator!=(const fixed_map& a, const fixed_map& b) {
+    return !(a == b);
+  }
+
+private:
+  static constexpr mask_type bit(size_type index) {
+    return mask_type{1} << index;
+  }
+
+  /// used で示された位置の要素を f(index) の返り値で置き換える
+  template <class F>
+  void assign(mask_type used, F f) {
+    for (size_type i = 0; i < N; ++i) {
+      slots_[i].reset();
+      if (used & bit(i)) slots_[i].emplace(f(i));
+    }
+    used_ = used;
+  }
+
+  /// index 以降で最初に使用されている位置を返す (存在しなければ N)
+  size_type next_index(size_type index) const {
+    if (index >= N) return N;
+    const auto rest = used_ >> index;
+    return rest == 0 ? N : index + __builtin_ctzll(rest);
+  }
+
+  /// 使用中の Key を表すビットマスク
+  mask_type used_;
+  /// Key を添字として格納された要素
+  std::array<std::optional<value_type>, N> slots_;
+};
+
+} // namespace ai_server::util
+
+#endif // AI_SERVER_UTIL_FIXED_MAP_H
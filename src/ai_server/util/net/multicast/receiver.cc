@@ -1,5 +1,12 @@
 #include <chrono>
+#include <cstring>
 #include <functional>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <time.h>
+#endif
+
 #include "receiver.h"
 
 using namespace std::chrono_literals;
@@ -56,19 +63,107 @@ void receiver::receive_data(boost::asio::yield_context yield,
     return;
   }
 
-  for (;;) {
-    buffer_t data;
-    const auto recieved =
-        socket_.async_receive_from(boost::asio::buffer(data), endpoint_, yield[ec]);
+#ifdef __linux__
+  // カーネルがメッセージを受信した時刻を付加させる
+  // (失敗したときは receive_batch() で受信処理時の時刻が使われる)
+  if (const int on = 1; ::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_TIMESTAMPNS, &on,
+                                     sizeof(on)) != 0) {
+    call_error_callback({errno, boost::system::system_category()});
+  }
+#endif
 
+  for (;;) {
+    // 受信できるようになるまで待つ
+    socket_.async_wait(boost::asio::ip::udp::socket::wait_read, yield[ec]);
     if (ec) {
       call_error_callback(ec);
-    } else {
-      auto time = std::chrono::system_clock::now();
-      call_receive_callback(data, recieved, ++total_messages_, time);
+      continue;
+    }
+
+    const auto n = receive_batch(ec);
+    if (ec) call_error_callback(ec);
+
+    for (std::size_t i = 0; i < n; ++i) {
+      call_receive_callback(buffers_[i], lengths_[i], ++total_messages_, times_[i]);
+    }
+  }
+}
+
+#ifdef __linux__
+std::size_t receiver::receive_batch(boost::system::error_code& ec) {
+  constexpr auto control_size = CMSG_SPACE(sizeof(::timespec));
+
+  std::array<::mmsghdr, batch_size> messages{};
+  std::array<::iovec, batch_size> iovecs{};
+  std::array<std::array<char, control_size>, batch_size> controls{};
+
+  for (std::size_t i = 0; i < batch_size; ++i) {
+    iovecs[i].iov_base = buffers_[i].data();
+    iovecs[i].iov_len  = buffers_[i].size();
+
+    auto& h          = messages[i].msg_hdr;
+    h.msg_iov        = &iovecs[i];
+    h.msg_iovlen     = 1;
+    h.msg_control    = controls[i].data();
+    h.msg_controllen = controls[i].size();
+  }
+
+  // 受信待ちのメッセージをまとめて読み込む
+  const auto r =
+      ::recvmmsg(socket_.native_handle(), messages.data(), batch_size, MSG_DONTWAIT, nullptr);
+  if (r < 0) {
+    // 他に読み込まれていた場合などは何もしない
+    if (errno != EAGAIN && errno != EWOULDBLOCK) ec = {errno, boost::system::system_category()};
+    return 0;
+  }
+
+  const auto now = std::chrono::system_clock::now();
+
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < static_cast<std::size_t>(r); ++i) {
+    auto& h = messages[i].msg_hdr;
+
+    // バッファに収まらなかったメッセージは捨てる
+    if (h.msg_flags & MSG_TRUNC) {
+      ec = boost::asio::error::message_size;
+      continue;
     }
+
+    // カーネルが受信した時刻を取り出す
+    times_[n] = now;
+    for (auto c = CMSG_FIRSTHDR(&h); c != nullptr; c = CMSG_NXTHDR(&h, c)) {
+      if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+        ::timespec ts;
+        std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+        times_[n] = std::chrono::system_clock::time_point{
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec})};
+      }
+    }
+
+    // 捨てたメッセージの分だけ前に詰める
+    if (n != i) buffers_[n] = buffers_[i];
+    lengths_[n] = messages[i].msg_len;
+    ++n;
   }
+
+  return n;
+}
+#else
+std::size_t receiver::receive_batch(boost::system::error_code& ec) {
+  socket_.non_blocking(true, ec);
+  if (ec) return 0;
+
+  lengths_[0] = socket_.receive_from(boost::asio::buffer(buffers_[0]), endpoint_, 0, ec);
+  if (ec) {
+    if (ec == boost::asio::error::would_block) ec = {};
+    return 0;
+  }
+
+  times_[0] = std::chrono::system_clock::now();
+  return 1;
 }
+#endif
 
 void receiver::count_messages_per_second(boost::asio::yield_context yield) {
   boost::system::error_code ec;
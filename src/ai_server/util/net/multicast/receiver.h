@@ -26,6 +26,9 @@ public:
   /// バッファの型
   using buffer_t = std::array<char, buffer_size>;
 
+  /// 1回のシステムコールでまとめて受信するメッセージの最大数
+  constexpr static std::size_t batch_size = 8;
+
   // データ受信時のコールバック関数の型
   using receive_callback_type =
       std::function<void(const buffer_t&, // 受信バッファ
@@ -78,6 +81,13 @@ private:
                     const boost::asio::ip::udp::endpoint& endpoint,
                     const boost::asio::ip::address& addr);
 
+  /// @brief 受信待ちのメッセージを buffers_ にまとめて読み込む
+  /// @return 読み込んだメッセージの数
+  ///
+  /// Linux では recvmmsg(2) で最大 batch_size 個のメッセージを一度に読み込み,
+  /// SO_TIMESTAMPNS によりカーネルが受信した時刻を times_ に格納する
+  std::size_t receive_batch(boost::system::error_code& ec);
+
   /// @brief 1秒間に受信したメッセージを数える
   void count_messages_per_second(boost::asio::yield_context yield);
 
@@ -103,6 +113,13 @@ private:
 
   boost::asio::steady_timer timer_;
 
+  /// 受信したデータを格納するバッファ
+  std::array<buffer_t, batch_size> buffers_;
+  /// buffers_ に格納されたデータのサイズ
+  std::array<std::size_t, batch_size> lengths_;
+  /// buffers_ に格納されたデータを受信した時刻
+  std::array<std::chrono::system_clock::time_point, batch_size> times_;
+
   receive_callback_type receive_callback_;
   status_callback_type status_updated_callback_;
   error_callback_type error_callback_;
@@ -3,6 +3,8 @@
 
 #include <string_view>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 // int pthread_setname_np(pthread_t, const char*) が呼び出せるか確認
 // - macOS でない
@@ -26,6 +28,27 @@ extern "C" {
 #define AI_SERVER_HAS_PTHREAD_SETNAME_NP 0
 #endif
 
+// int pthread_setaffinity_np(pthread_t, size_t, const cpu_set_t*) が呼び出せるか確認
+// - GNU C Library 2.3.4+ を使っている (macOS にはない)
+// int pthread_setschedparam(pthread_t, int, const sched_param*) は POSIX なので
+// <pthread.h> があれば呼び出せる
+
+#if !defined(__APPLE__) && defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 4)
+#define AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP 1
+#else
+#define AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP 0
+#endif
+#else
+#define AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP 0
+#endif
+
+#if __has_include(<pthread.h>)
+#define AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM 1
+#else
+#define AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM 0
+#endif
+
 namespace ai_server::util {
 
 /// @brief         スレッド名を設定する (可能な場合)
@@ -45,8 +68,55 @@ static inline bool set_thread_name([[maybe_unused]] std::thread& thread,
   return false;
 }
 
+/// @brief         スレッドを実行する CPU を制限する (可能な場合)
+/// @param thread  対象のスレッド
+/// @param cpus    実行を許す CPU の番号 (空のときは何もしない)
+/// @return        設定に成功したか (cpus が空のときは true)
+static inline bool set_thread_affinity([[maybe_unused]] std::thread& thread,
+                                       [[maybe_unused]] const std::vector<int>& cpus) {
+  if (cpus.empty()) return true;
+
+#if AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP
+  if constexpr (std::is_same_v<std::thread::native_handle_type, ::pthread_t>) {
+    ::cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+      if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+      CPU_SET(cpu, &set);
+    }
+    auto nh = thread.native_handle();
+    return ::pthread_setaffinity_np(nh, sizeof(set), &set) == 0;
+  }
+#endif
+
+  return false;
+}
+
+/// @brief           スレッドを SCHED_FIFO の実時間スケジューリングにする (可能な場合)
+///
+/// Linux では CAP_SYS_NICE (または RLIMIT_RTPRIO の設定) がないと失敗する
+/// @param thread    対象のスレッド
+/// @param priority  SCHED_FIFO の優先度 (0 のときは通常のスケジューリング SCHED_OTHER に戻す)
+/// @return          設定に成功したか
+static inline bool set_thread_priority([[maybe_unused]] std::thread& thread,
+                                       [[maybe_unused]] int priority) {
+#if AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM
+  if constexpr (std::is_same_v<std::thread::native_handle_type, ::pthread_t>) {
+    const int policy = priority > 0 ? SCHED_FIFO : SCHED_OTHER;
+    ::sched_param param{};
+    param.sched_priority = priority > 0 ? priority : 0;
+    auto nh              = thread.native_handle();
+    return ::pthread_setschedparam(nh, policy, &param) == 0;
+  }
+#endif
+
+  return false;
+}
+
 } // namespace ai_server::util
 
 #undef AI_SERVER_HAS_PTHREAD_SETNAME_NP
+#undef AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP
+#undef AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM
 
 #endif // AI_SERVER_UTIL_THREAD_H
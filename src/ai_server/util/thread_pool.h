@@ -0,0 +1,172 @@
+#ifndef AI_SERVER_UTIL_THREAD_POOL_H
+#define AI_SERVER_UTIL_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread.h"
+
+namespace ai_server::util {
+
+/// @class   thread_pool
+/// @brief   決まった数のスレッドで処理を並列に実行する
+///
+/// parallel_for() に渡された n 個の処理は, 呼び出し元のスレッドと worker スレッドが
+/// 共有カウンタから1つずつ取り出して実行する. 処理時間に偏りがあっても空いたスレッドが
+/// 次の処理を取りに行くため, 全体の待ち時間は最も重い処理に近くなる
+class thread_pool {
+public:
+  /// @param threads  worker スレッドの数 (呼び出し元のスレッドは含まない)
+  /// @param name     worker スレッドの名前
+  explicit thread_pool(std::size_t threads, const std::string& name = "thread_pool")
+      : count_{0},
+        next_{0},
+        finished_{0},
+        context_{nullptr},
+        invoke_{nullptr},
+        generation_{0},
+        active_{0},
+        stop_{false} {
+    threads_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+      threads_.emplace_back([this] { worker(); });
+      set_thread_name(threads_.back(), name);
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  ~thread_pool() {
+    {
+      std::unique_lock lock{mutex_};
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& t : threads_) t.join();
+  }
+
+  /// @brief worker スレッドの数を取得する
+  std::size_t size() const {
+    return threads_.size();
+  }
+
+  /// @brief    f(0), f(1), ..., f(n - 1) を並列に実行し, 全て終わるまで待つ
+  ///
+  /// f はスレッド安全でなければならない. 例外が投げられたときは, 全ての処理が終わった後に
+  /// 最初に投げられた例外を再送出する
+  template <class F>
+  void parallel_for(std::size_t n, F&& f) {
+    if (n == 0) return;
+
+    using func_type = std::remove_reference_t<F>;
+    {
+      std::unique_lock lock{mutex_};
+      // 前回の処理を実行していた worker が全て抜けるまで待つ
+      done_cv_.wait(lock, [this] { return active_ == 0; });
+      count_    = n;
+      next_     = 0;
+      finished_ = 0;
+      context_  = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+      invoke_   = [](void* c, std::size_t i) { (*static_cast<func_type*>(c))(i); };
+      error_    = nullptr;
+      ++generation_;
+      ++active_;
+    }
+    start_cv_.notify_all();
+
+    // 呼び出し元のスレッドも処理を行う
+    run({context_, invoke_, n});
+
+    std::unique_lock lock{mutex_};
+    --active_;
+    done_cv_.wait(lock, [this, n] { return finished_ == n && active_ == 0; });
+    if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+
+private:
+  // 1回の parallel_for() の処理
+  struct job {
+    void* context;
+    void (*invoke)(void*, std::size_t);
+    std::size_t count;
+  };
+
+  void worker() {
+    std::uint64_t seen = 0;
+    for (;;) {
+      job j{};
+      {
+        std::unique_lock lock{mutex_};
+        start_cv_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+        j    = {context_, invoke_, count_};
+        ++active_;
+      }
+
+      run(j);
+
+      {
+        std::unique_lock lock{mutex_};
+        --active_;
+      }
+      done_cv_.notify_all();
+    }
+  }
+
+  void run(const job& j) {
+    for (;;) {
+      const auto i = next_.fetch_add(1, std::memory_order_relaxed);
+      if (i >= j.count) break;
+      try {
+        j.invoke(j.context, i);
+      } catch (...) {
+        std::unique_lock lock{mutex_};
+        if (!error_) error_ = std::current_exception();
+      }
+      if (finished_.fetch_add(1, std::memory_order_acq_rel) + 1 == j.count) {
+        std::unique_lock lock{mutex_};
+        done_cv_.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+
+  // 実行中の parallel_for() の処理の数
+  std::size_t count_;
+  // 次に実行する処理の番号
+  std::atomic<std::size_t> next_;
+  // 終わった処理の数
+  std::atomic<std::size_t> finished_;
+  // parallel_for() に渡された関数オブジェクトと, それを呼び出す関数
+  void* context_;
+  void (*invoke_)(void*, std::size_t);
+  // 最初に投げられた例外
+  std::exception_ptr error_;
+
+  // parallel_for() が呼ばれた回数
+  std::uint64_t generation_;
+  // 処理を行っているスレッドの数
+  std::size_t active_;
+  bool stop_;
+};
+
+} // namespace ai_server::util
+
+#endif // AI_SERVER_UTIL_THREAD_POOL_H
@@ -1,5 +1,6 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <stdexcept>
@@ -13,6 +14,7 @@
 #include "ai_server/model/team_color.h"
 #include "ai_server/model/updater/world.h"
 #include "ai_server/radio/base/base.h"
+#include "test_helpers/allocation_counter.h"
 
 #include "ssl-protos/vision_wrapper.pb.h"
 
@@ -140,6 +142,26 @@ struct mock_radio : public radio::base::command {
   }
 };
 
+// 速度による命令をまとめて受け付ける Radio (シミュレータではない KIKS など)
+struct mock_batched_radio : public mock_radio {
+  std::vector<std::vector<radio::base::robot_command>> batches_;
+
+  void send_batch(model::team_color color,
+                  const std::vector<radio::base::robot_command>& c) override {
+    batches_.push_back(c);
+    color_ = color;
+  }
+
+  bool batched() const override {
+    return true;
+  }
+};
+
+struct mock_simulator_radio : public mock_batched_radio, public radio::base::simulator {
+  void set_ball_position(double, double) {}
+  void set_robot_position(model::team_color, unsigned int, double, double, double) {}
+};
+
 struct command_updated_handler {
   std::vector<
       std::tuple<unsigned int, double, double, double, std::shared_ptr<model::motion::base>>>
@@ -556,4 +578,185 @@ BOOST_AUTO_TEST_CASE(main_loop3, *boost::unit_test::tolerance(0.0000001)) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(send_batch) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 100us, wu, model::team_color::yellow};
+
+  // 2台のロボットで1つの Radio を共有する
+  auto s = std::make_shared<mock_simulator_radio>();
+  d.register_robot(1, std::make_unique<mock_controller>(), s);
+  d.register_robot(3, std::make_unique<mock_controller>(), s);
+
+  command_updated_handler handler{};
+  d.on_command_updated(std::ref(handler));
+
+  {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    for (auto id : {1, 3}) {
+      auto r = md->add_robots_yellow();
+      r->set_robot_id(id);
+      r->set_x(0);
+      r->set_y(0);
+      r->set_orientation(0);
+      r->set_confidence(100);
+    }
+
+    wu.update(p);
+  }
+
+  ctx.run_one();
+  {
+    // 1周期の命令が1回の send_batch() にまとめられる
+    BOOST_TEST(s->batches_.size() == 1);
+    BOOST_TEST(s->commands_.empty());
+    BOOST_TEST(s->color_ == model::team_color::yellow);
+
+    std::vector<unsigned int> ids{};
+    for (const auto& c : s->batches_.front()) ids.push_back(c.id);
+    std::sort(ids.begin(), ids.end());
+    BOOST_TEST(ids == (std::vector<unsigned int>{1, 3}), boost::test_tools::per_element());
+
+    // 通知はロボット毎に行われる
+    BOOST_TEST(handler.commands.size() == 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(send_batch_without_simulator) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 100us, wu, model::team_color::blue};
+
+  // シミュレータでなくても, まとめて受け付ける Radio へは send_batch() で送る
+  auto b = std::make_shared<mock_batched_radio>();
+  auto m = std::make_shared<mock_radio>();
+  d.register_robot(1, std::make_unique<mock_controller>(), b);
+  d.register_robot(2, std::make_unique<mock_controller>(), b);
+  d.register_robot(3, std::make_unique<mock_controller>(), m);
+
+  {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    for (auto id : {1, 2, 3}) {
+      auto r = md->add_robots_blue();
+      r->set_robot_id(id);
+      r->set_x(0);
+      r->set_y(0);
+      r->set_orientation(0);
+      r->set_confidence(100);
+    }
+
+    wu.update(p);
+  }
+
+  ctx.run_one();
+
+  BOOST_TEST(b->batches_.size() == 1);
+  BOOST_TEST(b->batches_.front().size() == 2);
+  BOOST_TEST(b->commands_.empty());
+
+  // まとめて受け付けない Radio へは, これまで通り動作による命令を送る
+  BOOST_TEST(m->commands_.size() == 1);
+  BOOST_TEST(std::get<4>(m->commands_.front()) != nullptr);
+}
+
+// 送信した回数だけを数える Radio (送信でメモリを確保しない)
+struct counting_radio : public radio::base::command {
+  int sent = 0;
+
+  void send(model::team_color, unsigned int, const model::command::kick_flag_t&, int, double,
+            double, double) {
+    ++sent;
+  }
+
+  void send(model::team_color, unsigned int, std::shared_ptr<model::motion::base>) {
+    ++sent;
+  }
+};
+
+struct counting_simulator_radio : public counting_radio, public radio::base::simulator {
+  int batches = 0;
+
+  void send_batch(model::team_color,
+                  const std::vector<radio::base::robot_command>& c) override {
+    ++batches;
+    sent += static_cast<int>(c.size());
+  }
+
+  bool batched() const override {
+    return true;
+  }
+
+  void set_ball_position(double, double) {}
+  void set_robot_position(model::team_color, unsigned int, double, double, double) {}
+};
+
+BOOST_AUTO_TEST_CASE(zero_allocation) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 100us, wu, model::team_color::blue};
+
+  // Radio の種類は登録時に調べられ, 周期毎には調べない
+  auto r1 = std::make_shared<counting_radio>();
+  auto r2 = std::make_shared<counting_simulator_radio>();
+  d.register_robot(1, std::make_unique<mock_controller>(), r1);
+  d.register_robot(2, std::make_unique<mock_controller>(), r2);
+  d.register_robot(3, std::make_unique<mock_controller>(), r2);
+
+  {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    for (auto id : {1, 2, 3}) {
+      auto r = md->add_robots_blue();
+      r->set_robot_id(id);
+      r->set_x(0);
+      r->set_y(0);
+      r->set_orientation(0);
+      r->set_confidence(100);
+    }
+
+    wu.update(p);
+  }
+
+  // 動作が指定されていない命令を毎周期与える (Driver が動作を選ぶ)
+  model::command forward{};
+  forward.set_velocity(1000.0, 0.0, 0.0);
+  model::command turn{};
+  turn.set_velocity(0.0, 0.0, 1.0);
+
+  // 作業領域を確保させる
+  for (int i = 0; i < 4; ++i) {
+    d.update_command(1, i % 2 ? forward : turn);
+    d.update_command(2, i % 2 ? turn : forward);
+    ctx.run_one();
+  }
+
+  // 以降はメモリを確保しない
+  const auto before = allocation_count.load();
+  for (int i = 0; i < 100; ++i) {
+    d.update_command(1, i % 2 ? forward : turn);
+    d.update_command(2, i % 2 ? turn : forward);
+    d.update_command(3, {});
+    ctx.run_one();
+  }
+  BOOST_TEST(allocation_count.load() - before == 0u);
+
+  BOOST_TEST(r1->sent == 104);
+  BOOST_TEST(r2->batches == 104);
+  BOOST_TEST(r2->sent == 208);
+
+  // 送信した命令は telemetry に記録されている
+  for (auto id : {1u, 2u, 3u}) BOOST_TEST(d.telemetry().count(id) == 104u);
+  const auto last = d.telemetry().latest(1);
+  BOOST_TEST(last.has_value());
+  BOOST_TEST(last->motion_id != -1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
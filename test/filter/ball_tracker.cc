@@ -0,0 +1,101 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/filter/ball_tracker.h"
+#include "ai_server/model/ball.h"
+
+using namespace std::chrono_literals;
+
+namespace filter = ai_server::filter;
+namespace model  = ai_server::model;
+
+using observations = std::vector<filter::ball_tracker::observation>;
+
+BOOST_AUTO_TEST_SUITE(ball_tracker)
+
+BOOST_AUTO_TEST_CASE(empty) {
+  filter::ball_tracker bt{};
+
+  // 何も観測されていなければ値は無い
+  BOOST_TEST(!bt.best().has_value());
+  BOOST_TEST(bt.tracks().empty());
+
+  bt.update({}, std::chrono::system_clock::time_point{});
+  BOOST_TEST(!bt.best().has_value());
+}
+
+BOOST_AUTO_TEST_CASE(false_positive) {
+  filter::ball_tracker bt{};
+
+  auto t = std::chrono::system_clock::time_point{};
+
+  // ボールを追跡させる
+  for (auto i = 0u; i < 30; ++i) {
+    t += 16ms;
+    bt.update({{{1000, 500, 0}, 0.9}}, t);
+  }
+  BOOST_TEST(bt.best()->x() == 1000);
+  BOOST_TEST(bt.best()->y() == 500);
+
+  // 離れた位置に confidence の高い誤検出が1フレームだけ現れても値は飛ばない
+  t += 16ms;
+  bt.update({{{1000, 500, 0}, 0.5}, {{-3000, -2000, 0}, 1.0}}, t);
+  BOOST_TEST(bt.best()->x() == 1000);
+  BOOST_TEST(bt.best()->y() == 500);
+
+  // 誤検出も候補として保持されている
+  const auto tracks = bt.tracks();
+  BOOST_TEST(tracks.size() == 2);
+  BOOST_TEST(tracks.at(0).ball.x() == 1000);
+  BOOST_TEST(tracks.at(1).ball.x() == -3000);
+  BOOST_TEST(tracks.at(0).score > tracks.at(1).score);
+
+  // 一定時間観測されなかった候補は破棄される
+  for (auto i = 0u; i < 40; ++i) {
+    t += 16ms;
+    bt.update({{{1000, 500, 0}, 0.9}}, t);
+  }
+  BOOST_TEST(bt.tracks().size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(switch_track) {
+  filter::ball_tracker bt{};
+
+  auto t = std::chrono::system_clock::time_point{};
+
+  for (auto i = 0u; i < 10; ++i) {
+    t += 16ms;
+    bt.update({{{0, 0, 0}, 0.9}}, t);
+  }
+  BOOST_TEST(bt.best()->x() == 0);
+
+  // ボールが拾い上げられて別の場所に置かれたら, 新しい位置の候補に切り替わる
+  for (auto i = 0u; i < 20; ++i) {
+    t += 16ms;
+    bt.update({{{2000, 0, 0}, 0.9}}, t);
+  }
+  BOOST_TEST(bt.best()->x() == 2000);
+}
+
+BOOST_AUTO_TEST_CASE(bounded) {
+  filter::ball_tracker bt{};
+
+  auto t = std::chrono::system_clock::time_point{};
+
+  // 上限を大きく超える数の観測値を渡しても, トラック数は上限を超えない
+  observations obs{};
+  for (auto i = 0u; i < 100; ++i) {
+    obs.push_back({{i * 1000.0, 0, 0}, i / 100.0});
+  }
+  bt.update(obs, t);
+
+  const auto tracks = bt.tracks();
+  BOOST_TEST(tracks.size() == filter::ball_tracker::max_tracks);
+
+  // confidence の高いものから候補になる
+  BOOST_TEST(tracks.front().ball.x() == 99000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <atomic>
+#include <cmath>
+#include <optional>
+#include <thread>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/filter/kalman/robot.h"
+#include "ai_server/model/robot.h"
+#include "ai_server/model/updater/robot.h"
+#include "ai_server/util/math/angle.h"
+
+using namespace std::chrono_literals;
+
+namespace filter = ai_server::filter;
+namespace model  = ai_server::model;
+namespace util   = ai_server::util;
+
+using kf_same   = filter::kalman::robot<filter::timing::same>;
+using kf_manual = filter::kalman::robot<filter::timing::manual>;
+
+BOOST_AUTO_TEST_SUITE(kalman_robot)
+
+BOOST_AUTO_TEST_CASE(constant_velocity) {
+  kf_same f{};
+
+  auto t = std::chrono::system_clock::time_point{};
+  std::optional<model::robot> r{};
+
+  // 1000 mm/s, 1 rad/s で等速運動するロボットを 60 Hz で2秒間観測する (観測値には ±1 mm の誤差)
+  for (auto i = 0u; i < 120; ++i) {
+    t += 16666us;
+    const auto s = std::chrono::duration<double>(t.time_since_epoch()).count();
+    const auto e = (i % 2 == 0) ? 1.0 : -1.0;
+    const auto v = model::robot{1000 * s + e, -500 * s - e, util::math::wrap_to_pi(s)};
+    r            = f.update(v, t);
+  }
+
+  BOOST_TEST(r.has_value());
+  BOOST_TEST(std::abs(r->vx() - 1000.0) < 50.0);
+  BOOST_TEST(std::abs(r->vy() + 500.0) < 50.0);
+  BOOST_TEST(std::abs(r->omega() - 1.0) < 0.1);
+
+  // state_after() で等加速度モデルによる予測ができる
+  const auto after = r->state_after(100ms);
+  BOOST_TEST(after.has_value());
+  BOOST_TEST(std::abs(after->x() - (r->x() + 100.0)) < 10.0);
+}
+
+BOOST_AUTO_TEST_CASE(outlier) {
+  kf_same f{};
+
+  auto t = std::chrono::system_clock::time_point{};
+  for (auto i = 0u; i < 60; ++i) {
+    t += 16ms;
+    f.update(model::robot{1000, 500, 0}, t);
+  }
+
+  // 1フレームだけ大きく飛んだ観測値は捨てられる
+  t += 16ms;
+  const auto r1 = f.update(model::robot{3000, -500, 1}, t);
+  BOOST_TEST(std::abs(r1->x() - 1000) < 1.0);
+  BOOST_TEST(std::abs(r1->y() - 500) < 1.0);
+  BOOST_TEST(std::abs(r1->theta()) < 0.01);
+
+  // 外れ値が続いた場合はロボットが移動させられたとみなして追従する
+  for (auto i = 0u; i < 10; ++i) {
+    t += 16ms;
+    f.update(model::robot{3000, -500, 1}, t);
+  }
+  const auto r2 = f.update(model::robot{3000, -500, 1}, t + 16ms);
+  BOOST_TEST(std::abs(r2->x() - 3000) < 1.0);
+  BOOST_TEST(std::abs(r2->y() + 500) < 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(covariance) {
+  kf_same f{};
+
+  auto t = std::chrono::system_clock::time_point{};
+  f.update(model::robot{0, 0, 0}, t);
+  const auto c1 = f.covariance();
+
+  for (auto i = 0u; i < 30; ++i) {
+    t += 16ms;
+    f.update(model::robot{0, 0, 0}, t);
+  }
+  const auto c2 = f.covariance();
+
+  // 観測を重ねると速度の分散が小さくなる
+  BOOST_TEST(c2(1, 1) < c1(1, 1));
+  BOOST_TEST(c2(4, 4) < c1(4, 4));
+  BOOST_TEST(c2(7, 7) < c1(7, 7));
+  // 軸間の共分散は 0
+  BOOST_TEST(c2(0, 3) == 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(lost) {
+  filter::kalman::robot_parameters p{};
+  p.lost_duration = 100ms;
+  kf_same f{p};
+
+  auto t = std::chrono::system_clock::time_point{};
+  f.update(model::robot{0, 0, 0}, t);
+
+  // lost_duration までは予測値が返る
+  BOOST_TEST(f.update(std::nullopt, t + 50ms).has_value());
+  // lost_duration を過ぎるとロストする
+  BOOST_TEST(!f.update(std::nullopt, t + 150ms).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(manual) {
+  std::recursive_mutex mutex{};
+  std::optional<model::robot> written{};
+  kf_manual f{mutex, [&written](std::optional<model::robot> v) { written = v; }};
+
+  auto t = std::chrono::system_clock::time_point{};
+  for (auto i = 0u; i < 60; ++i) {
+    t += 16ms;
+    const auto s = std::chrono::duration<double>(t.time_since_epoch()).count();
+    f.set_raw_value(model::robot{1000 * s, 0, 0}, t);
+  }
+  BOOST_TEST(written.has_value());
+  const auto x = written->x();
+
+  // 制御指令が実行される時刻まで予測した値が書き込まれる
+  f.predict(t + 50ms);
+  BOOST_TEST(std::abs(written->x() - (x + 50.0)) < 5.0);
+
+  // 観測されなくなったらロストする
+  f.set_raw_value(std::nullopt, t + 100ms);
+  BOOST_TEST(!written.has_value());
+}
+
+BOOST_AUTO_TEST_CASE(covariance_while_updating) {
+  kf_same f{};
+
+  // 更新中に別のスレッドから共分散行列を読み出せる
+  std::atomic<bool> done{false};
+  std::thread th{[&f, &done] {
+    auto t = std::chrono::system_clock::time_point{};
+    for (auto i = 0u; i < 1000; ++i) {
+      t += 16ms;
+      f.update(model::robot{static_cast<double>(i), 0, 0}, t);
+    }
+    done = true;
+  }};
+
+  const kf_same& cf = f;
+  while (!done) {
+    const auto c = cf.covariance();
+    BOOST_TEST(c.allFinite());
+  }
+  th.join();
+
+  BOOST_TEST(cf.covariance()(0, 0) > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(default_filter) {
+  model::updater::robot<model::team_color::blue> ru;
+  ru.set_default_filter<kf_same>(filter::kalman::robot_parameters{});
+
+  for (auto i = 1u; i <= 30; ++i) {
+    ssl_protos::vision::Frame f;
+    f.set_camera_id(0);
+    f.set_t_capture(i * 0.016);
+
+    auto rb = f.add_robots_blue();
+    rb->set_robot_id(0);
+    rb->set_x(1000 * i * 0.016);
+    rb->set_y(0);
+    rb->set_orientation(0);
+    rb->set_confidence(90.0);
+
+    ru.update(f);
+  }
+
+  const auto rs = ru.value();
+  BOOST_TEST(rs.size() == 1);
+  BOOST_TEST(std::abs(rs.at(0).vx() - 1000.0) < 50.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
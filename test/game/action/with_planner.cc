@@ -2,7 +2,9 @@
 
 #include <cmath>
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <utility>
 
 #include <boost/test/unit_test.hpp>
 
@@ -31,6 +33,26 @@ struct mock_planner : public planner::base {
   }
 };
 
+// 時刻付きの軌道を出力する planner
+struct mock_trajectory_planner : public planner::base {
+  std::optional<Eigen::Vector2d> current_velocity;
+  std::optional<Eigen::Vector2d> velocity;
+
+  void set_current_velocity(const Eigen::Vector2d& v) override {
+    current_velocity = v;
+  }
+
+  std::optional<Eigen::Vector2d> velocity_at(double) const override {
+    return velocity;
+  }
+
+  virtual planner::base::planner_type planner() override {
+    return [](const Eigen::Vector2d& f, const Eigen::Vector2d&, const planner::obstacle_list&) {
+      return planner::base::result_type{f + Eigen::Vector2d(10, 20), 1.23};
+    };
+  }
+};
+
 struct stub_action : public action::base {
   stub_action(game::context& ctx, unsigned int id) : base{ctx, id}, cmd{} {}
 
@@ -50,20 +72,22 @@ BOOST_AUTO_TEST_SUITE(with_planner)
 BOOST_AUTO_TEST_CASE(execute) {
   game::context ctx{};
   {
-    ctx.team_color = model::team_color::yellow;
-    ctx.world.set_robots_yellow({
-        {123, {100, 200, 300}},
+    model::world w{};
+    w.set_robots_yellow({
+        {12, {100, 200, 300}},
     });
+    ctx.set_team_color(model::team_color::yellow);
+    ctx.set_world(std::move(w));
   }
 
-  auto a  = std::make_shared<stub_action>(ctx, 123);
+  auto a  = std::make_shared<stub_action>(ctx, 12);
   auto pp = std::make_unique<mock_planner>();
   auto& p = *pp;
   auto b  = std::make_shared<action::with_planner>(a, std::move(pp), planner::obstacle_list{});
 
   {
-    BOOST_TEST(a->id() == 123);
-    BOOST_TEST(b->id() == 123);
+    BOOST_TEST(a->id() == 12);
+    BOOST_TEST(b->id() == 12);
 
     a->f = true;
     BOOST_TEST(a->finished());
@@ -117,4 +141,48 @@ BOOST_AUTO_TEST_CASE(execute) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(trajectory) {
+  game::context ctx{};
+  {
+    model::robot r{100, 200, 300};
+    r.set_vx(400);
+    r.set_vy(-500);
+    model::world w{};
+    w.set_robots_yellow({{12, r}});
+    ctx.set_team_color(model::team_color::yellow);
+    ctx.set_world(std::move(w));
+  }
+
+  auto a  = std::make_shared<stub_action>(ctx, 12);
+  auto pp = std::make_unique<mock_trajectory_planner>();
+  auto& p = *pp;
+  auto b  = std::make_shared<action::with_planner>(a, std::move(pp), planner::obstacle_list{});
+
+  // 目標へ直進できるときは, これまで通り planner が算出した位置が出力される
+  {
+    a->cmd.set_position(4, 5);
+    const auto cmd = b->execute();
+
+    // planner に計測したロボットの速度が渡されている
+    BOOST_TEST(p.current_velocity.has_value());
+    BOOST_TEST(p.current_velocity->x() == 400);
+    BOOST_TEST(p.current_velocity->y() == -500);
+
+    auto& pos = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(std::get<0>(pos) == 100 + 10);
+    BOOST_TEST(std::get<1>(pos) == 200 + 20);
+  }
+
+  // 軌道に沿って障害物を避けているときは, 軌道の速度が出力される
+  {
+    p.velocity = Eigen::Vector2d{600, 700};
+    a->cmd.set_position(4, 5);
+    const auto cmd = b->execute();
+
+    auto& v = std::get<model::setpoint::velocity>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(std::get<0>(v) == 600);
+    BOOST_TEST(std::get<1>(v) == 700);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,40 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/game/context.h"
+#include "ai_server/game/nnabla.h"
+#include "ai_server/model/world.h"
+
+namespace game  = ai_server::game;
+namespace model = ai_server::model;
+using team      = game::spatial_index::team;
+
+BOOST_AUTO_TEST_SUITE(context)
+
+BOOST_AUTO_TEST_CASE(spatial) {
+  game::context ctx{};
+  BOOST_TEST((ctx.team_color() == model::team_color::blue));
+  BOOST_TEST(ctx.spatial().size(team::ours) == 0);
+
+  model::world w{};
+  w.set_robots_blue({{0, {-1000.0, 0.0, 0.0}}, {1, {1000.0, 0.0, 0.0}}});
+  w.set_robots_yellow({{2, {0.0, 500.0, 0.0}}});
+  w.set_ball({800.0, 0.0, 0.0});
+
+  // world を更新すると問い合わせも作り直される
+  ctx.set_world(w);
+  BOOST_TEST(ctx.world().robots_blue().size() == 2);
+  BOOST_TEST(ctx.spatial().size(team::ours) == 2);
+  BOOST_TEST(ctx.spatial().ball_position() == Eigen::Vector2d(800.0, 0.0));
+  BOOST_TEST(ctx.spatial().nearest(team::ours, ctx.spatial().ball_position())->id == 1);
+
+  // チームカラーを変えると自チームと敵チームが入れ替わる
+  ctx.set_team_color(model::team_color::yellow);
+  BOOST_TEST(ctx.spatial().size(team::ours) == 1);
+  BOOST_TEST(ctx.spatial().size(team::enemies) == 2);
+  BOOST_TEST(ctx.spatial().position(team::ours, 2).has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
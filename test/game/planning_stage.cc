@@ -0,0 +1,207 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/game/action/with_planner.h"
+#include "ai_server/game/context.h"
+#include "ai_server/game/nnabla.h"
+#include "ai_server/game/planning_stage.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/planner/base.h"
+#include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/rrt_star.h"
+
+namespace action  = ai_server::game::action;
+namespace game    = ai_server::game;
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+
+// 乱数シードを結果に反映する planner
+struct mock_planner : public planner::base {
+  std::optional<std::uint32_t> seed;
+  std::optional<std::chrono::steady_clock::time_point>* deadline = nullptr;
+
+  void set_seed(std::uint32_t s) override {
+    seed = s;
+  }
+
+  void set_deadline(std::chrono::steady_clock::time_point d) override {
+    if (deadline) *deadline = d;
+  }
+
+  virtual planner::base::planner_type planner() override {
+    return [this](const Eigen::Vector2d& f, const Eigen::Vector2d&,
+                  const planner::obstacle_list&) {
+      return planner::base::result_type{f + Eigen::Vector2d(seed.value_or(0) % 100, 0), 0.0};
+    };
+  }
+};
+
+struct stub_action : public action::base {
+  stub_action(game::context& ctx, unsigned int id, model::command c)
+      : base{ctx, id}, cmd{c} {}
+
+  bool finished() const override {
+    return false;
+  }
+
+  model::command cmd;
+  model::command execute() override {
+    return cmd;
+  }
+};
+
+static auto position(const model::command& c) {
+  return std::get<model::setpoint::position>(std::get<0>(c.setpoint_pair()));
+}
+
+static auto velocity(const model::command& c) {
+  return std::get<model::setpoint::velocity>(std::get<0>(c.setpoint_pair()));
+}
+
+BOOST_AUTO_TEST_SUITE(planning_stage)
+
+BOOST_AUTO_TEST_CASE(execute) {
+  game::context ctx{};
+  model::world w{};
+  w.set_robots_yellow({
+      {0, {100, 200, 0}},
+      {1, {300, 400, 0}},
+      {2, {500, 600, 0}},
+  });
+  ctx.set_team_color(model::team_color::yellow);
+  ctx.set_world(std::move(w));
+
+  model::command pos{};
+  pos.set_position(1000, 1000);
+  model::command vel{};
+  vel.set_velocity(1, 2);
+
+  // 同じ構成の action を作る
+  auto make_actions = [&ctx, &pos, &vel] {
+    std::vector<std::shared_ptr<action::base>> actions;
+    auto a0 = std::make_shared<stub_action>(ctx, 0, pos);
+    actions.push_back(std::make_shared<action::with_planner>(
+        a0, std::make_unique<mock_planner>(), planner::obstacle_list{}));
+    actions.push_back(std::make_shared<stub_action>(ctx, 1, vel));
+    auto a2 = std::make_shared<stub_action>(ctx, 2, pos);
+    actions.push_back(std::make_shared<action::with_planner>(
+        a2, std::make_unique<mock_planner>(), planner::obstacle_list{}));
+    return actions;
+  };
+
+  game::planning_stage serial{0};
+  game::planning_stage parallel{4};
+
+  const auto actions1 = make_actions();
+  const auto actions2 = make_actions();
+  for (auto i = 0; i < 3; ++i) {
+    const auto r1 = serial.execute(actions1);
+    const auto r2 = parallel.execute(actions2);
+
+    // actions と同じ順序で結果が返る
+    BOOST_TEST(r1.size() == 3);
+    BOOST_TEST(r1.at(0).first == 0);
+    BOOST_TEST(r1.at(1).first == 1);
+    BOOST_TEST(r1.at(2).first == 2);
+
+    // planner を使わない action の結果はそのまま
+    const auto v = velocity(r1.at(1).second);
+    BOOST_TEST(std::get<0>(v) == 1.0);
+    BOOST_TEST(std::get<1>(v) == 2.0);
+
+    // 経路探索の結果はスレッド数によらず同じになる
+    for (auto j : {0u, 2u}) {
+      BOOST_TEST(std::get<0>(position(r1.at(j).second)) ==
+                 std::get<0>(position(r2.at(j).second)));
+      BOOST_TEST(std::get<1>(position(r1.at(j).second)) ==
+                 std::get<1>(position(r2.at(j).second)));
+    }
+  }
+  BOOST_TEST(serial.tick() == 3);
+
+  // 同じ周期でもロボット毎に異なる乱数シードが設定される
+  const auto r = game::planning_stage{0}.execute(make_actions());
+  BOOST_TEST(std::get<0>(position(r.at(0).second)) - 100 !=
+             std::get<0>(position(r.at(2).second)) - 500);
+}
+
+BOOST_AUTO_TEST_CASE(time_budget) {
+  using namespace std::chrono_literals;
+
+  game::context ctx{};
+  model::world w{};
+  w.set_robots_yellow({{0, {100, 200, 0}}});
+  ctx.set_team_color(model::team_color::yellow);
+  ctx.set_world(std::move(w));
+
+  model::command pos{};
+  pos.set_position(1000, 1000);
+
+  std::optional<std::chrono::steady_clock::time_point> deadline{};
+  auto p      = std::make_unique<mock_planner>();
+  p->deadline = &deadline;
+  auto a      = std::make_shared<stub_action>(ctx, 0, pos);
+  const std::vector<std::shared_ptr<action::base>> actions{
+      std::make_shared<action::with_planner>(a, std::move(p), planner::obstacle_list{})};
+
+  game::planning_stage stage{0};
+
+  // 設定しなければ打ち切り時刻は渡されない
+  stage.execute(actions);
+  BOOST_TEST(!deadline.has_value());
+
+  // 経路探索を始めた時刻に budget を足した時刻が渡される
+  stage.set_time_budget(5ms);
+  const auto before = std::chrono::steady_clock::now();
+  stage.execute(actions);
+  const auto after = std::chrono::steady_clock::now();
+  BOOST_TEST(deadline.has_value());
+  BOOST_TEST((*deadline >= before + 5ms && *deadline <= after + 5ms));
+}
+
+BOOST_AUTO_TEST_CASE(more_planners_than_threads) {
+  using namespace std::chrono_literals;
+
+  // 各ロボットと目標の間に障害物がある
+  game::context ctx{};
+  ctx.set_team_color(model::team_color::yellow);
+  model::world::robots_list robots{};
+  std::vector<std::shared_ptr<action::base>> actions{};
+  for (unsigned int id = 0; id < 6; ++id) {
+    const double y = 500.0 * id;
+    robots.insert({id, {-2000, y, 0}});
+
+    model::command pos{};
+    pos.set_position(2000, y);
+    auto rrt = std::make_unique<planner::rrt_star>();
+    rrt->set_node_count(100);
+    planner::obstacle_list obs{};
+    obs.add(model::obstacle::point{{0.0, y}, 200.0});
+    auto a = std::make_shared<stub_action>(ctx, id, pos);
+    actions.push_back(std::make_shared<action::with_planner>(a, std::move(rrt), obs));
+  }
+  model::world w{};
+  w.set_robots_yellow(robots);
+  ctx.set_world(std::move(w));
+
+  // worker より planner が多く, 打ち切り時刻の後に始まる planner があっても
+  // 全てのロボットが初期位置から動く
+  game::planning_stage stage{1};
+  stage.set_time_budget(0ns);
+  const auto r = stage.execute(actions);
+  for (unsigned int id = 0; id < 6; ++id) {
+    const auto p = position(r.at(id).second);
+    BOOST_TEST(std::hypot(std::get<0>(p) + 2000.0, std::get<1>(p) - 500.0 * id) > 0.0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/game/spatial_index.h"
+#include "ai_server/model/world.h"
+
+namespace game  = ai_server::game;
+namespace model = ai_server::model;
+using team      = game::spatial_index::team;
+
+namespace {
+
+model::world make_world() {
+  model::world w{};
+  w.set_robots_blue({
+      {0, {-1000.0, 0.0, 0.0}},
+      {1, {0.0, 1000.0, 0.0}},
+      {3, {2000.0, 0.0, 0.0}},
+  });
+  w.set_robots_yellow({
+      {2, {1000.0, 0.0, 0.0}},
+      {5, {-1000.0, 0.0, 0.0}},
+  });
+  model::ball b{500.0, 0.0, 0.0};
+  b.set_vx(1000.0);
+  w.set_ball(b);
+  return w;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(spatial_index)
+
+BOOST_AUTO_TEST_CASE(team_and_position) {
+  const auto w = make_world();
+
+  // 自チームが青
+  const game::spatial_index blue{w, model::team_color::blue};
+  BOOST_TEST(blue.size(team::ours) == 3);
+  BOOST_TEST(blue.size(team::enemies) == 2);
+  BOOST_TEST(blue.position(team::ours, 1).value() == Eigen::Vector2d(0.0, 1000.0));
+  BOOST_TEST(!blue.position(team::ours, 2).has_value());
+  BOOST_TEST(!blue.position(team::ours, 100).has_value());
+  BOOST_TEST(blue.ball_position() == Eigen::Vector2d(500.0, 0.0));
+  BOOST_TEST(blue.ball_velocity() == Eigen::Vector2d(1000.0, 0.0));
+
+  // 自チームが黄
+  const game::spatial_index yellow{w, model::team_color::yellow};
+  BOOST_TEST(yellow.size(team::ours) == 2);
+  BOOST_TEST(yellow.position(team::ours, 2).value() == Eigen::Vector2d(1000.0, 0.0));
+}
+
+BOOST_AUTO_TEST_CASE(nearest) {
+  const game::spatial_index s{make_world(), model::team_color::blue};
+
+  const auto a = s.nearest(team::ours, {1500.0, 0.0});
+  BOOST_TEST_REQUIRE(a.has_value());
+  BOOST_TEST(a->id == 3u);
+  BOOST_TEST(a->value == 500.0);
+
+  // 候補の中から探す (見えていない ID は無視する)
+  const auto b = s.nearest(team::ours, {1500.0, 0.0}, {0, 1, 7});
+  BOOST_TEST_REQUIRE(b.has_value());
+  BOOST_TEST(b->id == 1u);
+
+  // 距離が等しいときは候補の順序で先のもの
+  const auto c = s.nearest(team::ours, {-500.0, 500.0}, {1, 0});
+  BOOST_TEST_REQUIRE(c.has_value());
+  BOOST_TEST(c->id == 1u);
+
+  BOOST_TEST(!s.nearest(team::ours, {0.0, 0.0}, {7}).has_value());
+  BOOST_TEST(!game::spatial_index{}.nearest(team::enemies, {0.0, 0.0}).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(nearest_k_and_within) {
+  const game::spatial_index s{make_world(), model::team_color::blue};
+
+  const auto k = s.nearest_k(team::ours, {1800.0, 0.0}, 2);
+  BOOST_TEST_REQUIRE(k.size() == 2);
+  BOOST_TEST(k[0].id == 3u);
+  BOOST_TEST(k[1].id == 1u);
+
+  const auto all = s.nearest_k(team::ours, {1800.0, 0.0}, 10);
+  BOOST_TEST(all.size() == 3);
+
+  const auto r = s.within(team::enemies, {0.0, 0.0}, 1000.0);
+  BOOST_TEST_REQUIRE(r.size() == 2);
+  // 距離が等しいときは ID の昇順
+  BOOST_TEST(r[0].id == 2u);
+  BOOST_TEST(r[1].id == 5u);
+  BOOST_TEST(s.within(team::enemies, {0.0, 0.0}, 999.0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(closest_to_line) {
+  const game::spatial_index s{make_world(), model::team_color::blue};
+
+  // (0, 1000) のロボットがパスコースに近い
+  const auto a = s.closest_to_line(team::ours, {-2000.0, 1200.0}, {2000.0, 1200.0});
+  BOOST_TEST_REQUIRE(a.has_value());
+  BOOST_TEST(a->id == 1u);
+  BOOST_TEST(a->value == 200.0);
+
+  // 線分の端点より先は端点からの距離
+  const auto b = s.closest_to_line(team::enemies, {3000.0, 0.0}, {4000.0, 0.0});
+  BOOST_TEST_REQUIRE(b.has_value());
+  BOOST_TEST(b->id == 2u);
+  BOOST_TEST(b->value == 2000.0);
+}
+
+BOOST_AUTO_TEST_CASE(time_to_intercept) {
+  const game::spatial_index s{make_world(), model::team_color::blue};
+
+  // 止まっている目標には距離 / 速さ
+  const auto a = s.time_to_intercept(team::enemies, {1000.0, 2000.0}, {0.0, 0.0}, 1000.0);
+  BOOST_TEST_REQUIRE(a.has_value());
+  BOOST_TEST(a->id == 2u);
+  BOOST_TEST(a->value == 2.0, boost::test_tools::tolerance(1e-9));
+
+  // ボール (500, 0) は +x 方向に 1000 mm/s で動く
+  // 前にいる (2000, 0) は 0.5 s, 後ろの (-1000, 0) は 1.5 s かかる
+  const auto b = s.time_to_intercept_ball(team::ours, 2000.0);
+  BOOST_TEST_REQUIRE(b.has_value());
+  BOOST_TEST(b->id == 3u);
+  BOOST_TEST(b->value == 0.5, boost::test_tools::tolerance(1e-9));
+
+  // ボールより遅いと後ろからは追いつけない
+  const auto c = s.time_to_intercept(team::ours, {500.0, 0.0}, {1000.0, 0.0}, 500.0);
+  BOOST_TEST_REQUIRE(c.has_value());
+  BOOST_TEST(c->id == 3u);
+  BOOST_TEST(!s.time_to_intercept(team::ours, {2500.0, 0.0}, {1000.0, 0.0}, 500.0));
+}
+
+BOOST_AUTO_TEST_CASE(update) {
+  auto w = make_world();
+  game::spatial_index s{w, model::team_color::blue};
+
+  // 見えなくなったロボットは含まれない
+  w.set_robots_blue({{1, {0.0, 1000.0, 0.0}}});
+  s.update(w, model::team_color::blue);
+  BOOST_TEST(s.size(team::ours) == 1);
+  BOOST_TEST(!s.position(team::ours, 3).has_value());
+  BOOST_TEST(s.nearest(team::ours, {2000.0, 0.0})->id == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,9 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <chrono>
+#include <cmath>
+#include <optional>
+
 #include <boost/math/constants/constants.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -543,4 +547,59 @@ BOOST_AUTO_TEST_CASE(manual_filter2, *boost::unit_test::tolerance(0.0000001)) {
   }
 }
 
+// 前回の値との差分から速度を求める Filter
+struct difference_filter : public filter::base<model::ball, filter::timing::same> {
+  std::optional<model::ball> prev{};
+  std::chrono::system_clock::time_point prev_t{};
+
+  std::optional<model::ball> update(std::optional<model::ball> value,
+                                    std::chrono::system_clock::time_point t) override {
+    if (!value) return std::nullopt;
+    auto b = *value;
+    if (prev && t > prev_t) {
+      const auto dt = std::chrono::duration<double>(t - prev_t).count();
+      b.set_vx((b.x() - prev->x()) / dt);
+      b.set_vy((b.y() - prev->y()) / dt);
+    }
+    prev   = b;
+    prev_t = t;
+    return b;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(tracker_multi_camera, *boost::unit_test::tolerance(0.05)) {
+  model::updater::ball bu;
+  bu.set_tracker();
+  bu.set_filter<difference_filter>();
+
+  // 4台のカメラが順にフレームを送り, カメラ0だけが x 方向に 1000 mm/s で動くボールを見ている
+  constexpr double cycle = 1.0 / 60.0;
+  for (int i = 0; i < 60; ++i) {
+    for (unsigned int camera = 0; camera < 4; ++camera) {
+      const double t = i * cycle + camera * cycle / 4;
+
+      ssl_protos::vision::Frame f;
+      f.set_camera_id(camera);
+      f.set_t_capture(t);
+      if (camera == 0) {
+        auto b = f.add_balls();
+        b->set_x(1000.0 * t);
+        b->set_y(500.0);
+        b->set_z(0.0);
+        b->set_confidence(90.0);
+      }
+      bu.update(f);
+
+      // 状態オブザーバの推定値が収束した後は, ボールを見ていないカメラのフレームでも
+      // 古い値が新しい時刻として Filter に渡されず, 速度が保たれる
+      if (i >= 30) {
+        const auto v = bu.value();
+        BOOST_TEST(!v.is_lost());
+        BOOST_TEST(v.vx() == 1000.0);
+        BOOST_TEST(std::abs(v.vy()) < 1.0);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
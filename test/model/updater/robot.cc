@@ -1,5 +1,7 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <cmath>
+
 #include <boost/math/constants/constants.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -810,4 +812,131 @@ BOOST_AUTO_TEST_CASE(manual_filter2, *boost::unit_test::tolerance(0.0000001)) {
   }
 }
 
+// 1つのカメラで同じIDが複数検出されたときや, 範囲外のカメラIDのとき
+BOOST_AUTO_TEST_CASE(duplicated, *boost::unit_test::tolerance(0.0000001)) {
+  model::updater::robot<model::team_color::blue> ru;
+
+  {
+    ssl_protos::vision::Frame f;
+    f.set_camera_id(0);
+
+    auto rb1 = f.add_robots_blue();
+    rb1->set_robot_id(1);
+    rb1->set_x(10);
+    rb1->set_y(20);
+    rb1->set_orientation(rad(30));
+    rb1->set_confidence(80.0);
+
+    auto rb1b = f.add_robots_blue();
+    rb1b->set_robot_id(1);
+    rb1b->set_x(40);
+    rb1b->set_y(50);
+    rb1b->set_orientation(rad(60));
+    rb1b->set_confidence(90.0);
+
+    ru.update(f);
+  }
+
+  {
+    // confidenceの高いほうが選ばれる
+    const auto rb = ru.value();
+    BOOST_TEST(rb.size() == 1);
+    BOOST_TEST(rb.at(1).x() == 40);
+    BOOST_TEST(rb.at(1).y() == 50);
+    BOOST_TEST(rb.at(1).theta() == rad(60));
+  }
+
+  {
+    ssl_protos::vision::Frame f;
+    f.set_camera_id(model::updater::max_cameras);
+
+    auto rb2 = f.add_robots_blue();
+    rb2->set_robot_id(2);
+    rb2->set_confidence(90.0);
+
+    ru.update(f);
+  }
+
+  {
+    // 扱えるIDの範囲外のカメラからのデータは無視される
+    const auto rb = ru.value();
+    BOOST_TEST(rb.size() == 1);
+    BOOST_TEST(rb.count(2) == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fusion, *boost::unit_test::tolerance(0.0000001)) {
+  model::updater::robot<model::team_color::blue> ru;
+  ru.set_fusion_window(100ms);
+
+  {
+    ssl_protos::vision::Frame f;
+    f.set_camera_id(0);
+    f.set_t_capture(1.0);
+
+    auto rb1 = f.add_robots_blue();
+    rb1->set_robot_id(1);
+    rb1->set_x(0);
+    rb1->set_y(0);
+    rb1->set_orientation(rad(0));
+    rb1->set_confidence(90.0);
+
+    ru.update(f);
+  }
+
+  {
+    // 1つのカメラでしか検出されていなければその値がそのまま使われる
+    const auto rb = ru.value();
+    BOOST_TEST(rb.at(1).x() == 0);
+    BOOST_TEST(rb.at(1).y() == 0);
+    BOOST_TEST(rb.at(1).theta() == rad(0));
+  }
+
+  {
+    ssl_protos::vision::Frame f;
+    f.set_camera_id(1);
+    f.set_t_capture(1.05);
+
+    auto rb1 = f.add_robots_blue();
+    rb1->set_robot_id(1);
+    rb1->set_x(300);
+    rb1->set_y(30);
+    rb1->set_orientation(rad(90));
+    rb1->set_confidence(90.0);
+
+    ru.update(f);
+  }
+
+  {
+    // cam0 の値は 50ms 前のものなので重みは cam1 の半分になる
+    const auto rb = ru.value();
+    BOOST_TEST(rb.at(1).x() == 200);
+    BOOST_TEST(rb.at(1).y() == 20);
+    BOOST_TEST(rb.at(1).theta() == std::atan2(1.0, 0.5));
+  }
+
+  {
+    ssl_protos::vision::Frame f;
+    f.set_camera_id(1);
+    f.set_t_capture(1.2);
+
+    auto rb1 = f.add_robots_blue();
+    rb1->set_robot_id(1);
+    rb1->set_x(400);
+    rb1->set_y(40);
+    rb1->set_orientation(rad(90));
+    rb1->set_confidence(90.0);
+
+    ru.update(f);
+  }
+
+  {
+    // cam0 の値は fusion_window 以上前のものなので使われない
+    const auto rb = ru.value();
+    BOOST_TEST(rb.at(1).x() == 400);
+    BOOST_TEST(rb.at(1).y() == 40);
+    BOOST_TEST(rb.at(1).theta() == rad(90));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
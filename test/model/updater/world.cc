@@ -1,5 +1,7 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <chrono>
+#include <cstddef>
 #include <stdexcept>
 #include <boost/math/constants/constants.hpp>
 #include <boost/test/unit_test.hpp>
@@ -335,4 +337,102 @@ BOOST_AUTO_TEST_CASE(disabling_camera) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(snapshot) {
+  ai_server::model::updater::world wu{};
+
+  // 更新されるまでは同じオブジェクトが返される
+  const auto s1 = wu.snapshot();
+  BOOST_TEST(s1 == wu.snapshot());
+  BOOST_TEST(s1->robots_blue().size() == 0);
+
+  {
+    ssl_protos::vision::Packet p;
+
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    auto rb1 = md->add_robots_blue();
+    rb1->set_robot_id(1);
+    rb1->set_x(10);
+    rb1->set_y(11);
+    rb1->set_orientation(0);
+    rb1->set_confidence(94.0);
+
+    wu.update(p);
+  }
+
+  // 更新されたら新しいオブジェクトが返される
+  const auto s2 = wu.snapshot();
+  BOOST_TEST(s1 != s2);
+  BOOST_TEST(s2->robots_blue().size() == 1);
+  BOOST_TEST(s2 == wu.snapshot());
+
+  // 以前に取得したオブジェクトは変化しない
+  BOOST_TEST(s1->robots_blue().size() == 0);
+
+  // value() は最新の値を返す
+  BOOST_TEST(wu.value().robots_blue().size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(frame_completion) {
+  ai_server::model::updater::world wu{};
+
+  // 発火した回数と, そのときに snapshot() に反映されていた青ロボットの台数
+  int count          = 0;
+  std::size_t robots = 0;
+  std::chrono::system_clock::time_point time{};
+  wu.on_frame_completed([&](auto t) {
+    ++count;
+    robots = wu.snapshot()->robots_blue().size();
+    time   = t;
+  });
+
+  // カメラ id から, t_capture が t [s] の検出結果が届いた
+  auto receive = [&wu](unsigned int id, double t) {
+    ssl_protos::vision::Packet p;
+    auto md = p.mutable_detection();
+    md->set_camera_id(id);
+    md->set_t_capture(t);
+    auto rb = md->add_robots_blue();
+    rb->set_robot_id(id);
+    rb->set_x(100.0 * id);
+    rb->set_y(0);
+    rb->set_orientation(0);
+    rb->set_confidence(90.0);
+    wu.update(p);
+  };
+
+  // 最初はカメラの台数が分からないので, 同じカメラから2回目が届いたときに揃ったとする
+  receive(0, 1.0);
+  receive(1, 1.001);
+  BOOST_TEST(count == 0);
+  receive(0, 1.016);
+  BOOST_TEST(count == 1);
+  BOOST_TEST(wu.frame_count() == 1u);
+
+  // 以降はカメラ 0, 1 の両方から届いたら揃う
+  receive(1, 1.017);
+  BOOST_TEST(count == 2);
+  BOOST_TEST(robots == 2u);
+  BOOST_TEST(std::chrono::duration<double>(time.time_since_epoch()).count() == 1.017,
+             boost::test_tools::tolerance(1e-5));
+
+  // 揃ったフレームの時刻が記録されている
+  const auto last = wu.last_frame();
+  BOOST_TEST(last.frame == 2u);
+  BOOST_TEST((last.captured == time));
+  BOOST_TEST((last.received <= last.published));
+
+  // 無効化されたカメラの分は待たない (1フレーム遅れて追従する)
+  wu.disable_camera(1);
+  receive(0, 1.033);
+  receive(1, 1.034);
+  BOOST_TEST(count == 2);
+  receive(0, 1.050);
+  BOOST_TEST(count == 3);
+  receive(0, 1.066);
+  BOOST_TEST(count == 4);
+  BOOST_TEST(wu.frame_count() == 4u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
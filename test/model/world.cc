@@ -30,6 +30,12 @@ BOOST_AUTO_TEST_CASE(nyan) {
 
     BOOST_TEST(w.robots_blue().size() == 0);
     BOOST_TEST(w.robots_yellow().size() == 0);
+
+    // getter は複製せずに, 保持するメンバへの参照を返す
+    BOOST_TEST(&w.field() == &w.field());
+    BOOST_TEST(&w.ball() == &w.ball());
+    BOOST_TEST(&w.robots_blue() == &w.robots_blue());
+    BOOST_TEST(&w.robots_yellow() == &w.robots_yellow());
   }
 
   {
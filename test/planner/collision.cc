@@ -0,0 +1,109 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/detail/obstacle_arrays.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace obstacle = ai_server::model::obstacle;
+namespace detail   = ai_server::planner::detail;
+using ai_server::planner::obstacle_list;
+
+BOOST_AUTO_TEST_SUITE(planner_collision)
+
+// ランダムに障害物を配置したリストを作る
+static obstacle_list make_obstacles(std::mt19937& mt) {
+  std::uniform_real_distribution<double> pos(-4000.0, 4000.0);
+  std::uniform_real_distribution<double> size(0.0, 1000.0);
+  std::uniform_real_distribution<double> margin(50.0, 300.0);
+
+  obstacle_list list;
+  for (auto i = 0; i < 10; ++i) {
+    const Eigen::Vector2d p{pos(mt), pos(mt)};
+    list.add(obstacle::point{p, margin(mt)});
+    list.add(obstacle::segment{{p, p + Eigen::Vector2d{size(mt), size(mt) - 500.0}}, margin(mt)});
+    list.add(obstacle::box{{p, p + Eigen::Vector2d{size(mt), size(mt)}}, margin(mt)});
+  }
+  return list;
+}
+
+BOOST_AUTO_TEST_CASE(find_collided_length) {
+  using ray_type = boost::geometry::model::segment<Eigen::Vector2d>;
+
+  std::mt19937 mt{42};
+  std::uniform_real_distribution<double> pos(-4000.0, 4000.0);
+  std::uniform_real_distribution<double> angle(-3.14, 3.14);
+
+  std::vector<double> lengths;
+  for (auto l = 10.0; l <= 4000.0; l += 10.0) lengths.push_back(l);
+
+  for (auto n = 0; n < 20; ++n) {
+    const auto list = make_obstacles(mt);
+    const auto tree = list.to_tree();
+
+    detail::obstacle_arrays arrays{};
+    arrays.add(list.index(), detail::to_envelope(Eigen::Vector2d{0.0, 0.0}, 1e5));
+    BOOST_TEST(arrays.size() == list.size());
+
+    for (auto m = 0; m < 50; ++m) {
+      const Eigen::Vector2d start{pos(mt), pos(mt)};
+      const auto a = angle(mt);
+      const Eigen::Vector2d dir{std::cos(a), std::sin(a)};
+
+      // rayを伸ばしながら当たり判定を行ったときの結果
+      const auto expected = std::partition_point(
+          lengths.begin(), lengths.end(), [&start, &dir, &tree](auto l) {
+            return !detail::is_collided(ray_type{start, start + l * dir}, tree);
+          });
+
+      // 解析的に求めた結果と一致する
+      const auto by_tree =
+          detail::find_collided_length(lengths.begin(), lengths.end(), start, dir, tree);
+      const auto by_arrays =
+          detail::find_collided_length(lengths.begin(), lengths.end(), start, dir, arrays);
+      BOOST_TEST(std::distance(lengths.begin(), by_tree) ==
+                 std::distance(lengths.begin(), expected));
+      BOOST_TEST(std::distance(lengths.begin(), by_arrays) ==
+                 std::distance(lengths.begin(), expected));
+
+      // 点の当たり判定も一致する
+      BOOST_TEST(detail::is_collided(start, arrays) == detail::is_collided(start, tree));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ray_distance) {
+  // 円の手前で止まる
+  const auto t1 = detail::ray_distance({-1000.0, 0.0}, {1.0, 0.0},
+                                       obstacle::point{{0.0, 0.0}, 100.0});
+  BOOST_TEST(t1 == 900.0);
+
+  // 線分の端の円に当たる
+  const auto t2 = detail::ray_distance(
+      {-1000.0, 0.0}, {1.0, 0.0}, obstacle::segment{{{0.0, 0.0}, {0.0, 1000.0}}, 100.0});
+  BOOST_TEST(t2 == 900.0);
+
+  // 矩形の辺に当たる
+  const auto t3 = detail::ray_distance(
+      {-1000.0, 500.0}, {1.0, 0.0}, obstacle::box{{{0.0, 0.0}, {1000.0, 1000.0}}, 100.0});
+  BOOST_TEST(t3 == 900.0);
+
+  // 始点が障害物の中にあるとき
+  const auto t4 =
+      detail::ray_distance({0.0, 0.0}, {1.0, 0.0}, obstacle::point{{0.0, 0.0}, 100.0});
+  BOOST_TEST(t4 == 0.0);
+
+  // 当たらないとき
+  const auto t5 = detail::ray_distance({-1000.0, 0.0}, {-1.0, 0.0},
+                                       obstacle::point{{0.0, 0.0}, 100.0});
+  BOOST_TEST(t5 == detail::no_intersection);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
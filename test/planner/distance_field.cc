@@ -0,0 +1,141 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/model/field.h"
+#include "ai_server/model/obstacle/field.h"
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/detail/distance_field.h"
+#include "ai_server/planner/detail/obstacle_arrays.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace obstacle = ai_server::model::obstacle;
+namespace detail   = ai_server::planner::detail;
+using ai_server::model::field;
+using ai_server::planner::obstacle_list;
+
+BOOST_AUTO_TEST_SUITE(planner_distance_field)
+
+BOOST_AUTO_TEST_CASE(clearance) {
+  const detail::envelope_type area{{-2000.0, -2000.0}, {2000.0, 2000.0}};
+  const detail::distance_field f{area,
+                                 10.0,
+                                 {obstacle::point{{0.0, 0.0}, 300.0},
+                                  obstacle::segment{{{-1000.0, 1000.0}, {1000.0, 1200.0}}, 100.0},
+                                  obstacle::box{{{500.0, -1500.0}, {3000.0, -500.0}}, 150.0}}};
+
+  // 格子点の値
+  BOOST_TEST(f.clearance({0.0, 500.0}) == 200.0, boost::test_tools::tolerance(1e-3));
+  BOOST_TEST(f.clearance({0.0, 0.0}) == -300.0, boost::test_tools::tolerance(1e-3));
+
+  // 格子の外側は直接計算する (box の内側では最も近い辺までの深さだけ小さくなる)
+  BOOST_TEST(f.clearance({2800.0, -1000.0}) == -350.0, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(f.clearance({-2500.0, -2500.0}) == std::hypot(3000.0, 1000.0) - 150.0,
+             boost::test_tools::tolerance(1e-9));
+
+  // box の内側でも，最も近い辺へ向かう方向が求まる
+  const auto g = f.gradient({1000.0, -1300.0});
+  BOOST_TEST(g.x() == 0.0, boost::test_tools::tolerance(1e-3));
+  BOOST_TEST(g.y() == -1.0, boost::test_tools::tolerance(1e-3));
+
+  // 格子点の間でも当たり判定の結果は変わらない
+  std::mt19937 mt{1};
+  std::uniform_real_distribution<double> pos(-2500.0, 2500.0);
+  for (auto i = 0; i < 10000; ++i) {
+    const Eigen::Vector2d p{pos(mt), pos(mt)};
+    const auto exact = std::min({(p - Eigen::Vector2d{0.0, 0.0}).norm() - 300.0,
+                                 std::sqrt(detail::squared_distance_to_segment(
+                                     p.x(), p.y(), -1000.0, 1000.0, 1000.0, 1200.0)) -
+                                     100.0,
+                                 std::sqrt(detail::squared_distance_to_box(
+                                     p.x(), p.y(), 500.0, -1500.0, 3000.0, -500.0)) -
+                                     150.0});
+    if (std::abs(exact) > 1.0) BOOST_TEST(f.is_collided(p) == (exact < 0.0));
+    // 複数の障害物から等距離の点の近くでは，格子の間隔の半分程度ずれる
+    if (exact > 0.0) BOOST_TEST(std::abs(f.clearance(p) - exact) < 5.0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cached) {
+  field wf{};
+  wf.set_length(12000);
+  wf.set_width(9000);
+  wf.set_penalty_length(1800);
+  wf.set_penalty_width(3600);
+
+  // 同じ条件なら作り直さない
+  const auto f1 = obstacle::penalty_areas(wf, 150.0);
+  const auto f2 = obstacle::penalty_areas(wf, 150.0);
+  BOOST_TEST(f1 == f2);
+
+  // 条件が変われば作り直す
+  const auto f3 = obstacle::penalty_areas(wf, 100.0);
+  BOOST_TEST(f1 != f3);
+  wf.set_length(9000);
+  const auto f4 = obstacle::penalty_areas(wf, 150.0);
+  BOOST_TEST(f1 != f4);
+}
+
+BOOST_AUTO_TEST_CASE(obstacle_list_with_field) {
+  field wf{};
+  wf.set_length(12000);
+  wf.set_width(9000);
+  wf.set_penalty_length(1800);
+  wf.set_penalty_width(3600);
+
+  obstacle_list list;
+  list.add(obstacle::point{{0.0, 0.0}, 300.0});
+  list.set_static(obstacle::penalty_areas(wf, 150.0));
+  list.freeze();
+
+  // コピーしても距離場は共有される
+  const auto copy = list;
+  BOOST_TEST(copy.static_field() == list.static_field());
+
+  const auto idx  = copy.index();
+  const auto tree = copy.to_tree();
+  BOOST_TEST(tree.size() == 3);
+
+  detail::obstacle_arrays arrays{};
+  arrays.add(idx, detail::to_envelope(Eigen::Vector2d{0.0, 0.0}, 1e5));
+
+  // ペナルティエリアの中
+  const Eigen::Vector2d in_penalty{-5500.0, 0.0};
+  BOOST_TEST(detail::is_collided(in_penalty, idx));
+  BOOST_TEST(detail::is_collided(in_penalty, arrays));
+
+  // RTreeで全ての障害物を調べたときと同じ長さでぶつかる (ray を伸ばす間隔の分だけずれてよい)
+  std::vector<double> lengths;
+  for (auto l = 10.0; l <= 8000.0; l += 10.0) lengths.push_back(l);
+
+  std::mt19937 mt{2};
+  std::uniform_real_distribution<double> x(-6000.0, 6000.0);
+  std::uniform_real_distribution<double> y(-4500.0, 4500.0);
+  std::uniform_real_distribution<double> angle(-3.14, 3.14);
+  for (auto i = 0; i < 300; ++i) {
+    const Eigen::Vector2d start{x(mt), y(mt)};
+    const auto a = angle(mt);
+    const Eigen::Vector2d dir{std::cos(a), std::sin(a)};
+
+    const auto expected = std::distance(
+        lengths.begin(),
+        detail::find_collided_length(lengths.begin(), lengths.end(), start, dir, tree));
+    const auto by_index = std::distance(
+        lengths.begin(),
+        detail::find_collided_length(lengths.begin(), lengths.end(), start, dir, idx));
+    const auto by_arrays = std::distance(
+        lengths.begin(),
+        detail::find_collided_length(lengths.begin(), lengths.end(), start, dir, arrays));
+    BOOST_TEST(std::abs(by_index - expected) <= 1);
+    BOOST_TEST(std::abs(by_arrays - expected) <= 1);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <algorithm>
+#include <vector>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/box.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/model/obstacle/segment.h"
+#include "ai_server/planner/detail/clipping.h"
+#include "ai_server/planner/detail/distance_field.h"
+#include "ai_server/planner/detail/obstacle_arrays.h"
+#include "ai_server/planner/human_like.h"
+#include "ai_server/planner/impl/human_like.h"
+#include "ai_server/planner/obstacle_list.h"
+#include "test_helpers/allocation_counter.h"
+
+namespace obstacle = ai_server::model::obstacle;
+namespace detail   = ai_server::planner::detail;
+namespace impl     = ai_server::planner::impl;
+using ai_server::planner::human_like;
+using ai_server::planner::obstacle_list;
+using box_type     = boost::geometry::model::box<Eigen::Vector2d>;
+using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
+
+namespace {
+
+// ロボット, 壁, ペナルティエリア (距離場) を含む障害物
+obstacle_list make_obstacles() {
+  obstacle_list obs;
+  obs.set_static(detail::distance_field::cached(
+      box_type{{-6000.0, -3000.0}, {-3000.0, 3000.0}}, 10.0,
+      {obstacle::box{{{-6000.0, -1800.0}, {-4200.0, 1800.0}}, 150.0}}));
+  obs.add(obstacle::point{{0.0, 0.0}, 300.0});
+  obs.add(obstacle::segment{{{1000.0, -1500.0}, {1000.0, 1500.0}}, 100.0});
+  obs.freeze();
+  // ロボット毎に追加される障害物
+  obs.add(obstacle::point{{-1000.0, 500.0}, 300.0});
+  obs.add(obstacle::box{{{2000.0, -500.0}, {2500.0, 500.0}}, 100.0});
+  return obs;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(planner_human_like)
+
+BOOST_AUTO_TEST_CASE(clipped_by_box) {
+  const box_type area{{-1000.0, -500.0}, {1000.0, 500.0}};
+  const std::vector<segment_type> lines{
+      {{-2000.0, 0.0}, {2000.0, 0.0}},      {{0.0, 0.0}, {500.0, 100.0}},
+      {{-1500.0, -1000.0}, {0.0, 100.0}},   {{300.0, 2000.0}, {300.0, -2000.0}},
+      {{-2000.0, 1000.0}, {2000.0, 1000.0}}, {{1500.0, 0.0}, {2000.0, 400.0}},
+  };
+
+  // boost::geometry::intersection による結果と同じになる
+  for (const auto& line : lines) {
+    const auto expected = detail::clipped(line, area);
+    const auto result   = detail::clipped_by_box(line, area);
+    BOOST_TEST_REQUIRE(expected.empty() == !result);
+    if (result) {
+      BOOST_TEST((expected.front().first - result->first).norm() < 1e-9);
+      BOOST_TEST((expected.front().second - result->second).norm() < 1e-9);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(same_as_lists) {
+  const auto obs = make_obstacles();
+  const box_type area{{-6000.0, -4500.0}, {6000.0, 4500.0}};
+
+  human_like hl{};
+  hl.set_min_pos(area.min_corner());
+  hl.set_max_pos(area.max_corner());
+  const auto plan = hl.planner();
+
+  const std::vector<std::pair<Eigen::Vector2d, Eigen::Vector2d>> queries{
+      {{-2000.0, 0.0}, {3000.0, 0.0}},   // ロボットと壁を避ける
+      {{-500.0, 450.0}, {-1500.0, 0.0}}, // ゴールが近い
+      {{100.0, 0.0}, {3000.0, 1000.0}},  // 障害物の中から脱出する
+      {{-5000.0, 0.0}, {0.0, 2000.0}},   // ペナルティエリアの中から脱出する
+      {{0.0, 3000.0}, {0.0, 3050.0}},    // min_length_ よりゴールが近い
+  };
+
+  for (const auto& [start, goal] : queries) {
+    // 毎回リストを作って探索した結果と一致する
+    const Eigen::Vector2d sg = goal - start;
+    const double l_max       = std::min(4000.0, sg.norm());
+    const double l_min       = std::min(100.0, l_max);
+    detail::obstacle_arrays arrays{};
+    arrays.add(obs.index(), detail::to_envelope(start, std::max(l_max, 3000.0)));
+
+    const auto dirs    = impl::make_directions(sg.normalized(), 16);
+    const auto lengths = impl::make_length_list(l_min, l_max, 100.0);
+    auto expected      = impl::planned_position(start, dirs, lengths, arrays, area);
+    if (!expected) {
+      const auto exit_lengths = impl::make_length_list(l_min, 3000.0, 100.0);
+      expected = impl::exit_position(start, dirs, exit_lengths, arrays, area);
+    }
+    BOOST_TEST_REQUIRE(expected.has_value());
+
+    const auto [p, l] = plan(start, goal, obs);
+    BOOST_TEST(p.x() == expected->x());
+    BOOST_TEST(p.y() == expected->y());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(zero_allocation) {
+  const auto obs = make_obstacles();
+
+  human_like hl{};
+  hl.set_min_pos({-6000.0, -4500.0});
+  hl.set_max_pos({6000.0, 4500.0});
+  const auto plan = hl.planner();
+
+  const std::vector<std::pair<Eigen::Vector2d, Eigen::Vector2d>> queries{
+      {{-2000.0, 0.0}, {3000.0, 0.0}},
+      {{100.0, 0.0}, {3000.0, 1000.0}},
+      {{-5000.0, 0.0}, {0.0, 2000.0}},
+  };
+
+  // 作業領域を確保させる
+  for (const auto& [start, goal] : queries) plan(start, goal, obs);
+
+  // 以降はメモリを確保しない
+  const auto before = allocation_count.load();
+  for (const auto& [start, goal] : queries) plan(start, goal, obs);
+  BOOST_TEST(allocation_count.load() - before == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <iterator>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace obstacle = ai_server::model::obstacle;
+namespace detail   = ai_server::planner::detail;
+using ai_server::planner::obstacle_list;
+
+BOOST_AUTO_TEST_SUITE(planner_obstacle_list)
+
+BOOST_AUTO_TEST_CASE(freeze) {
+  obstacle_list common;
+  common.add(obstacle::point{{0.0, 0.0}, 100.0});
+  common.add(obstacle::point{{1000.0, 0.0}, 100.0});
+  common.freeze();
+
+  // freeze()した障害物はbuffer()に残らない
+  BOOST_TEST(common.buffer().empty());
+  BOOST_TEST(common.size() == 2);
+
+  // コピーに追加した障害物はコピー元に影響しない
+  auto a = common;
+  a.add(obstacle::point{{0.0, 1000.0}, 100.0});
+  BOOST_TEST(a.buffer().size() == 1);
+  BOOST_TEST(a.size() == 3);
+  BOOST_TEST(common.size() == 2);
+
+  // to_tree()は全ての障害物を含む
+  BOOST_TEST(a.to_tree().size() == 3);
+
+  // 再度freeze()すると, これまでの障害物をまとめて共有する
+  a.freeze();
+  a.add(obstacle::point{{0.0, -1000.0}, 100.0});
+  BOOST_TEST(a.buffer().size() == 1);
+  BOOST_TEST(a.size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(index) {
+  obstacle_list common;
+  common.add(obstacle::point{{0.0, 0.0}, 100.0});
+  common.freeze();
+
+  auto list = common;
+  list.add(obstacle::point{{1000.0, 0.0}, 100.0});
+  const auto idx = list.index();
+
+  // 共有された障害物と追加された障害物の両方に対して当たり判定が行われる
+  BOOST_TEST(detail::is_collided(Eigen::Vector2d{0.0, 50.0}, idx));
+  BOOST_TEST(detail::is_collided(Eigen::Vector2d{1000.0, 50.0}, idx));
+  BOOST_TEST(!detail::is_collided(Eigen::Vector2d{500.0, 0.0}, idx));
+
+  // 共有された障害物の方が手前にあれば, そちらにぶつかる長さが返る
+  const std::vector<double> lengths{100.0, 200.0, 300.0, 400.0, 500.0,
+                                    600.0, 700.0, 800.0, 900.0, 1000.0};
+  const auto l1 = detail::find_collided_length(lengths.begin(), lengths.end(),
+                                               Eigen::Vector2d{-500.0, 0.0},
+                                               Eigen::Vector2d{1.0, 0.0}, idx);
+  BOOST_TEST(*l1 == 400.0);
+  const auto l2 = detail::find_collided_length(lengths.begin(), lengths.end(),
+                                               Eigen::Vector2d{500.0, 0.0},
+                                               Eigen::Vector2d{1.0, 0.0}, idx);
+  BOOST_TEST(*l2 == 400.0);
+
+  // 衝突している障害物を両方から抽出する
+  std::vector<obstacle_list::element_type> collisions;
+  detail::extract_collisions(idx, Eigen::Vector2d{0.0, 0.0}, std::back_inserter(collisions));
+  BOOST_TEST(collisions.size() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
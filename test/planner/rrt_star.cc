@@ -0,0 +1,177 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <cmath>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/model/field.h"
+#include "ai_server/model/obstacle/field.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/impl/rrt_star.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace obstacle = ai_server::model::obstacle;
+namespace detail   = ai_server::planner::detail;
+using ai_server::planner::obstacle_list;
+using ai_server::planner::impl::rrt_star;
+
+BOOST_AUTO_TEST_SUITE(planner_rrt_star)
+
+BOOST_AUTO_TEST_CASE(avoid_obstacle) {
+  obstacle_list obs;
+  obs.add(obstacle::point{{0.0, 0.0}, 500.0});
+
+  rrt_star rrt{};
+  rrt.set_min_pos({-4500.0, -3000.0});
+  rrt.set_max_pos({4500.0, 3000.0});
+  rrt.set_node_count(200);
+  rrt.set_seed(1);
+
+  const Eigen::Vector2d start{-2000.0, 0.0};
+  const Eigen::Vector2d goal{2000.0, 0.0};
+  const auto [p, l] = rrt.execute(start, goal, obs);
+
+  // 障害物を避けた位置が返る
+  const boost::geometry::model::segment<Eigen::Vector2d> line{start, p};
+  BOOST_TEST(!detail::is_collided(line, obs.to_tree()));
+  BOOST_TEST((p - start).norm() > 0.0);
+  BOOST_TEST(l >= (goal - start).norm());
+}
+
+BOOST_AUTO_TEST_CASE(reuse) {
+  obstacle_list obs;
+  obs.add(obstacle::point{{0.0, 0.0}, 500.0});
+
+  const Eigen::Vector2d start{-2000.0, 0.0};
+  const Eigen::Vector2d goal{2000.0, 0.0};
+
+  rrt_star a{};
+  a.set_node_count(300);
+  a.set_seed(42);
+  const auto r1 = a.execute(start, goal, obs);
+
+  // 同じインスタンスを使い回しても, 同じシードなら同じ結果になる
+  a.set_node_count(50);
+  a.execute(goal, start, obs);
+  a.set_node_count(300);
+  a.set_seed(42);
+  const auto r2 = a.execute(start, goal, obs);
+
+  BOOST_TEST(r1.first.x() == r2.first.x());
+  BOOST_TEST(r1.first.y() == r2.first.y());
+  BOOST_TEST(r1.second == r2.second);
+}
+
+BOOST_AUTO_TEST_CASE(deadline) {
+  using namespace std::chrono_literals;
+  using clock = std::chrono::steady_clock;
+
+  obstacle_list obs;
+  obs.add(obstacle::point{{0.0, 0.0}, 500.0});
+
+  const Eigen::Vector2d start{-2000.0, 0.0};
+  const Eigen::Vector2d goal{2000.0, 0.0};
+
+  rrt_star rrt{};
+  rrt.set_min_pos({-4500.0, -3000.0});
+  rrt.set_max_pos({4500.0, 3000.0});
+  rrt.set_seed(1);
+
+  // 打ち切る時刻まで探索を続ける
+  const auto begin = clock::now();
+  rrt.set_deadline(begin + 20ms);
+  const auto [p, l] = rrt.execute(start, goal, obs);
+  const auto end    = clock::now();
+  BOOST_TEST((end - begin >= 20ms));
+  BOOST_TEST((end - begin < 500ms));
+
+  const boost::geometry::model::segment<Eigen::Vector2d> line{start, p};
+  BOOST_TEST(!detail::is_collided(line, obs.to_tree()));
+  BOOST_TEST(l >= (goal - start).norm());
+
+  // 打ち切る時刻を過ぎてから始めても, node_count 回は探索して障害物を避ける
+  rrt.set_node_count(100);
+  rrt.set_deadline(begin);
+  const auto [p2, l2] = rrt.execute(start, goal, obs);
+  const boost::geometry::model::segment<Eigen::Vector2d> line2{start, p2};
+  BOOST_TEST((p2 - start).norm() > 0.0);
+  BOOST_TEST(!detail::is_collided(line2, obs.to_tree()));
+
+  // ノード数の上限に達したら時刻の前でも打ち切る
+  rrt.set_max_node_count(10);
+  const auto begin2 = clock::now();
+  rrt.set_deadline(begin2 + 10s);
+  rrt.execute(start, goal, obs);
+  BOOST_TEST((clock::now() - begin2 < 1s));
+}
+
+BOOST_AUTO_TEST_CASE(warm_start) {
+  obstacle_list obs1;
+  obs1.add(obstacle::point{{0.0, 0.0}, 500.0});
+
+  const Eigen::Vector2d goal{2000.0, 0.0};
+
+  rrt_star rrt{};
+  rrt.set_min_pos({-4500.0, -3000.0});
+  rrt.set_max_pos({4500.0, 3000.0});
+  rrt.set_node_count(300);
+  rrt.set_warm_start(true);
+  rrt.set_seed(1);
+  rrt.execute({-2000.0, 0.0}, goal, obs1);
+
+  // 前回の探索木の一部を塞ぐ障害物を追加し，少し進んだ位置から探索し直す
+  auto obs2 = obs1;
+  obs2.add(obstacle::point{{-800.0, 800.0}, 300.0});
+  obs2.add(obstacle::point{{-800.0, -800.0}, 300.0});
+  const Eigen::Vector2d start{-1800.0, 100.0};
+  for (auto i = 0; i < 5; ++i) {
+    rrt.set_node_count(50);
+    const auto [p, l] = rrt.execute(start, goal, obs2);
+
+    // 引き継いだ探索木から，新しい障害物に当たらない経路が選ばれる
+    const boost::geometry::model::segment<Eigen::Vector2d> line{start, p};
+    BOOST_TEST(!detail::is_collided(line, obs2.to_tree()));
+    BOOST_TEST(l >= (goal - start).norm());
+  }
+
+  // 大きく離れた位置に移っても探索できる
+  rrt.set_node_count(300);
+  const auto [p, l] = rrt.execute({3000.0, 2000.0}, goal, obs2);
+  BOOST_TEST(!detail::is_collided(p, obs2.to_tree()));
+}
+
+BOOST_AUTO_TEST_CASE(exit_penalty_area) {
+  ai_server::model::field field{};
+  field.set_length(12000);
+  field.set_width(9000);
+  field.set_penalty_length(1800);
+  field.set_penalty_width(3600);
+
+  obstacle_list obs;
+  obs.set_static(obstacle::penalty_areas(field, 150.0));
+  const auto& penalty = *obs.static_field();
+
+  rrt_star rrt{};
+  rrt.set_min_pos({field.x_min(), field.y_min()});
+  rrt.set_max_pos({field.x_max(), field.y_max()});
+  rrt.set_node_count(100);
+  rrt.set_seed(1);
+
+  // ペナルティエリアの奥から，返された位置へ進むことを繰り返すと外に出られる
+  Eigen::Vector2d p{field.x_min() + 300.0, 500.0};
+  const Eigen::Vector2d goal{0.0, 0.0};
+  BOOST_TEST(penalty.is_collided(p));
+  for (int i = 0; i < 50 && penalty.is_collided(p); ++i) {
+    const auto next = rrt.execute(p, goal, obs).first;
+    // フィールドの中を進む
+    BOOST_TEST(next.x() >= field.x_min());
+    BOOST_TEST(std::abs(next.y()) <= field.y_max());
+    BOOST_TEST((next - p).norm() > 0.0);
+    p = next;
+  }
+  BOOST_TEST(!penalty.is_collided(p));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
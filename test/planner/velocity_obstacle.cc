@@ -0,0 +1,222 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <cstddef>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/moving_point.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/planner/base.h"
+#include "ai_server/planner/detail/ray_intersection.h"
+#include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/velocity_obstacle.h"
+
+namespace obstacle = ai_server::model::obstacle;
+namespace detail   = ai_server::planner::detail;
+namespace impl     = ai_server::planner::impl;
+using ai_server::planner::obstacle_list;
+using ai_server::planner::velocity_obstacle;
+
+BOOST_AUTO_TEST_SUITE(planner_velocity_obstacle)
+
+BOOST_AUTO_TEST_CASE(time_to_collision) {
+  // 正面から近づく
+  const auto t1 = impl::time_to_collision({0.0, 0.0}, {100.0, 0.0}, {1000.0, 0.0},
+                                          {-900.0, 0.0}, 200.0, 1.0);
+  BOOST_TEST(t1 == 0.8, boost::test_tools::tolerance(1e-9));
+
+  // 区間内では当たらない
+  const auto t2 = impl::time_to_collision({0.0, 0.0}, {100.0, 0.0}, {1000.0, 0.0},
+                                          {-100.0, 0.0}, 200.0, 1.0);
+  BOOST_TEST(t2 == detail::no_intersection);
+
+  // 並走している
+  const auto t3 = impl::time_to_collision({0.0, 0.0}, {100.0, 0.0}, {0.0, 500.0},
+                                          {100.0, 0.0}, 200.0, 1.0);
+  BOOST_TEST(t3 == detail::no_intersection);
+
+  // 初めから障害物の中にあるときは，近づく向きなら直ちに当たる
+  const auto t4 = impl::time_to_collision({0.0, 0.0}, {100.0, 0.0}, {100.0, 0.0},
+                                          {0.0, 100.0}, 200.0, 1.0);
+  BOOST_TEST(t4 == 0.0);
+
+  // 離れる向きなら当たらない
+  const auto t5 = impl::time_to_collision({0.0, 0.0}, {-100.0, 0.0}, {100.0, 0.0},
+                                          {0.0, 100.0}, 200.0, 1.0);
+  BOOST_TEST(t5 == detail::no_intersection);
+}
+
+BOOST_AUTO_TEST_CASE(constant_acceleration_state) {
+  const Eigen::Vector2d p0{0.0, 0.0};
+  const Eigen::Vector2d v0{0.0, 0.0};
+  const Eigen::Vector2d v1{1000.0, 0.0};
+
+  // 加速中
+  const auto [p1, u1] = impl::constant_acceleration_state(p0, v0, v1, 2000.0, 0.25);
+  BOOST_TEST(p1.x() == 62.5, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(u1.x() == 500.0, boost::test_tools::tolerance(1e-9));
+
+  // 目標速度に達した後
+  const auto [p2, u2] = impl::constant_acceleration_state(p0, v0, v1, 2000.0, 1.0);
+  BOOST_TEST(p2.x() == 750.0, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(u2.x() == 1000.0);
+
+  // 目標速度が初速度と同じ
+  const auto [p3, u3] = impl::constant_acceleration_state(p0, v1, v1, 2000.0, 0.5);
+  BOOST_TEST(p3.x() == 500.0);
+  BOOST_TEST(u3.x() == 1000.0);
+}
+
+BOOST_AUTO_TEST_CASE(no_obstacle) {
+  velocity_obstacle vo{};
+  const auto planner = vo.planner();
+
+  const Eigen::Vector2d start{0.0, 0.0};
+  const Eigen::Vector2d goal{3000.0, 0.0};
+  const auto [p, l] = planner(start, goal, obstacle_list{});
+
+  // 障害物が無ければ目標へ向かう
+  BOOST_TEST(p.x() == goal.x());
+  BOOST_TEST(p.y() == goal.y());
+  BOOST_TEST(l == 3000.0);
+
+  // 時刻付きの軌道は初期位置から始まり，目標の方向に進む
+  const auto& traj = vo.trajectory();
+  BOOST_TEST(!traj.empty());
+  BOOST_TEST(traj.front().time == 0.0);
+  BOOST_TEST(traj.front().position.norm() == 0.0);
+  BOOST_TEST(traj.back().position.x() > 0.0);
+  BOOST_TEST(traj.back().velocity.norm() <= 3000.0 + 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(moving_obstacle) {
+  const Eigen::Vector2d start{0.0, 0.0};
+  const Eigen::Vector2d goal{3000.0, 0.0};
+
+  // 直進したときに通過する時刻に，ちょうど経路を横切るロボット
+  const obstacle::moving_point enemy{{1500.0, -800.0}, {0.0, 1000.0}, 300.0};
+  obstacle_list obs;
+  obs.add_moving(enemy);
+
+  velocity_obstacle vo{};
+  const auto [p, l] = vo.planner()(start, goal, obs);
+
+  // 直進はしない
+  BOOST_TEST(!(p.x() == goal.x() && p.y() == goal.y()));
+
+  // 選んだ軌道は予測したロボットの位置に近づかない
+  for (const auto& s : vo.trajectory()) {
+    const Eigen::Vector2d q = enemy.geometry + enemy.velocity * s.time;
+    BOOST_TEST((s.position - q).norm() >= enemy.margin);
+  }
+
+  // 等速直線運動とみなした静止した障害物 (線分) と違い，通り過ぎた後は直進できる
+  obstacle_list passed;
+  passed.add_moving({{1500.0, 800.0}, {0.0, 1000.0}, 300.0});
+  velocity_obstacle vo2{};
+  const auto [p2, l2] = vo2.planner()(start, goal, passed);
+  BOOST_TEST(p2.x() == goal.x());
+  BOOST_TEST(p2.y() == goal.y());
+}
+
+BOOST_AUTO_TEST_CASE(start_inside_moving_obstacle) {
+  const Eigen::Vector2d start{0.0, 0.0};
+  const Eigen::Vector2d goal{3000.0, 0.0};
+
+  // 目標との間で margin より近くにいるロボット
+  const obstacle::moving_point enemy{{200.0, 0.0}, {0.0, 500.0}, 300.0};
+  obstacle_list obs;
+  obs.add_moving(enemy);
+
+  velocity_obstacle vo{};
+  const auto [p, l] = vo.planner()(start, goal, obs);
+
+  // ロボットを突き抜けて目標へは向かわない
+  BOOST_TEST(!(p.x() == goal.x() && p.y() == goal.y()));
+
+  // 選んだ軌道は予測したロボットの位置から離れていく
+  const auto& traj = vo.trajectory();
+  const auto distance = [&enemy](const auto& s) {
+    return (s.position - (enemy.geometry + enemy.velocity * s.time)).norm();
+  };
+  for (std::size_t i = 1; i < traj.size(); ++i) {
+    BOOST_TEST(distance(traj[i]) >= distance(traj[i - 1]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(static_obstacle) {
+  const Eigen::Vector2d start{0.0, 0.0};
+  const Eigen::Vector2d goal{3000.0, 0.0};
+
+  obstacle_list obs;
+  obs.add(obstacle::point{{1000.0, 0.0}, 300.0});
+
+  velocity_obstacle vo{};
+  vo.planner()(start, goal, obs);
+
+  // 選んだ軌道は障害物に入らない
+  for (const auto& s : vo.trajectory()) {
+    BOOST_TEST((s.position - Eigen::Vector2d{1000.0, 0.0}).norm() >= 300.0);
+  }
+
+  // 前回選んだ速度を初速度として続けて計画できる
+  vo.set_current_velocity({0.0, 0.0});
+  const auto [p, l] = vo.planner()(start, goal, obs);
+  BOOST_TEST(l >= 3000.0);
+}
+
+BOOST_AUTO_TEST_CASE(beyond_horizon) {
+  const Eigen::Vector2d start{0.0, 0.0};
+  const Eigen::Vector2d goal{8000.0, 0.0};
+
+  // 予測する時間内には届かない位置で，目標までの直線を塞ぐ障害物
+  obstacle_list obs;
+  obs.add(obstacle::point{{6000.0, 0.0}, 300.0});
+
+  // 目標を直接返さず，軌道の終点を返す
+  velocity_obstacle vo{};
+  const auto [p, l] = vo.planner()(start, goal, obs);
+  BOOST_TEST(!(p.x() == goal.x() && p.y() == goal.y()));
+  BOOST_TEST(p.x() == vo.trajectory().back().position.x());
+  BOOST_TEST(p.y() == vo.trajectory().back().position.y());
+}
+
+BOOST_AUTO_TEST_CASE(velocity_at) {
+  const Eigen::Vector2d start{0.0, 0.0};
+  const Eigen::Vector2d goal{3000.0, 0.0};
+
+  // 目標へ直進できるときは速度を出力しない
+  velocity_obstacle direct{};
+  direct.planner()(start, goal, obstacle_list{});
+  BOOST_TEST(!direct.velocity_at(0.1).has_value());
+
+  // 経路を横切るロボットを避けるときは, 軌道に沿った速度を出力する
+  obstacle_list obs;
+  obs.add_moving({{1500.0, -800.0}, {0.0, 1000.0}, 300.0});
+
+  // planner::base を通して計測した速度を渡すと, 軌道はその速度から始まる
+  auto vo = std::make_unique<velocity_obstacle>();
+  static_cast<ai_server::planner::base&>(*vo).set_current_velocity({1000.0, 0.0});
+  vo->planner()(start, goal, obs);
+  const auto& traj = vo->trajectory();
+  BOOST_TEST(traj.front().velocity.x() == 1000.0);
+  BOOST_TEST(traj.front().velocity.y() == 0.0);
+
+  const auto v0 = vo->velocity_at(0.0);
+  BOOST_TEST(v0.has_value());
+  BOOST_TEST(v0->x() == 1000.0);
+
+  // 軌道の点の間は線形補間し, 終わりより後は最後の速度
+  const auto& a  = traj[1];
+  const auto& b  = traj[2];
+  const auto mid = vo->velocity_at(0.5 * (a.time + b.time));
+  BOOST_TEST(mid->x() == 0.5 * (a.velocity.x() + b.velocity.x()),
+             boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(mid->y() == 0.5 * (a.velocity.y() + b.velocity.y()),
+             boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(vo->velocity_at(100.0)->x() == traj.back().velocity.x());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -76,4 +76,19 @@ BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
   BOOST_TEST(tx.messages_per_second() == 2);
 }
 
+BOOST_AUTO_TEST_CASE(send_too_large, *boost::unit_test::timeout(30)) {
+  boost::asio::io_context ctx{};
+
+  constexpr unsigned short port = 31339;
+
+  radio::connection::udp tx{ctx, {boost::asio::ip::udp::v4(), port}};
+  auto th = run_io_context_in_new_thread(ctx);
+
+  // max_message_size を超えるメッセージは送信されずに失敗として数えられる
+  tx.send(std::string(radio::connection::udp::max_message_size + 1, 'x'));
+
+  BOOST_TEST(tx.total_messages() == 0);
+  BOOST_TEST(tx.total_errors() == 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <boost/math/constants/constants.hpp>
 #include <boost/test/unit_test.hpp>
@@ -123,6 +124,48 @@ BOOST_AUTO_TEST_CASE(send_command) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(send_batch) {
+  auto c   = std::make_unique<mock_connection>();
+  auto& rc = *c;
+  radio::grsim g{std::move(c)};
+
+  // Driver は1周期分の命令を send_batch() でまとめて送る
+  BOOST_TEST(g.batched());
+
+  // 空のときは何も送らない
+  g.send_batch(model::team_color::yellow, {});
+  BOOST_TEST(!rc.last_value.has_value());
+
+  const std::vector<radio::base::robot_command> commands{
+      {1, {model::command::kick_type_t::none, 0}, 0, 1000, 0, 0},
+      {3, {model::command::kick_type_t::line, 10}, 1, 0, 2000, 0},
+      {5, {model::command::kick_type_t::none, 0}, 0, 0, 0, 3}};
+  g.send_batch(model::team_color::yellow, commands);
+  {
+    BOOST_TEST(rc.last_value.has_value());
+
+    ssl_protos::grsim::Packet p{};
+    BOOST_TEST(p.ParseFromString(rc.last_value.value()));
+
+    BOOST_TEST(p.has_commands());
+    BOOST_TEST(!p.has_replacement());
+
+    const auto& pc = p.commands();
+    BOOST_TEST(pc.isteamyellow());
+
+    // 全ロボットの命令が1つのパケットにまとめられている
+    const auto& pcc = pc.robot_commands();
+    BOOST_TEST(pcc.size() == 3);
+    BOOST_TEST(pcc[0].id() == 1);
+    BOOST_TEST(pcc[0].veltangent() == 1.0);
+    BOOST_TEST(pcc[1].id() == 3);
+    BOOST_TEST(pcc[1].velnormal() == 2.0);
+    BOOST_TEST(pcc[1].spinner());
+    BOOST_TEST(pcc[2].id() == 5);
+    BOOST_TEST(pcc[2].velangular() == 3.0);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(replacement_ball) {
   auto c   = std::make_unique<mock_connection>();
   auto& rc = *c;
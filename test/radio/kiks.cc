@@ -3,6 +3,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -89,4 +90,39 @@ BOOST_AUTO_TEST_CASE(send_command) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(send_batch) {
+  auto c   = std::make_unique<mock_connection>();
+  auto& rc = *c;
+  radio::kiks k{std::move(c)};
+
+  // Driver は1周期分の命令を send_batch() でまとめて送る
+  BOOST_TEST(k.batched());
+
+  // 空のときは何も送らない
+  k.send_batch(model::team_color::yellow, {});
+  BOOST_TEST(!rc.last_value.has_value());
+
+  const std::vector<radio::base::robot_command> commands{
+      {1, {model::command::kick_type_t::none, 0}, 2, 0, 0, 0},
+      {2, {model::command::kick_type_t::line, 3}, 2, 0, 0, 0}};
+  k.send_batch(model::team_color::yellow, commands);
+  {
+    BOOST_TEST(rc.last_value.has_value());
+
+    // 2台分のフレームが連結されている
+    const auto& v = rc.last_value.value();
+    BOOST_TEST(v.size() == 22);
+
+    BOOST_TEST(v[0] == 0b00000010);
+    BOOST_TEST(v[8] == 0);
+    BOOST_TEST(v[9] == '\r');
+    BOOST_TEST(v[10] == '\n');
+
+    BOOST_TEST(v[11] == 0b00110011);
+    BOOST_TEST(v[19] == 3);
+    BOOST_TEST(v[20] == '\r');
+    BOOST_TEST(v[21] == '\n');
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
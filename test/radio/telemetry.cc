@@ -0,0 +1,117 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/radio/telemetry.h"
+
+namespace model = ai_server::model;
+namespace radio = ai_server::radio;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(telemetry)
+
+// n 番目の命令 (各値から n が分かるようにしておく)
+radio::telemetry::entry make_entry(unsigned int id, int n) {
+  return {std::chrono::steady_clock::time_point{n * 1ms},
+          model::team_color::yellow,
+          id,
+          n % 256,
+          1.0 * n,
+          2.0 * n,
+          3.0 * n,
+          model::command::kick_type_t::chip,
+          4.0 * n,
+          n % 4};
+}
+
+BOOST_AUTO_TEST_CASE(push_and_drain) {
+  radio::telemetry t{};
+  BOOST_TEST(t.count(1) == 0u);
+  BOOST_TEST(!t.latest(1).has_value());
+
+  for (int i = 0; i < 3; ++i) t.push(make_entry(1, i));
+  BOOST_TEST(t.count(1) == 3u);
+  BOOST_TEST(t.count(2) == 0u);
+
+  std::uint64_t cursor = 0;
+  std::vector<radio::telemetry::entry> v{};
+  BOOST_TEST(t.drain(1, cursor, [&v](const auto& e) { v.push_back(e); }) == 0u);
+  BOOST_TEST(cursor == 3u);
+  BOOST_TEST(v.size() == 3u);
+  BOOST_TEST(v.at(2).time.time_since_epoch().count() ==
+             std::chrono::steady_clock::duration{2ms}.count());
+  BOOST_TEST((v.at(2).color == model::team_color::yellow));
+  BOOST_TEST(v.at(2).id == 1u);
+  BOOST_TEST(v.at(2).motion_id == 2);
+  BOOST_TEST(v.at(2).vx == 2.0);
+  BOOST_TEST(v.at(2).vy == 4.0);
+  BOOST_TEST(v.at(2).omega == 6.0);
+  BOOST_TEST((v.at(2).kick_type == model::command::kick_type_t::chip));
+  BOOST_TEST(v.at(2).kick_power == 8.0);
+  BOOST_TEST(v.at(2).dribble == 2);
+
+  // 新しく記録されたものだけを読み出す
+  v.clear();
+  t.push(make_entry(1, 3));
+  t.drain(1, cursor, [&v](const auto& e) { v.push_back(e); });
+  BOOST_TEST(v.size() == 1u);
+  BOOST_TEST(v.at(0).motion_id == 3);
+  BOOST_TEST(t.latest(1)->motion_id == 3);
+
+  // 範囲外の ID は無視する
+  t.push(make_entry(radio::telemetry::max_robots, 0));
+  BOOST_TEST(t.count(radio::telemetry::max_robots) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(overwrite) {
+  radio::telemetry t{};
+  constexpr int n = radio::telemetry::capacity + 10;
+  for (int i = 0; i < n; ++i) t.push(make_entry(0, i));
+
+  // 上書きされた古いものは読み飛ばす
+  std::uint64_t cursor = 0;
+  std::vector<int> v{};
+  BOOST_TEST(t.drain(0, cursor, [&v](const auto& e) { v.push_back(e.motion_id); }) == 10u);
+  BOOST_TEST(cursor == static_cast<std::uint64_t>(n));
+  BOOST_TEST(v.size() == radio::telemetry::capacity);
+  BOOST_TEST(v.front() == 10);
+  BOOST_TEST(v.back() == n - 1);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent) {
+  radio::telemetry t{};
+  constexpr int n = 200000;
+
+  std::thread writer{[&t] {
+    for (int i = 0; i < n; ++i) t.push(make_entry(5, i));
+  }};
+
+  // 書き込みと同時に読み出しても, 読み出せた命令は壊れておらず, 順序も保たれる
+  std::uint64_t cursor = 0;
+  std::uint64_t read   = 0;
+  std::uint64_t broken = 0;
+  double last          = -1.0;
+  const auto check     = [&](const auto& e) {
+    ++read;
+    if (e.vy != 2.0 * e.vx || e.omega != 3.0 * e.vx || e.kick_power != 4.0 * e.vx ||
+        e.vx <= last) {
+      ++broken;
+    }
+    last = e.vx;
+  };
+  std::uint64_t skipped = 0;
+  while (cursor < static_cast<std::uint64_t>(n)) skipped += t.drain(5, cursor, check);
+  writer.join();
+
+  BOOST_TEST(broken == 0u);
+  BOOST_TEST(read + skipped == static_cast<std::uint64_t>(n));
+  BOOST_TEST(t.latest(5)->vx == n - 1.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,35 @@
+#ifndef AI_SERVER_TEST_TEST_HELPERS_ALLOCATION_COUNTER_H
+#define AI_SERVER_TEST_TEST_HELPERS_ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// グローバルな operator new / operator delete を置き換え, メモリ確保の回数を数える
+//
+// 置き換えはプログラム全体で1つしか定義できないので,
+// 1つの実行ファイルにつき1つの翻訳単位からだけ include する
+
+/// これまでにメモリを確保した回数
+inline std::atomic<std::uint64_t> allocation_count{0};
+
+// GCC が呼び出し元への展開などで new と std::malloc() / std::free() の対応を見通すと,
+// 確保と解放の組み合わせが合わないとして -Wmismatched-new-delete を出すため,
+// 手続き間の解析の対象から外す
+[[gnu::noipa]] void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (auto p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc{};
+}
+
+[[gnu::noipa]] void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+[[gnu::noipa]] void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+#endif // AI_SERVER_TEST_TEST_HELPERS_ALLOCATION_COUNTER_H
@@ -0,0 +1,93 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/trace/histogram.h"
+
+using ai_server::trace::histogram;
+
+BOOST_AUTO_TEST_SUITE(trace_histogram)
+
+BOOST_AUTO_TEST_CASE(buckets) {
+  // 128 未満の値はそのまま区別される
+  for (std::uint64_t v = 0; v < 128; ++v) {
+    BOOST_TEST(histogram::index_of(v) == v);
+    BOOST_TEST(histogram::lowest_equivalent(histogram::index_of(v)) == v);
+  }
+
+  // それより大きな値は同じ bucket にまとめられるが, 相対誤差は 1 / 64 以下
+  for (std::uint64_t v : {128u, 129u, 255u, 256u, 1000u, 12345u, 40000u, 1234567u}) {
+    const auto i    = histogram::index_of(v);
+    const auto low  = histogram::lowest_equivalent(i);
+    const auto high = histogram::highest_equivalent(i);
+    BOOST_TEST(low <= v);
+    BOOST_TEST(v <= high);
+    BOOST_TEST(static_cast<double>(high - low + 1) / low <= 1.0 / 64);
+  }
+
+  // bucket は隙間なく並ぶ
+  for (std::size_t i = 1; i < histogram::index_of(histogram::max_value); ++i) {
+    BOOST_TEST(histogram::lowest_equivalent(i) == histogram::highest_equivalent(i - 1) + 1);
+  }
+  BOOST_TEST(histogram::highest_equivalent(histogram::index_of(histogram::max_value)) ==
+             histogram::max_value);
+}
+
+BOOST_AUTO_TEST_CASE(statistics) {
+  histogram h{};
+  BOOST_TEST(h.count() == 0u);
+  BOOST_TEST(h.min() == 0u);
+  BOOST_TEST(h.max() == 0u);
+  BOOST_TEST(h.value_at_percentile(50.0) == 0u);
+
+  // 1 から 100 を1回ずつ
+  for (std::uint64_t v = 1; v <= 100; ++v) h.record(v);
+  BOOST_TEST(h.count() == 100u);
+  BOOST_TEST(h.min() == 1u);
+  BOOST_TEST(h.max() == 100u);
+  BOOST_TEST(h.mean() == 50.5);
+  BOOST_TEST(h.value_at_percentile(0.0) == 1u);
+  BOOST_TEST(h.value_at_percentile(50.0) == 50u);
+  BOOST_TEST(h.value_at_percentile(99.0) == 99u);
+  BOOST_TEST(h.value_at_percentile(100.0) == 100u);
+
+  // 大きな値は bucket の上限で返すが, max() は超えない
+  h.record(10000, 100);
+  BOOST_TEST(h.count() == 200u);
+  BOOST_TEST(h.value_at_percentile(50.0) == 100u);
+  BOOST_TEST(h.value_at_percentile(75.0) == 10000u);
+  BOOST_TEST(h.max() == 10000u);
+
+  // 範囲を超える値は max_value として数える
+  h.record(histogram::max_value + 1000);
+  BOOST_TEST(h.max() == histogram::max_value);
+
+  h.reset();
+  BOOST_TEST(h.count() == 0u);
+  BOOST_TEST(h.max() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent) {
+  histogram h{};
+
+  // 複数のスレッドから同時に記録しても数え落とさない
+  constexpr int threads = 4;
+  constexpr int n       = 10000;
+  std::vector<std::thread> ts{};
+  for (int t = 0; t < threads; ++t) {
+    ts.emplace_back([&h, t] {
+      for (int i = 0; i < n; ++i) h.record(static_cast<std::uint64_t>(t * n + i));
+    });
+  }
+  for (auto& t : ts) t.join();
+
+  BOOST_TEST(h.count() == static_cast<std::uint64_t>(threads * n));
+  BOOST_TEST(h.min() == 0u);
+  BOOST_TEST(h.max() == static_cast<std::uint64_t>(threads * n - 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
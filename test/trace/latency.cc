@@ -0,0 +1,70 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/trace/latency.h"
+
+namespace trace = ai_server::trace;
+using stage     = trace::latency::stage;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(trace_latency)
+
+BOOST_AUTO_TEST_CASE(record_frame) {
+  trace::latency l{};
+
+  const std::chrono::system_clock::time_point t0{1000s};
+  trace::frame_timestamps t{};
+  t.frame         = 1;
+  t.captured      = t0;
+  t.received      = t0 + 20ms;
+  t.published     = t0 + 21ms;
+  t.game_started  = t0 + 23ms;
+  t.game_finished = t0 + 30ms;
+  l.record(t, t0 + 32ms);
+
+  BOOST_TEST(l.summarize(stage::vision).p50.count() == 20000);
+  BOOST_TEST(l.summarize(stage::update).p50.count() == 1000);
+  BOOST_TEST(l.summarize(stage::queue).p50.count() == 2000);
+  BOOST_TEST(l.summarize(stage::game).p50.count() == 7000);
+  BOOST_TEST(l.summarize(stage::driver).p50.count() == 2000);
+  BOOST_TEST(l.summarize(stage::total).max.count() == 32000);
+  for (const auto& s : l.summarize()) BOOST_TEST(s.count == 1u);
+
+  // 無効なフレームは記録しない
+  t.frame = 0;
+  l.record(t, t0 + 32ms);
+  BOOST_TEST(l.summarize(stage::total).count == 1u);
+
+  // 前後が入れ替わったときは 0 とする
+  l.record(stage::vision, -5ms);
+  BOOST_TEST(l.summarize(stage::vision).min.count() == 0);
+
+  l.reset();
+  BOOST_TEST(l.summarize(stage::total).count == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(write_csv) {
+  trace::latency l{};
+  l.record(stage::total, 40ms);
+
+  std::ostringstream os{};
+  l.write_csv(os);
+
+  std::istringstream is{os.str()};
+  std::string line{};
+  std::getline(is, line);
+  BOOST_TEST(line == "stage,count,min_us,mean_us,p50_us,p90_us,p99_us,p99.9_us,max_us");
+  for (const auto n : {"vision", "update", "queue", "game", "driver"}) {
+    std::getline(is, line);
+    BOOST_TEST(line == std::string{n} + ",0,0,0,0,0,0,0,0");
+  }
+  std::getline(is, line);
+  BOOST_TEST(line == "total,1,40000,40000,40000,40000,40000,40000,40000");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
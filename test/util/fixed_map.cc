@@ -0,0 +1,137 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/util/fixed_map.h"
+
+using namespace ai_server;
+
+BOOST_AUTO_TEST_SUITE(fixed_map)
+
+BOOST_AUTO_TEST_CASE(insert_and_find) {
+  util::fixed_map<std::string, 16> m{};
+
+  BOOST_TEST(m.empty());
+  BOOST_TEST(m.size() == 0);
+  BOOST_TEST(m.capacity() == 16);
+  BOOST_TEST((m.begin() == m.end()));
+
+  // 要素を追加する
+  BOOST_TEST(m.emplace(3, "three").second);
+  BOOST_TEST(m.insert({7, "seven"}).second);
+  m[0] = "zero";
+  BOOST_TEST(!m.empty());
+  BOOST_TEST(m.size() == 3);
+
+  // 既に存在する Key には追加されない
+  BOOST_TEST(!m.emplace(3, "san").second);
+  BOOST_TEST(m.at(3) == "three");
+
+  // insert_or_assign は上書きする
+  BOOST_TEST(!m.insert_or_assign(3, "san").second);
+  BOOST_TEST(m.at(3) == "san");
+
+  BOOST_TEST(m.count(0) == 1);
+  BOOST_TEST(m.count(1) == 0);
+  BOOST_TEST(m.count(100) == 0);
+  BOOST_TEST((m.find(1) == m.end()));
+  BOOST_TEST((m.find(100) == m.end()));
+
+  const auto it = m.find(7);
+  BOOST_TEST((it != m.end()));
+  BOOST_TEST(it->first == 7);
+  BOOST_TEST(it->second == "seven");
+
+  // 存在しない Key や範囲外の Key
+  BOOST_CHECK_THROW(m.at(1), std::out_of_range);
+  BOOST_CHECK_THROW(m.at(16), std::out_of_range);
+  BOOST_CHECK_THROW(m[16], std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(iteration) {
+  const util::fixed_map<int, 16> m{{15, 150}, {2, 20}, {9, 90}, {0, 0}};
+
+  // Key の昇順に走査される
+  std::vector<unsigned int> keys{};
+  std::vector<int> values{};
+  for (const auto& [k, v] : m) {
+    keys.push_back(k);
+    values.push_back(v);
+  }
+  BOOST_TEST(keys == (std::vector<unsigned int>{0, 2, 9, 15}),
+             boost::test_tools::per_element());
+  BOOST_TEST(values == (std::vector<int>{0, 20, 90, 150}), boost::test_tools::per_element());
+
+  BOOST_TEST(std::distance(m.cbegin(), m.cend()) == 4);
+}
+
+BOOST_AUTO_TEST_CASE(erase) {
+  util::fixed_map<int, 16> m{{1, 10}, {2, 20}, {3, 30}, {4, 40}};
+
+  BOOST_TEST(m.erase(2) == 1);
+  BOOST_TEST(m.erase(2) == 0);
+  BOOST_TEST(m.erase(100) == 0);
+  BOOST_TEST(m.size() == 3);
+
+  // 走査しながら削除する
+  for (auto it = m.begin(); it != m.end();) {
+    if (it->first == 3) {
+      it = m.erase(it);
+      BOOST_TEST(it->first == 4);
+    } else {
+      ++it;
+    }
+  }
+  BOOST_TEST(m.size() == 2);
+  BOOST_TEST(m.count(1) == 1);
+  BOOST_TEST(m.count(3) == 0);
+  BOOST_TEST(m.count(4) == 1);
+
+  m.clear();
+  BOOST_TEST(m.empty());
+  BOOST_TEST((m.begin() == m.end()));
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_move) {
+  util::fixed_map<std::shared_ptr<int>, 8> m1{};
+  m1.emplace(1, std::make_shared<int>(1));
+  m1.emplace(5, std::make_shared<int>(5));
+
+  // コピーすると要素もコピーされる
+  auto m2 = m1;
+  BOOST_TEST(m2.size() == 2);
+  BOOST_TEST(*m2.at(5) == 5);
+  BOOST_TEST(m1.at(5).use_count() == 2);
+
+  // 代入すると以前の要素は破棄される
+  util::fixed_map<std::shared_ptr<int>, 8> m3{};
+  m3.emplace(0, std::make_shared<int>(0));
+  m3 = m1;
+  BOOST_TEST(m3.size() == 2);
+  BOOST_TEST(m3.count(0) == 0);
+  BOOST_TEST(m1.at(1).use_count() == 3);
+
+  // ムーブ代入
+  m3 = std::move(m2);
+  BOOST_TEST(m3.size() == 2);
+  BOOST_TEST(m1.at(1).use_count() == 2);
+
+  // fixed_map 自体はヒープを使わないが, コピーでヒープを使うかは要素の型による
+  // (std::function を持つ model::robot などは要素のコピーで確保し得る).
+  // 要素がトリビアルにコピーできる型なら, fixed_map のコピーの構築もトリビアルになる
+  struct pod {
+    int a;
+    double b;
+  };
+  static_assert(std::is_trivially_copyable_v<pod>);
+  static_assert(std::is_trivially_copy_constructible_v<util::fixed_map<pod, 16>>);
+  static_assert(std::is_trivially_destructible_v<util::fixed_map<pod, 16>>);
+  static_assert(std::is_copy_assignable_v<util::fixed_map<pod, 16>>);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -285,4 +285,54 @@ BOOST_AUTO_TEST_CASE(messages_per_second, *boost::unit_test::timeout(30)) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(burst, *boost::unit_test::timeout(30)) {
+  boost::asio::io_context ctx{};
+
+  // 受信クラスの初期化
+  // listen_addr = 0.0.0.0, multicast_addr = 224.5.23.2, port = 10004
+  receiver r{ctx, "0.0.0.0", "224.5.23.2", 10004};
+
+  // 送信クラスの初期化
+  // multicast_addr = 224.5.23.2, port = 10004
+  sender s{ctx, "224.5.23.2", 10004};
+
+  // batch_size より多いメッセージをまとめて受信させる
+  constexpr auto count = receiver::batch_size * 3 + 1;
+
+  std::vector<std::tuple<std::string, std::uint64_t, std::chrono::system_clock::time_point>>
+      results{};
+  std::promise<void> promise{};
+  r.on_receive([&](auto& buf, auto size, auto total, auto time) {
+    results.emplace_back(std::string(buf.cbegin(), buf.cbegin() + size), total, time);
+    if (results.size() == count) promise.set_value();
+  });
+
+  boost::system::error_code error{};
+  r.on_error([&error](auto& e) { error = e; });
+
+  // 受信の準備だけ行い, 受信処理を始める前に全てのメッセージを送信する
+  ctx.poll();
+  const auto before = std::chrono::system_clock::now();
+  for (auto i = 0u; i < count; ++i) s.send(std::to_string(i));
+  ctx.poll();
+  const auto after = std::chrono::system_clock::now();
+
+  // 受信を開始する
+  auto t = run_io_context_in_new_thread(ctx);
+  promise.get_future().get();
+
+  BOOST_TEST(!error);
+
+  for (auto i = 0u; i < count; ++i) {
+    const auto& [data, total, time] = results[i];
+
+    // 送信した順に受信できているか
+    BOOST_TEST(data == std::to_string(i));
+    BOOST_TEST(total == i + 1);
+
+    // 受信した時刻は受信処理を行った時刻ではなく, 送信した頃の時刻になっているか
+    BOOST_TEST((before <= time && time <= after));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
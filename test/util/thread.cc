@@ -0,0 +1,59 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/util/thread.h"
+
+namespace util = ai_server::util;
+
+BOOST_AUTO_TEST_SUITE(thread)
+
+// 終了を指示されるまで待つスレッド
+struct waiting_thread {
+  std::atomic<bool> stop{false};
+  std::thread t{[this] {
+    while (!stop) std::this_thread::yield();
+  }};
+
+  ~waiting_thread() {
+    stop = true;
+    t.join();
+  }
+};
+
+BOOST_AUTO_TEST_CASE(affinity) {
+  waiting_thread w{};
+
+  // 制限しないときは常に成功する
+  BOOST_TEST(util::set_thread_affinity(w.t, {}));
+
+  // 存在しない CPU の番号は失敗する
+  BOOST_TEST(!util::set_thread_affinity(w.t, {-1}));
+
+#ifdef __linux__
+  // 現在のスレッドが動いている CPU には制限できる
+  BOOST_TEST(util::set_thread_affinity(w.t, {::sched_getcpu()}));
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(priority) {
+  waiting_thread w{};
+
+  // 通常のスケジューリングには権限なしで戻せる
+#ifdef __linux__
+  BOOST_TEST(util::set_thread_priority(w.t, 0));
+#endif
+
+  // SCHED_FIFO は CAP_SYS_NICE が必要なので, 成否によらず呼び出せることだけ確認する
+  // 成功した場合に空回りするスレッドが優先されたまま残らないよう, 直ちに元に戻す
+  util::set_thread_priority(w.t, 1);
+#ifdef __linux__
+  BOOST_TEST(util::set_thread_priority(w.t, 0));
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
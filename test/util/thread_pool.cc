@@ -0,0 +1,66 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/util/thread_pool.h"
+
+using namespace std::chrono_literals;
+
+namespace util = ai_server::util;
+
+BOOST_AUTO_TEST_SUITE(thread_pool)
+
+BOOST_AUTO_TEST_CASE(parallel_for) {
+  for (auto threads : {0u, 1u, 4u}) {
+    util::thread_pool pool{threads};
+    BOOST_TEST(pool.size() == threads);
+
+    // 全ての番号が1回ずつ実行される
+    for (auto n : {0u, 1u, 3u, 100u}) {
+      std::vector<std::atomic<int>> counts(n);
+      pool.parallel_for(n, [&counts](std::size_t i) { ++counts[i]; });
+      for (const auto& c : counts) BOOST_TEST(c == 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(concurrency) {
+  util::thread_pool pool{3};
+
+  // 4つの処理が同時に実行される (呼び出し元のスレッドも含む)
+  std::atomic<int> waiting{0};
+  std::atomic<bool> all_started{false};
+  pool.parallel_for(4, [&](std::size_t) {
+    if (++waiting == 4) all_started = true;
+    const auto deadline = std::chrono::steady_clock::now() + 1s;
+    while (!all_started && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+  });
+  BOOST_TEST(all_started);
+}
+
+BOOST_AUTO_TEST_CASE(exception) {
+  util::thread_pool pool{2};
+
+  // 例外が投げられても残りの処理は実行され, 呼び出し元で再送出される
+  std::atomic<int> count{0};
+  BOOST_CHECK_THROW(pool.parallel_for(10,
+                                      [&count](std::size_t i) {
+                                        ++count;
+                                        if (i == 3) throw std::runtime_error{"error"};
+                                      }),
+                    std::runtime_error);
+  BOOST_TEST(count == 10);
+
+  // 例外が投げられた後も使える
+  pool.parallel_for(10, [&count](std::size_t) { ++count; });
+  BOOST_TEST(count == 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()